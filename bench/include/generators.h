@@ -0,0 +1,137 @@
+#ifndef BENCH_GENERATORS_H
+#define BENCH_GENERATORS_H
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <ublox_messages.h>
+#include <ublox_structs.h>
+
+/**
+ * input generators for the benchmark suite
+ * all generators use a fixed seed so that the results are comparable between runs
+ */
+namespace MuonPi::Bench {
+
+constexpr std::uint32_t default_seed { 42 };
+
+template <typename T>
+void put(std::string& buffer, T value)
+{
+    for (std::size_t i = 0; i < sizeof(T); i++) {
+        buffer += static_cast<char>((value >> (8 * i)) & 0xff);
+    }
+}
+
+/**
+ * @brief exponentially distributed event intervals as seen from the detector (in ns)
+ */
+inline auto eventIntervals(std::size_t n, double rate_hz, std::uint32_t seed = default_seed) -> std::vector<std::uint64_t>
+{
+    std::mt19937 gen { seed };
+    std::exponential_distribution<double> dist { rate_hz };
+    std::vector<std::uint64_t> intervals(n);
+    for (auto& interval : intervals) {
+        interval = static_cast<std::uint64_t>(dist(gen) * 1.0e9);
+    }
+    return intervals;
+}
+
+/**
+ * @brief normally distributed values, e.g. ADC amplitudes or time differences
+ */
+inline auto gaussianValues(std::size_t n, double mean, double sigma, std::uint32_t seed = default_seed) -> std::vector<double>
+{
+    std::mt19937 gen { seed };
+    std::normal_distribution<double> dist { mean, sigma };
+    std::vector<double> values(n);
+    for (auto& value : values) {
+        value = dist(gen);
+    }
+    return values;
+}
+
+struct GeoSample {
+    double lat;
+    double lon;
+    double alt;
+    double accuracy;
+};
+
+/**
+ * @brief scattered position fixes around a station location as delivered by NAV-POSLLH
+ */
+inline auto positionFixes(std::size_t n, std::uint32_t seed = default_seed) -> std::vector<GeoSample>
+{
+    std::mt19937 gen { seed };
+    std::normal_distribution<double> dist_deg { 0., 2.0e-5 };
+    std::normal_distribution<double> dist_alt { 0., 5. };
+    std::uniform_real_distribution<double> dist_acc { 2., 25. };
+    std::vector<GeoSample> fixes(n);
+    for (auto& fix : fixes) {
+        fix = { 50.5873 + dist_deg(gen), 8.6755 + dist_deg(gen), 180. + dist_alt(gen), dist_acc(gen) };
+    }
+    return fixes;
+}
+
+/**
+ * @brief complete TIM-TM2 frame for the event with the given counter and rising edge time
+ */
+inline auto timTm2Frame(std::uint16_t counter, std::uint16_t week, std::uint64_t tow_ns) -> std::string
+{
+    const std::uint32_t tow_ms { static_cast<std::uint32_t>(tow_ns / 1000000UL) };
+    const std::uint32_t tow_sub_ms { static_cast<std::uint32_t>(tow_ns % 1000000UL) };
+    const std::uint64_t falling_ns { tow_ns + 250 };
+    std::string payload {};
+    put<std::uint8_t>(payload, 0); // channel
+    put<std::uint8_t>(payload, 0xF6); // flags: new rising and falling edge, running, utc time base, utc available, time valid
+    put<std::uint16_t>(payload, counter);
+    put<std::uint16_t>(payload, week);
+    put<std::uint16_t>(payload, week);
+    put<std::uint32_t>(payload, tow_ms);
+    put<std::uint32_t>(payload, tow_sub_ms);
+    put<std::uint32_t>(payload, static_cast<std::uint32_t>(falling_ns / 1000000UL));
+    put<std::uint32_t>(payload, static_cast<std::uint32_t>(falling_ns % 1000000UL));
+    put<std::uint32_t>(payload, 21); // accuracy estimate
+    return UbxMessage(UBX_MSG::TIM_TM2, payload).raw_message_string();
+}
+
+/**
+ * @brief complete NAV-CLOCK frame
+ */
+inline auto navClockFrame(std::uint32_t itow, std::int32_t bias, std::int32_t drift) -> std::string
+{
+    std::string payload {};
+    put<std::uint32_t>(payload, itow);
+    put<std::uint32_t>(payload, static_cast<std::uint32_t>(bias));
+    put<std::uint32_t>(payload, static_cast<std::uint32_t>(drift));
+    put<std::uint32_t>(payload, 15); // time accuracy
+    put<std::uint32_t>(payload, 320); // frequency accuracy
+    return UbxMessage(UBX_MSG::NAV_CLOCK, payload).raw_message_string();
+}
+
+/**
+ * @brief a realistic receiver output stream: one NAV-CLOCK per second and TIM-TM2 frames for the events in between
+ */
+inline auto ubxStream(std::size_t n_events, double rate_hz, std::uint32_t seed = default_seed) -> std::string
+{
+    std::string stream {};
+    std::uint64_t tow_ns { 345600ULL * 1000000000ULL };
+    std::uint64_t next_second { tow_ns / 1000000000ULL + 1 };
+    std::uint16_t counter { 0 };
+    for (auto interval : eventIntervals(n_events, rate_hz, seed)) {
+        tow_ns += interval;
+        while (tow_ns / 1000000000ULL >= next_second) {
+            stream += navClockFrame(static_cast<std::uint32_t>(next_second * 1000), 812345, -87);
+            next_second++;
+        }
+        stream += timTm2Frame(counter++, 2150, tow_ns);
+    }
+    return stream;
+}
+
+} // namespace MuonPi::Bench
+
+#endif // BENCH_GENERATORS_H
@@ -0,0 +1,45 @@
+#include "generators.h"
+
+#include <benchmark/benchmark.h>
+#include <utility/geohash.h>
+#include <utility/kalman_gnss_filter.h>
+
+static void BM_GeoHashFromCoordinates(benchmark::State& state)
+{
+    const auto fixes { MuonPi::Bench::positionFixes(1024) };
+    const int precision { static_cast<int>(state.range(0)) };
+    std::size_t i { 0 };
+    for (auto _ : state) {
+        const auto& fix { fixes[i++ & 1023] };
+        benchmark::DoNotOptimize(GeoHash::hashFromCoordinates(fix.lon, fix.lat, precision));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GeoHashFromCoordinates)->Arg(6)->Arg(12);
+
+static void BM_KalmanGnssFilterProcess(benchmark::State& state)
+{
+    const auto fixes { MuonPi::Bench::positionFixes(1024) };
+    KalmanGnssFilter filter { 0.1 };
+    std::size_t i { 0 };
+    for (auto _ : state) {
+        const auto& fix { fixes[i++ & 1023] };
+        filter.process(fix.lat, fix.lon, fix.alt, fix.accuracy, 1.5 * fix.accuracy);
+        benchmark::DoNotOptimize(filter.get_latitude());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_KalmanGnssFilterProcess);
+
+static void BM_KalmanGnssFilterProcessClock(benchmark::State& state)
+{
+    KalmanGnssFilter filter { 0.1 };
+    double bias { 0. };
+    for (auto _ : state) {
+        bias += 1.;
+        filter.process_clock(bias, 1., 5., 0.1);
+        benchmark::DoNotOptimize(filter.time_correction());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_KalmanGnssFilterProcessClock);
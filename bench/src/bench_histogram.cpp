@@ -0,0 +1,44 @@
+#include "generators.h"
+
+#include <benchmark/benchmark.h>
+#include <histogram.h>
+
+static void BM_HistogramFill(benchmark::State& state)
+{
+    const auto values { MuonPi::Bench::gaussianValues(4096, 0.5, 0.1) };
+    Histogram histo { "bench", static_cast<int>(state.range(0)), 0., 1. };
+    std::size_t i { 0 };
+    for (auto _ : state) {
+        histo.fill(values[i++ & 4095]);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HistogramFill)->Arg(100)->Arg(1000)->Arg(10000);
+
+static void BM_HistogramFillAutoscale(benchmark::State& state)
+{
+    const auto values { MuonPi::Bench::gaussianValues(4096, 0.5, 0.5) };
+    Histogram histo { "bench", 1000, 0., 1., true };
+    std::size_t i { 0 };
+    for (auto _ : state) {
+        histo.fill(values[i++ & 4095]);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HistogramFillAutoscale);
+
+static void BM_HistogramStatistics(benchmark::State& state)
+{
+    const auto values { MuonPi::Bench::gaussianValues(100000, 0.5, 0.1) };
+    Histogram histo { "bench", static_cast<int>(state.range(0)), 0., 1. };
+    for (auto value : values) {
+        histo.fill(value);
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(histo.getMean());
+        benchmark::DoNotOptimize(histo.getMedian());
+        benchmark::DoNotOptimize(histo.getMpv());
+        benchmark::DoNotOptimize(histo.getRMS());
+    }
+}
+BENCHMARK(BM_HistogramStatistics)->Arg(100)->Arg(1000)->Arg(10000);
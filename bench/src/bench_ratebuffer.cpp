@@ -0,0 +1,73 @@
+#include "generators.h"
+
+#include <benchmark/benchmark.h>
+#include <utility/eventfilter.h>
+#include <utility/ratebuffer.h>
+
+static void BM_EventRateBufferOnEvent(benchmark::State& state)
+{
+    constexpr std::uint8_t gpio { 5 };
+    EventRateBuffer buffer { gpio };
+    for (auto _ : state) {
+        buffer.onEvent(gpio);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_EventRateBufferOnEvent);
+
+static void BM_EventRateBufferForeignGpio(benchmark::State& state)
+{
+    // every buffer receives the events of all gpio pins and has to reject the foreign ones
+    EventRateBuffer buffer { 5 };
+    for (auto _ : state) {
+        buffer.onEvent(6);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_EventRateBufferForeignGpio);
+
+static void BM_EventRateBufferAvgRate(benchmark::State& state)
+{
+    constexpr std::uint8_t gpio { 5 };
+    EventRateBuffer buffer { gpio };
+    for (int i = 0; i < state.range(0); i++) {
+        buffer.onEvent(gpio);
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(buffer.avgRate());
+    }
+}
+BENCHMARK(BM_EventRateBufferAvgRate)->Arg(100)->Arg(10000);
+
+static void BM_CounterRateBufferOnCounterValue(benchmark::State& state)
+{
+    CounterRateBuffer buffer {};
+    std::uint16_t counter { 0 };
+    for (auto _ : state) {
+        buffer.onCounterValue(counter++);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CounterRateBufferOnCounterValue);
+
+static void BM_EventFilterProcess(benchmark::State& state)
+{
+    // raw edges of a noisy station: the muon rate is superimposed with a high rate of noise pulses
+    constexpr unsigned int xor_gpio { 27 };
+    constexpr unsigned int and_gpio { 22 };
+    EventFilter::Config config {};
+    config.channels = { xor_gpio, and_gpio };
+    config.coincidences = { { and_gpio, xor_gpio } };
+    config.coincidence_window = std::chrono::microseconds { 2 };
+    EventFilter filter { config };
+    const auto intervals { MuonPi::Bench::eventIntervals(4096, static_cast<double>(state.range(0))) };
+    std::uint32_t tick { 0 };
+    std::size_t i { 0 };
+    for (auto _ : state) {
+        tick += static_cast<std::uint32_t>(intervals[i++ & 4095] / 1000);
+        benchmark::DoNotOptimize(filter.process(xor_gpio, tick));
+        benchmark::DoNotOptimize(filter.process(and_gpio, tick + 1));
+    }
+    state.SetItemsProcessed(2 * state.iterations());
+}
+BENCHMARK(BM_EventFilterProcess)->Arg(10)->Arg(10000);
@@ -0,0 +1,119 @@
+#include "generators.h"
+
+#include <QBuffer>
+#include <QtEndian>
+#include <benchmark/benchmark.h>
+#include <custom_io_operators.h>
+#include <histogram.h>
+#include <tcpconnection.h>
+#include <tcpmessage.h>
+#include <tcpmessage_keys.h>
+#include <ublox_structs.h>
+
+static void BM_TcpMessageSmall(benchmark::State& state)
+{
+    for (auto _ : state) {
+        TcpMessage message { TCP_MSG_KEY::MSG_ADC_SAMPLE };
+        *(message.dStream) << static_cast<quint8>(2) << 1.234F;
+        benchmark::DoNotOptimize(message.getData().data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TcpMessageSmall);
+
+static void BM_TcpMessageHistogram(benchmark::State& state)
+{
+    Histogram histo { "bench", static_cast<int>(state.range(0)), 0., 1. };
+    for (auto value : MuonPi::Bench::gaussianValues(100000, 0.5, 0.1)) {
+        histo.fill(value);
+    }
+    for (auto _ : state) {
+        TcpMessage message { TCP_MSG_KEY::MSG_HISTOGRAM };
+        *(message.dStream) << histo;
+        benchmark::DoNotOptimize(message.getData().data());
+        state.SetBytesProcessed(state.bytes_processed() + message.getData().size());
+    }
+}
+BENCHMARK(BM_TcpMessageHistogram)->Arg(100)->Arg(1000);
+
+static void BM_TcpMessageCopy(benchmark::State& state)
+{
+    TcpMessage message { TCP_MSG_KEY::MSG_GNSS_SATS };
+    for (int i = 0; i < state.range(0); i++) {
+        *(message.dStream) << static_cast<quint32>(i);
+    }
+    for (auto _ : state) {
+        TcpMessage copy { message };
+        benchmark::DoNotOptimize(copy.getData().data());
+    }
+}
+BENCHMARK(BM_TcpMessageCopy)->Arg(16)->Arg(1024);
+
+static void BM_TcpMessageDeserialize(benchmark::State& state)
+{
+    Histogram histo { "bench", 1000, 0., 1. };
+    for (auto value : MuonPi::Bench::gaussianValues(100000, 0.5, 0.1)) {
+        histo.fill(value);
+    }
+    TcpMessage message { TCP_MSG_KEY::MSG_HISTOGRAM };
+    *(message.dStream) << histo;
+    QByteArray raw { message.getData() };
+    for (auto _ : state) {
+        TcpMessage received { raw };
+        Histogram result {};
+        *(received.dStream) >> result;
+        benchmark::DoNotOptimize(result.getEntries());
+    }
+}
+BENCHMARK(BM_TcpMessageDeserialize);
+
+// a burst of event messages as it arrives in the socket buffer of the gui
+static auto eventBurst(int count) -> QByteArray
+{
+    QByteArray burst {};
+    UbxTimeMarkStruct tm {};
+    tm.risingValid = tm.fallingValid = true;
+    for (int i = 0; i < count; i++) {
+        tm.rising.tv_sec = 1600000000 + i;
+        tm.falling = tm.rising;
+        tm.evtCounter = static_cast<quint16>(i);
+        TcpMessage timemark { TCP_MSG_KEY::MSG_UBX_TIMEMARK };
+        *(timemark.dStream) << tm;
+        TcpMessage gpio { TCP_MSG_KEY::MSG_GPIO_EVENT };
+        *(gpio.dStream) << static_cast<quint32>(i);
+        for (const auto* message : { &timemark, &gpio }) {
+            QByteArray frame { message->getData() };
+            qToBigEndian<quint16>(static_cast<quint16>(frame.size() - static_cast<int>(sizeof(quint16))), frame.data());
+            burst.append(frame);
+        }
+    }
+    return burst;
+}
+
+static void BM_TcpConnectionReceiveBurst(benchmark::State& state)
+{
+    const QByteArray burst { eventBurst(static_cast<int>(state.range(0))) };
+    for (auto _ : state) {
+        QBuffer device {};
+        device.setData(burst);
+        device.open(QIODevice::ReadOnly);
+        QByteArray frame {};
+        while (TcpConnection::readFrame(&device, frame)) {
+            TcpMessage message { frame };
+            // the queued connection to the receiving thread copies the message
+            TcpMessage received { message };
+            if (received.getMsgID() == static_cast<quint16>(TCP_MSG_KEY::MSG_UBX_TIMEMARK)) {
+                UbxTimeMarkStruct tm {};
+                *(received.dStream) >> tm;
+                benchmark::DoNotOptimize(tm.evtCounter);
+            } else {
+                quint32 gpio { 0 };
+                *(received.dStream) >> gpio;
+                benchmark::DoNotOptimize(gpio);
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 2 * state.range(0));
+    state.SetBytesProcessed(state.iterations() * burst.size());
+}
+BENCHMARK(BM_TcpConnectionReceiveBurst)->Arg(1000)->Arg(10000);
@@ -0,0 +1,82 @@
+#include "generators.h"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <eventformatter.h>
+#include <qtserialublox.h>
+#include <utility/unixtime_from_gps.h>
+
+static void BM_UbxParseStream(benchmark::State& state)
+{
+    // the stream is fed in chunks as delivered by the serial port at 9600 baud (~64 bytes per read)
+    const std::string stream { MuonPi::Bench::ubxStream(static_cast<std::size_t>(state.range(0)), 10.) };
+    constexpr std::size_t chunk_size { 64 };
+    QtSerialUblox ublox { "", 5000, 9600, false, 0, false, false };
+    for (auto _ : state) {
+        for (std::size_t pos = 0; pos < stream.size(); pos += chunk_size) {
+            const auto n { std::min(chunk_size, stream.size() - pos) };
+            ublox.injectRawData(QByteArray(stream.data() + pos, static_cast<int>(n)));
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(stream.size()));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_UbxParseStream)->Arg(100)->Arg(1000);
+
+static void BM_UbxFrameChecksum(benchmark::State& state)
+{
+    const std::string frame { MuonPi::Bench::timTm2Frame(1, 2150, 345600ULL * 1000000000ULL) };
+    const std::string data { frame.substr(2, frame.size() - 4) };
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(UbxMessage::check_sum(data));
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(data.size()));
+}
+BENCHMARK(BM_UbxFrameChecksum);
+
+static void BM_EventFormat(benchmark::State& state)
+{
+    EventRecord record {};
+    record.rising = { 1690000000, 123456789 };
+    record.falling = { 1690000000, 123457039 };
+    record.accuracy_ns = 21;
+    record.valid = 1;
+    record.time_base = 2;
+    record.utc_available = 1;
+    EventFormatter formatter {};
+    for (auto _ : state) {
+        record.counter++;
+        benchmark::DoNotOptimize(formatter.format(record).data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_EventFormat);
+
+static void BM_UnixtimeFromGps(benchmark::State& state)
+{
+    // time stamps across a week rollover, as decoded from the TIM-TM2 edges
+    std::uint32_t towMs { 604790000 };
+    std::uint32_t week { 2150 };
+    for (auto _ : state) {
+        towMs += 1013;
+        if (towMs >= 604800000) {
+            towMs -= 604800000;
+            week++;
+        }
+        benchmark::DoNotOptimize(unixtime_from_gps(week, towMs / 1000, static_cast<std::int64_t>(towMs % 1000) * 1000000 + 123456));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_UnixtimeFromGps);
+
+static void BM_LeapSecondLookup(benchmark::State& state)
+{
+    const GpsTime::LeapSecondTable table {};
+    std::int64_t gpsSeconds { 0 };
+    for (auto _ : state) {
+        gpsSeconds += 86400 * 17;
+        benchmark::DoNotOptimize(table.offset(gpsSeconds));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LeapSecondLookup);
@@ -0,0 +1,77 @@
+set(MUONDETECTOR_BENCH_SRC_DIR "${CMAKE_CURRENT_SOURCE_DIR}/bench/src")
+set(MUONDETECTOR_BENCH_HEADER_DIR "${CMAKE_CURRENT_SOURCE_DIR}/bench/include")
+set(MUONDETECTOR_DAEMON_SRC_DIR "${CMAKE_CURRENT_SOURCE_DIR}/daemon/src")
+set(MUONDETECTOR_DAEMON_HEADER_DIR "${CMAKE_CURRENT_SOURCE_DIR}/daemon/include")
+
+find_package(benchmark REQUIRED)
+find_package(Qt5 COMPONENTS Network SerialPort REQUIRED)
+
+set(MUONDETECTOR_BENCH_SOURCE_FILES
+    "${MUONDETECTOR_BENCH_SRC_DIR}/bench_histogram.cpp"
+    "${MUONDETECTOR_BENCH_SRC_DIR}/bench_tcpmessage.cpp"
+    "${MUONDETECTOR_BENCH_SRC_DIR}/bench_ratebuffer.cpp"
+    "${MUONDETECTOR_BENCH_SRC_DIR}/bench_geo.cpp"
+    "${MUONDETECTOR_BENCH_SRC_DIR}/bench_ublox.cpp"
+    )
+
+set(MUONDETECTOR_BENCH_HEADER_FILES
+    "${MUONDETECTOR_BENCH_HEADER_DIR}/generators.h"
+    )
+
+# the daemon components under test, compiled without the hardware dependencies
+set(MUONDETECTOR_BENCH_DAEMON_SOURCE_FILES
+    "${MUONDETECTOR_DAEMON_SRC_DIR}/qtserialublox.cpp"
+    "${MUONDETECTOR_DAEMON_SRC_DIR}/qtserialublox_processmessages.cpp"
+    "${MUONDETECTOR_DAEMON_SRC_DIR}/utility/eventfilter.cpp"
+    "${MUONDETECTOR_DAEMON_SRC_DIR}/utility/geohash.cpp"
+    "${MUONDETECTOR_DAEMON_SRC_DIR}/utility/gpio_mapping.cpp"
+    "${MUONDETECTOR_DAEMON_SRC_DIR}/utility/inputrecorder.cpp"
+    "${MUONDETECTOR_DAEMON_SRC_DIR}/utility/kalman_gnss_filter.cpp"
+    "${MUONDETECTOR_DAEMON_SRC_DIR}/utility/latencytracer.cpp"
+    "${MUONDETECTOR_DAEMON_SRC_DIR}/utility/ratebuffer.cpp"
+    "${MUONDETECTOR_DAEMON_SRC_DIR}/utility/ubxvalconfig.cpp"
+    )
+
+set(MUONDETECTOR_BENCH_DAEMON_HEADER_FILES
+    "${MUONDETECTOR_DAEMON_HEADER_DIR}/qtserialublox.h"
+    "${MUONDETECTOR_DAEMON_HEADER_DIR}/utility/eventfilter.h"
+    "${MUONDETECTOR_DAEMON_HEADER_DIR}/utility/geohash.h"
+    "${MUONDETECTOR_DAEMON_HEADER_DIR}/utility/gpio_mapping.h"
+    "${MUONDETECTOR_DAEMON_HEADER_DIR}/utility/inputrecorder.h"
+    "${MUONDETECTOR_DAEMON_HEADER_DIR}/utility/kalman_gnss_filter.h"
+    "${MUONDETECTOR_DAEMON_HEADER_DIR}/utility/latencytracer.h"
+    "${MUONDETECTOR_DAEMON_HEADER_DIR}/utility/matrix.h"
+    "${MUONDETECTOR_DAEMON_HEADER_DIR}/utility/ratebuffer.h"
+    "${MUONDETECTOR_DAEMON_HEADER_DIR}/utility/ubxvalconfig.h"
+    "${MUONDETECTOR_DAEMON_HEADER_DIR}/utility/unixtime_from_gps.h"
+    )
+
+add_executable(muondetector-bench
+    ${MUONDETECTOR_BENCH_SOURCE_FILES}
+    ${MUONDETECTOR_BENCH_HEADER_FILES}
+    ${MUONDETECTOR_BENCH_DAEMON_SOURCE_FILES}
+    ${MUONDETECTOR_BENCH_DAEMON_HEADER_FILES}
+    )
+
+target_include_directories(muondetector-bench PUBLIC
+    $<BUILD_INTERFACE:${MUONDETECTOR_BENCH_HEADER_DIR}>
+    $<BUILD_INTERFACE:${MUONDETECTOR_DAEMON_HEADER_DIR}>
+    $<BUILD_INTERFACE:${LIBRARY_INCLUDE_DIR}>)
+
+target_link_libraries(muondetector-bench
+    Qt5::Network Qt5::SerialPort
+    benchmark::benchmark
+    benchmark::benchmark_main
+    muondetector-shared
+    pthread
+    )
+
+# run the suite and store the results as json, tagged with the commit hash for comparison across commits
+add_custom_target(bench-json
+    COMMAND mkdir -p "${CMAKE_CURRENT_BINARY_DIR}/output/bench"
+    COMMAND muondetector-bench
+        --benchmark_out_format=json
+        --benchmark_out="${CMAKE_CURRENT_BINARY_DIR}/output/bench/muondetector-bench-${PROJECT_VERSION_HASH}.json"
+    DEPENDS muondetector-bench
+    WORKING_DIRECTORY "${CMAKE_CURRENT_BINARY_DIR}"
+    )
@@ -59,6 +59,15 @@ set(MUONDETECTOR_DAEMON_SOURCE_FILES
     "${MUONDETECTOR_DAEMON_SRC_DIR}/utility/kalman_gnss_filter.cpp"
     "${MUONDETECTOR_DAEMON_SRC_DIR}/geoposmanager.cpp"
     "${MUONDETECTOR_DAEMON_SRC_DIR}/utility/ratebuffer.cpp"
+    "${MUONDETECTOR_DAEMON_SRC_DIR}/utility/inputrecorder.cpp"
+    "${MUONDETECTOR_DAEMON_SRC_DIR}/utility/latencytracer.cpp"
+    "${MUONDETECTOR_DAEMON_SRC_DIR}/utility/eventfilter.cpp"
+    "${MUONDETECTOR_DAEMON_SRC_DIR}/utility/streamingestimator.cpp"
+    "${MUONDETECTOR_DAEMON_SRC_DIR}/utility/timemarkcorrector.cpp"
+    "${MUONDETECTOR_DAEMON_SRC_DIR}/utility/eventanalyzer.cpp"
+    "${MUONDETECTOR_DAEMON_SRC_DIR}/utility/startuptimeline.cpp"
+    "${MUONDETECTOR_DAEMON_SRC_DIR}/utility/ubxvalconfig.cpp"
+    "${MUONDETECTOR_DAEMON_SRC_DIR}/utility/ubxratescheduler.cpp"
 
     "${MUONDETECTOR_I2C_SOURCE_FILES}"
     "${MUONDETECTOR_SPI_SOURCE_FILES}"
@@ -112,6 +121,16 @@ set(MUONDETECTOR_DAEMON_HEADER_FILES
     "${MUONDETECTOR_DAEMON_HEADER_DIR}/utility/kalman_gnss_filter.h"
     "${MUONDETECTOR_DAEMON_HEADER_DIR}/geoposmanager.h"
     "${MUONDETECTOR_DAEMON_HEADER_DIR}/utility/ratebuffer.h"
+    "${MUONDETECTOR_DAEMON_HEADER_DIR}/utility/inputrecorder.h"
+    "${MUONDETECTOR_DAEMON_HEADER_DIR}/utility/latencytracer.h"
+    "${MUONDETECTOR_DAEMON_HEADER_DIR}/utility/matrix.h"
+    "${MUONDETECTOR_DAEMON_HEADER_DIR}/utility/eventfilter.h"
+    "${MUONDETECTOR_DAEMON_HEADER_DIR}/utility/streamingestimator.h"
+    "${MUONDETECTOR_DAEMON_HEADER_DIR}/utility/timemarkcorrector.h"
+    "${MUONDETECTOR_DAEMON_HEADER_DIR}/utility/eventanalyzer.h"
+    "${MUONDETECTOR_DAEMON_HEADER_DIR}/utility/startuptimeline.h"
+    "${MUONDETECTOR_DAEMON_HEADER_DIR}/utility/ubxvalconfig.h"
+    "${MUONDETECTOR_DAEMON_HEADER_DIR}/utility/ubxratescheduler.h"
 
     "${MUONDETECTOR_I2C_HEADER_FILES}"
     "${MUONDETECTOR_SPI_HEADER_FILES}"
@@ -18,6 +18,7 @@ set(MUONDETECTOR_GUI_SOURCE_FILES
     "${MUONDETECTOR_GUI_SOURCE_DIR}/histogramdataform.cpp"
     "${MUONDETECTOR_GUI_SOURCE_DIR}/i2cform.cpp"
     "${MUONDETECTOR_GUI_SOURCE_DIR}/logplotswidget.cpp"
+    "${MUONDETECTOR_GUI_SOURCE_DIR}/logseriesmodel.cpp"
     "${MUONDETECTOR_GUI_SOURCE_DIR}/main.cpp"
     "${MUONDETECTOR_GUI_SOURCE_DIR}/mainwindow.cpp"
     "${MUONDETECTOR_GUI_SOURCE_DIR}/map.cpp"
@@ -27,6 +28,8 @@ set(MUONDETECTOR_GUI_SOURCE_FILES
     "${MUONDETECTOR_GUI_SOURCE_DIR}/ubloxsettingsform.cpp"
     "${MUONDETECTOR_GUI_SOURCE_DIR}/spiform.cpp"
     "${MUONDETECTOR_GUI_SOURCE_DIR}/status.cpp"
+    "${MUONDETECTOR_GUI_SOURCE_DIR}/timeseries.cpp"
+    "${MUONDETECTOR_GUI_SOURCE_DIR}/timeseriesdata.cpp"
     )
 
 set(MUONDETECTOR_GUI_HEADER_FILES
@@ -39,6 +42,7 @@ set(MUONDETECTOR_GUI_HEADER_FILES
     "${MUONDETECTOR_GUI_HEADER_DIR}/histogramdataform.h"
     "${MUONDETECTOR_GUI_HEADER_DIR}/i2cform.h"
     "${MUONDETECTOR_GUI_HEADER_DIR}/logplotswidget.h"
+    "${MUONDETECTOR_GUI_HEADER_DIR}/logseriesmodel.h"
     "${MUONDETECTOR_GUI_HEADER_DIR}/mainwindow.h"
     "${MUONDETECTOR_GUI_HEADER_DIR}/map.h"
     "${MUONDETECTOR_GUI_HEADER_DIR}/parametermonitorform.h"
@@ -47,6 +51,8 @@ set(MUONDETECTOR_GUI_HEADER_FILES
     "${MUONDETECTOR_GUI_HEADER_DIR}/ubloxsettingsform.h"
     "${MUONDETECTOR_GUI_HEADER_DIR}/spiform.h"
     "${MUONDETECTOR_GUI_HEADER_DIR}/status.h"
+    "${MUONDETECTOR_GUI_HEADER_DIR}/timeseries.h"
+    "${MUONDETECTOR_GUI_HEADER_DIR}/timeseriesdata.h"
     )
 set(MUONDETECTOR_GUI_UI_FILES
     "${MUONDETECTOR_GUI_UI_DIR}/calibform.ui"
@@ -16,10 +16,12 @@ set(MUONDETECTOR_LIBRARY_SOURCE_FILES
     "${MUONDETECTOR_LIBRARY_SRC_DIR}/config.cpp"
     "${MUONDETECTOR_LIBRARY_SRC_DIR}/tcpconnection.cpp"
     "${MUONDETECTOR_LIBRARY_SRC_DIR}/tcpmessage.cpp"
+    "${MUONDETECTOR_LIBRARY_SRC_DIR}/tcpmessagedispatcher.cpp"
     "${MUONDETECTOR_LIBRARY_SRC_DIR}/histogram.cpp"
     "${MUONDETECTOR_LIBRARY_SRC_DIR}/custom_io_operators.cpp"
     "${MUONDETECTOR_LIBRARY_SRC_DIR}/ublox_structs.cpp"
     "${MUONDETECTOR_LIBRARY_SRC_DIR}/networkdiscovery.cpp"
+    "${MUONDETECTOR_LIBRARY_SRC_DIR}/eventformatter.cpp"
     )
 
 set(MUONDETECTOR_LIBRARY_HEADER_FILES
@@ -29,12 +31,14 @@ set(MUONDETECTOR_LIBRARY_HEADER_FILES
     "${MUONDETECTOR_LIBRARY_HEADER_DIR}/tcpconnection.h"
     "${MUONDETECTOR_LIBRARY_HEADER_DIR}/tcpmessage.h"
     "${MUONDETECTOR_LIBRARY_HEADER_DIR}/tcpmessage_keys.h"
+    "${MUONDETECTOR_LIBRARY_HEADER_DIR}/tcpmessagedispatcher.h"
     "${MUONDETECTOR_LIBRARY_HEADER_DIR}/ublox_messages.h"
     "${MUONDETECTOR_LIBRARY_HEADER_DIR}/ublox_structs.h"
     "${MUONDETECTOR_LIBRARY_HEADER_DIR}/muondetector_structs.h"
     "${MUONDETECTOR_LIBRARY_HEADER_DIR}/config.h"
     "${MUONDETECTOR_LIBRARY_HEADER_DIR}/custom_io_operators.h"
     "${MUONDETECTOR_LIBRARY_HEADER_DIR}/networkdiscovery.h"
+    "${MUONDETECTOR_LIBRARY_HEADER_DIR}/eventformatter.h"
     )
 
 if (MUONDETECTOR_BUILD_DAEMON)
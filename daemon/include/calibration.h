@@ -8,6 +8,8 @@
 
 // for sig handling:
 #include <QObject>
+#include <array>
+#include <functional>
 #include <iomanip>
 #include <sstream>
 #include <string>
@@ -41,6 +43,51 @@ class ShowerDetectorCalib {
 public:
     static const CalibStruct InvalidCalibStruct;
 
+    /**
+     * @brief keys of the calibration items, in the same order as CALIBITEMS
+     */
+    enum class Item : std::size_t {
+        Version,
+        FeatureFlags,
+        CalibFlags,
+        Date,
+        RSense,
+        VDiv,
+        Coeff0,
+        Coeff1,
+        Coeff2,
+        Coeff3,
+        WriteCycles,
+        Count
+    };
+    static constexpr std::size_t item_count { static_cast<std::size_t>(Item::Count) };
+
+    /**
+     * @brief conversion of the bias ADC channels into bias voltage and current
+     * The factors are derived from the calibration items whenever one of them changes,
+     * so the monitoring loop does not need to look up and parse the items.
+     */
+    struct BiasTransform {
+        double vdiv { 1. }; //!< voltage divider ratio
+        double rsense { 1. }; //!< sense resistor in MOhm
+        bool current_coeffs { false }; //!< apply the leakage current correction (COEFF2, COEFF3)
+        double current_offset { 0. }; //!< COEFF2 in uA
+        double current_slope { 0. }; //!< COEFF3 in uA/V
+
+        [[nodiscard]] auto voltage(double v2) const -> double { return v2 * vdiv; }
+        [[nodiscard]] auto sense_voltage(double v1, double v2) const -> double { return (v1 - v2) * vdiv; }
+        /**
+         * @return the bias current in uA
+         */
+        [[nodiscard]] auto current(double v1, double v2) const -> double
+        {
+            const double icorr { current_coeffs ? voltage(v2) * current_slope + current_offset : 0. };
+            return sense_voltage(v1, v2) / rsense - icorr;
+        }
+    };
+
+    using ChangeHandler = std::function<void(Item)>;
+
     ShowerDetectorCalib() { init(); }
     ShowerDetectorCalib(std::shared_ptr<EEPROM24AA02> eep)
         : fEeprom(eep)
@@ -62,6 +109,12 @@ public:
     void updateBuffer();
     void printBuffer();
     void printCalibList();
+    [[nodiscard]] auto value(Item item) const -> double { return fValues[static_cast<std::size_t>(item)]; }
+    [[nodiscard]] auto biasTransform() const -> const BiasTransform& { return fBiasTransform; }
+    /**
+     * @brief handler is called for every item whose value changed by setCalibItem or readFromEeprom
+     */
+    void setChangeHandler(ChangeHandler handler) { fChangeHandler = std::move(handler); }
     bool isValid() const { return fValid; }
     bool isEepromValid() const { return fEepromValid; }
     uint64_t getSerialID();
@@ -76,8 +129,14 @@ public:
 private:
     void init();
     void buildCalibList();
+    void decodeItem(std::size_t index);
+    void setValue(std::size_t index, double value);
+    void updateBiasTransform();
 
     std::vector<CalibStruct> fCalibList;
+    std::array<double, item_count> fValues {}; //!< decoded values of fCalibList
+    BiasTransform fBiasTransform {};
+    ChangeHandler fChangeHandler {};
     std::shared_ptr<EEPROM24AA02> fEeprom {};
     uint8_t fEepBuffer[256];
     bool fEepromValid = false;
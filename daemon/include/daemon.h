@@ -28,12 +28,19 @@
 #include "networkdiscovery.h"
 #include "geoposmanager.h"
 #include "utility/ratebuffer.h"
+#include "utility/inputrecorder.h"
+#include "utility/latencytracer.h"
+#include "utility/timemarkcorrector.h"
+#include "utility/eventanalyzer.h"
+#include "utility/startuptimeline.h"
+#include "utility/ubxratescheduler.h"
 
 // from library
 #include <muondetector_structs.h>
 #include <histogram.h>
 #include <mqtthandler.h>
 #include <tcpconnection.h>
+#include <tcpmessagedispatcher.h>
 
 // for sig handling:
 #include <signal.h>
@@ -66,10 +73,18 @@ public:
         std::array<bool, 2> polarity { true, true };
         std::size_t maxGeohashLength { MuonPi::Settings::log.max_geohash_length };
         bool storeLocal { false };
+        bool event_analysis { false }; //!< coincidence analysis of the time marks with the gpio lines and the TDC, see EventAnalyzer
+        bool event_summary_only { false }; //!< publish only the periodic event analysis summaries instead of every event
+        QString capture_file { "" }; //!< if set, the raw input streams are recorded to this file
+        QString replay_file { "" }; //!< if set, the raw input streams are replayed from this file
+        double replay_speed { 1. }; //!< replay speed factor, <= 0 replays as fast as possible
+        std::chrono::microseconds event_coincidence_window { 0 }; //!< max delay of an AND edge w.r.t. the preceding XOR edge, 0 disables the check
         /* GNSS configs */
         bool gnss_dump_raw { false };
         int gnss_baudrate { 9600 };
+        int gnss_max_baudrate { 115200 }; //!< upper limit of the negotiated baud rate, 0 keeps the detected rate
         bool gnss_config { false };
+        bool gnss_time_correction { false }; //!< correct the time marks for the tick quantisation and the clock bias, see TimeMarkCorrector
         UbxDynamicModel gnss_dynamic_model { UbxDynamicModel::stationary };
         PositionModeConfig position_mode_config {
             PositionModeConfig::Mode::Auto,
@@ -87,6 +102,8 @@ public:
     ~Daemon() override;
     void configGps();
     void configGpsForVersion();
+    void configGpsLegacy();
+    void configGpsValSet();
     void loop();
     static void hupSignalHandler(int);
     static void termSignalHandler(int);
@@ -130,6 +147,8 @@ public slots:
     void getTemperature();
     void scanI2cBus();
     void onUBXReceivedTimeTM2(const UbxTimeMarkStruct& tm);
+    void onUBXReceivedNavClock(uint32_t iTOW, int32_t bias, int32_t drift, uint32_t tAcc, uint32_t fAcc);
+    void onUBXReceivedTimePulse(uint16_t week, uint32_t towMS, uint32_t towSubMS, int32_t qErr, bool utc);
     void onLogParameterPolled();
     void sendExtendedMqttStatus(MuonPi::MqttHandler::Status status);
 
@@ -161,10 +180,12 @@ signals:
     void UBXSetCfgTP5(const UbxTimePulseStruct& tp);
     void UBXSetAopCfg(bool enable = true, uint16_t maxOrbErr = 0);
     void UBXSaveCfg(uint8_t devMask = QtSerialUblox::DEV_BBR | QtSerialUblox::DEV_FLASH);
+    void UBXValSet(const UbxValConfig& config, uint8_t layers);
+    void UBXValGet(const UbxValConfig& config);
     void setSamplingTriggerSignal(GPIO_SIGNAL signalName);
     void timeMarkIntervalCountUpdate(uint16_t newCounts, double lastInterval);
     void requestMqttConnectionStatus();
-    void eventMessage(const QString& messageString);
+    void eventRecord(EventRecord record);
 
 private slots:
     void onRateBufferReminder();
@@ -181,6 +202,11 @@ private:
         // 0: coincidence ; 1: xor ; 2: discr 1 ; 3: discr 2
     void setEventTriggerSelection(GPIO_SIGNAL signal);
     void sendPcaChannel();
+    [[nodiscard]] auto gnssValConfigSupported() const -> bool;
+    void applyGpsConfig();
+    void setupUbxRateScheduler();
+    void updateUbxMsgSupport(); //!< selects the satellite message supported by the receiver
+    void applyUbxMsgRates(); //!< sends the message rates the scheduler changed
     void sendVersionInfo();
     void sendEventTriggerSelection();
     void setDacThresh(uint8_t channel, float threshold); // channel 0 or 1 ; threshold in volts
@@ -202,6 +228,23 @@ private:
     void sendCalib();
     void sendHistogram(const Histogram& hist);
     void sendLogInfo();
+    void sendLatencyStatistics(const std::vector<LatencyTracer::StageStatistics>& stats);
+    void logLatencyStatistics();
+    void logEventFilterStatistics();
+    void logOledStatistics();
+    void releaseTimeMarks();
+    void publishTimeMark(const UbxTimeMarkStruct& tm);
+    void analyseTimeMark(const UbxTimeMarkStruct& tm);
+    void logEventAnalysisSummary();
+    void resetEventAnalysis();
+    void setupTcpDispatcher();
+    /**
+     * @brief start-up phases which complete asynchronously are marked as timed out after timeout
+     */
+    void beginStartupPhase(const std::string& name, std::chrono::milliseconds timeout);
+    void finishStartupPhase(const std::string& name, bool success = true); //!< the timeline is logged once all phases are done
+    void logTcpDispatchStatistics();
+    void logCalibParameters();
     void sendGeodeticPos(const GnssPosStruct& pos);
     void sendPositionModel(const PositionModeConfig& pos);
     bool readEeprom();
@@ -214,6 +257,7 @@ private:
     void printTimestamp();
     void delay(int millisecondsWait);
     void onAdcSampleReady(ADS1115::Sample sample);
+    void setupInputReplay();
 
     void rateCounterIntervalActualisation();
     qreal getRateFromCounts(quint8 which_rate);
@@ -287,6 +331,8 @@ private:
     QTimer samplingTimer;
     QTimer parameterMonitorTimer;
     QTimer rateScanTimer;
+    QTimer latencyCollectTimer;
+    QTimer timeMarkReleaseTimer;
     //    QMap<QString, Property> propertyMap;
     LogEngine logEngine;
     NetworkDiscovery* networkDiscovery { nullptr };
@@ -300,8 +346,22 @@ private:
 
     configuration config;
     GeoPosManager m_geopos_manager;
+    TimeMarkCorrector m_time_mark_corrector {};
+    std::vector<TimeMarkCorrector::Result> m_corrected_time_marks {};
+    EventAnalyzer m_event_analyzer {};
+    std::int64_t m_last_coincidence_ns { 0 }; //!< time of the last twofold coincidence, for the coincidence interval
+    bool m_gnss_config_pending { false }; //!< the configuration waits for the receiver version
+    bool m_gnss_valset_failed { false }; //!< the receiver rejected the key-value configuration
+    UbxRateScheduler m_ubx_scheduler {};
+    int m_tcp_clients { 0 };
+    StartupTimeline m_startup {};
+    bool m_startup_reported { false };
+    TcpMessageDispatcher m_tcp_dispatcher {};
+    uint32_t m_last_tdc_tick { 0 }; //!< tick of the last TDC interrupt, the conversion result follows it
     std::map<unsigned int, std::shared_ptr<EventRateBuffer>> m_gpio_ratebuffers {};
     std::shared_ptr<CounterRateBuffer> m_ublox_ratebuffer {};
+    std::shared_ptr<InputRecorder> m_input_recorder {};
+    QPointer<InputReplay> m_input_replay {};
 };
 
 #endif // DAEMON_H
@@ -1,25 +1,31 @@
 #ifndef GEOPOSMANAGER_H
 #define GEOPOSMANAGER_H
 #include "utility/kalman_gnss_filter.h"
+#include "utility/streamingestimator.h"
 #include <cmath>
 #include <config.h>
 #include <functional>
-#include <histogram.h>
-#include <memory>
 #include <muondetector_structs.h>
 
 class GeoPosManager {
 public:
+    struct Convergence {
+        double hor_drift { 0. }; //!< drift of the horizontal position estimate in m
+        double vert_drift { 0. }; //!< drift of the altitude estimate in m
+        double entries { 0. }; //!< effective number of samples of the least filled coordinate
+    };
+
     GeoPosManager() = default;
     GeoPosManager(const PositionModeConfig& mode_config);
     ~GeoPosManager() = default;
     void set_mode_config(const PositionModeConfig& mode_config);
     auto get_mode_config() const -> const PositionModeConfig&;
-    void set_histos(
-        std::shared_ptr<Histogram> lon,
-        std::shared_ptr<Histogram> lat,
-        std::shared_ptr<Histogram> height);
-    void new_position(const GeoPosition& new_pos);
+    /**
+     * @brief process a new position fix
+     * @param hdop, vdop dilution of precision of the fix, used to reject samples for the lock-in
+     */
+    void new_position(const GeoPosition& new_pos, double hdop, double vdop);
+    [[nodiscard]] auto get_convergence() const -> Convergence;
     const GeoPosition& get_current_position() const;
     void set_static_position(const GeoPosition& pos);
     const GeoPosition& get_static_position() const;
@@ -29,9 +35,18 @@ public:
     auto get_filter() const -> PositionModeConfig::FilterType;
     void set_lockin_ready_callback(std::function<void(GeoPosition)> func);
     void set_valid_pos_callback(std::function<void(GeoPosition)> func);
+    /**
+     * @brief discard the samples of the lock-in estimate, the position estimate starts over
+     */
+    void reset_estimators();
+    /**
+     * @brief the position and clock filter, which is also fed with the clock solutions of the receiver
+     */
+    [[nodiscard]] auto gnss_filter() -> KalmanGnssFilter& { return m_gnss_pos_kalman; }
 
 private:
-    GeoPosition get_pos_from_histos() const;
+    GeoPosition get_pos_from_estimators() const;
+    void set_estimator_location(PositionModeConfig::FilterType filter);
     void check_for_lockin_reached(const GeoPosition& preliminary_pos);
 
     GeoPosition m_position {};
@@ -40,9 +55,9 @@ private:
     std::function<void(GeoPosition)> m_valid_pos_fn;
 
     KalmanGnssFilter m_gnss_pos_kalman { 0.1 };
-    std::shared_ptr<Histogram> m_lon_histo;
-    std::shared_ptr<Histogram> m_lat_histo;
-    std::shared_ptr<Histogram> m_height_histo;
+    StreamingEstimator m_lon_estimator { StreamingEstimator::Location::Median, MuonPi::Config::lock_in_window_entries, MuonPi::Config::lock_in_min_entries };
+    StreamingEstimator m_lat_estimator { StreamingEstimator::Location::Median, MuonPi::Config::lock_in_window_entries, MuonPi::Config::lock_in_min_entries };
+    StreamingEstimator m_height_estimator { StreamingEstimator::Location::Median, MuonPi::Config::lock_in_window_entries, MuonPi::Config::lock_in_min_entries };
 };
 
 #endif // GEOPOSMANAGER_H
@@ -4,6 +4,11 @@
 #include "hardware/i2c/i2cdevice.h"
 
 #include "hardware/i2c/Adafruit_GFX.h"
+
+#include <config.h>
+
+#include <cstddef>
+#include <vector>
 // OLED defines
 #define OLED_I2C_RESET RPI_V2_GPIO_P1_22 /* GPIO 25 pin 12  */
 // Oled supported display
@@ -44,6 +49,12 @@ public:
     enum { BLACK = 0,
         WHITE = 1 };
 
+    struct TransferStatistics {
+        std::size_t bytes { 0 }; //!< bytes written to the bus, including the control bytes and addressing commands
+        std::size_t transactions { 0 }; //!< number of i2c write transactions
+        double bus_time { 0. }; //!< time spent transferring in ms
+    };
+
     Adafruit_SSD1306()
         : i2cDevice(0x3c)
     {
@@ -80,7 +91,24 @@ public:
 
     void clearDisplay(void);
     void invertDisplay(bool inv);
+    /**
+     * @brief transmit the framebuffer to the panel
+     * Only the column range of each page which was drawn to since the last call and
+     * actually differs from the panel content is transmitted.
+     */
     void display();
+    /**
+     * @brief forget the panel content, the next display() transmits the full framebuffer
+     */
+    void invalidate();
+
+    /**
+     * @brief set the number of data bytes per i2c transaction
+     * @param size 0 transmits each changed page segment in a single transaction
+     */
+    void setTransferChunkSize(std::size_t size) { m_chunk_size = size; }
+    [[nodiscard]] auto lastTransfer() const -> TransferStatistics { return m_last_transfer; }
+    [[nodiscard]] auto totalTransfer() const -> TransferStatistics { return m_total_transfer; }
 
     void startscrollright(uint8_t start, uint8_t stop);
     void startscrollleft(uint8_t start, uint8_t stop);
@@ -97,6 +125,20 @@ private:
     int16_t ssd1306_lcdwidth, ssd1306_lcdheight;
     uint8_t vcc_type;
 
+    struct ColumnRange {
+        int16_t first;
+        int16_t last; //!< the range is empty if last < first
+    };
+    std::vector<uint8_t> m_panel {}; //!< copy of the content transmitted to the panel
+    std::vector<ColumnRange> m_dirty {}; //!< columns drawn to since the last display(), one range per page
+    std::vector<char> m_tx_buffer {};
+    bool m_panel_valid { false };
+    std::size_t m_chunk_size { MuonPi::Config::Hardware::OLED::transfer_chunk_size };
+    TransferStatistics m_last_transfer {};
+    TransferStatistics m_total_transfer {};
+
+    void markDirty(int16_t column, int16_t page);
+    void markAllDirty();
     void fastI2Cwrite(uint8_t c);
     void fastI2Cwrite(char* tbuf, uint32_t len);
 };
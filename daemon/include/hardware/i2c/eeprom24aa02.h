@@ -4,6 +4,8 @@
 #include "hardware/device_types.h"
 #include "hardware/i2c/i2cdevice.h"
 
+#include <array>
+
 /* EEPROM24AA02  */
 
 class EEPROM24AA02 : public i2cDevice, public DeviceFunction<DeviceType::EEPROM>, public static_device_base<EEPROM24AA02> {
@@ -37,12 +39,35 @@ public:
 	* the page-wise sequential write (c.f. http://ww1.microchip.com/downloads/en/devicedoc/21709c.pdf  p.7).
 	*/
     bool writeBytes(uint8_t addr, uint16_t length, uint8_t* data) override;
+    /** Read multiple bytes starting from given address.
+	* @note reads within the memory range are served from a shadow copy of the EEPROM content, which is
+	* loaded with a single sequential read on first access and kept up to date by writeBytes
+	*/
     int16_t readBytes(uint8_t regAddr, uint16_t length, uint8_t* data) override;
+    /** Reload the shadow copy from the device.
+	* @return Status of operation (true = success)
+	*/
+    bool refresh();
 
     bool identify() override;
     bool probeDevicePresence() override { return devicePresent(); }
 
+    static constexpr std::size_t MEMSIZE { 256 };
+    static constexpr std::size_t PAGESIZE { 8 };
+    static constexpr std::size_t NR_PAGES { MEMSIZE / PAGESIZE };
+
+    unsigned int getPageWriteCount(std::size_t page) const { return (page < NR_PAGES) ? fPageWriteCount[page] : 0; } //!< page writes since startup
+    unsigned int getLastPagesWritten() const { return fLastPagesWritten; } //!< number of pages written by the last writeBytes call
+
 private:
+    int16_t readBlock(uint8_t regAddr, uint16_t length, uint8_t* data);
+    bool waitWriteCycle();
+
+    std::array<uint8_t, MEMSIZE> fShadow {};
+    bool fShadowValid { false };
+    std::array<unsigned int, NR_PAGES> fPageWriteCount {};
+    unsigned int fLastPagesWritten { 0 };
+
     // hide all write functions from i2cDevice class since they do not conform to the correct write sequence of the eeprom
     using i2cDevice::readBytes;
     using i2cDevice::write;
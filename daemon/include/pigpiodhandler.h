@@ -6,9 +6,12 @@
 #include <QObject>
 #include <QTimer>
 #include <QVector>
+#include <atomic>
 #include <memory>
 
+#include "utility/eventfilter.h"
 #include "utility/gpio_mapping.h"
+#include "utility/inputrecorder.h"
 #include <gpio_pin_definitions.h>
 
 #define XOR_RATE 0
@@ -21,8 +24,8 @@ class PigpiodHandler : public QObject {
     Q_OBJECT
 
 public:
-    explicit PigpiodHandler(QVector<unsigned int> gpioPins = DEFAULT_VECTOR, unsigned int spi_freq = 61035,
-        uint32_t spi_flags = 0, QObject* parent = nullptr);
+    explicit PigpiodHandler(QVector<unsigned int> gpioPins = DEFAULT_VECTOR, EventFilter::Config filter_config = {},
+        unsigned int spi_freq = 61035, uint32_t spi_flags = 0, QObject* parent = nullptr);
     // can't make it private because of access of PigpiodHandler with global pointer
     QDateTime startOfProgram, lastSamplingTime; // the exact time when the program starts (Utc)
     QElapsedTimer elapsedEventTimer;
@@ -35,17 +38,29 @@ public:
 
     bool isInhibited() const { return inhibit; }
     void setInhibited(bool inh = true) { inhibit = inh; }
+    bool isReplayMode() const { return m_replay_mode; }
+    void setReplayMode(bool replay = true) { m_replay_mode = replay; }
+    InputRecorder* inputRecorder() const { return m_input_recorder.load(); }
+    void setInputRecorder(InputRecorder* recorder) { m_input_recorder = recorder; } //!< non-owning, the recorder must outlive the handler
+    EventFilter& eventFilter() { return m_event_filter; } //!< only to be used from the gpio callback, except for EventFilter::statistics()
 
 signals:
     void signal(uint8_t gpio_pin);
+    void gpioEvent(uint8_t gpio_pin, uint32_t tick); //!< same as signal, with the pigpio tick of the edge in us
     void samplingTrigger();
     void eventInterval(quint64 nsecs);
     void timePulseDiff(qint32 usecs);
+    void initialisationFinished(); //!< the connection to pigpiod is established and the callbacks are registered
 
     // spi related signals
     void spiData(uint8_t reg, std::string data);
 
 public slots:
+    /**
+     * @brief connect to pigpiod and register the callbacks of the input pins
+     * Called once the handler has been moved to its thread, so the connection is set up in parallel to the rest of the daemon start-up.
+     */
+    void initialise();
     void stop();
     bool initialised();
     void setInput(unsigned int gpio);
@@ -55,6 +70,7 @@ public slots:
     void setGpioState(unsigned int gpio, bool state);
     void setSamplingTriggerSignal(GPIO_SIGNAL signalName) { samplingTriggerSignal = signalName; }
     void registerForCallback(unsigned int gpio, bool edge); // false=falling, true=rising
+    void injectTick(unsigned int gpio, unsigned int level, quint32 tick); //!< feeds a replayed GPIO edge into the event processing
 
     // spi related slots
     void writeSpi(uint8_t command, std::string data);
@@ -62,6 +78,7 @@ public slots:
 
 private:
     bool isInitialised = false;
+    QVector<unsigned int> m_gpio_pins {};
     bool spiInitialised = false;
     bool spiInitialise(); // will be executed at first spi read/write command
     bool isSpiInitialised();
@@ -81,6 +98,9 @@ private:
 
     void measureGpioClockTime();
     bool inhibit = false;
+    std::atomic<bool> m_replay_mode { false };
+    std::atomic<InputRecorder*> m_input_recorder { nullptr };
+    EventFilter m_event_filter;
     int verbose = 0;
 };
 
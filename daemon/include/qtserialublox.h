@@ -6,11 +6,19 @@
 #include <QPointer>
 #include <QSerialPort>
 #include <QTimer>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <map>
 #include <memory>
 #include <queue>
 #include <string>
 #include <ublox_structs.h>
 
+#include "utility/inputrecorder.h"
+#include "utility/ubxvalconfig.h"
+#include "utility/unixtime_from_gps.h"
+
 struct GnssPosStruct;
 struct GnssMonHwStruct;
 struct GnssMonHw2Struct;
@@ -63,6 +71,8 @@ signals:
     void gpsPropertyUpdatedGeodeticPos(GnssPosStruct pos);
     void timTM2(QString timTM2String);
     void UBXReceivedTimeTM2(const UbxTimeMarkStruct& tm);
+    void UBXReceivedNavClock(uint32_t iTOW, int32_t bias, int32_t drift, uint32_t tAcc, uint32_t fAcc);
+    void UBXReceivedTimePulse(uint16_t week, uint32_t towMS, uint32_t towSubMS, int32_t qErr, bool utc);
     void gpsVersion(const QString& swVersion, const QString& hwVersion, const QString& protVersion);
     void gpsMonHW(const GnssMonHwStruct& hw);
     void gpsMonHW2(const GnssMonHw2Struct& hw2);
@@ -71,6 +81,13 @@ signals:
     void UBXReceivedDops(const UbxDopStruct& dops);
     void UBXReceivedTxBuf(uint8_t txUsage, uint8_t txPeakUsage);
     void UBXReceivedRxBuf(uint8_t rxUsage, uint8_t rxPeakUsage);
+    void UBXRoundTrip(uint16_t msgID, std::chrono::duration<double> rtt); //!< time from sending a message until its ACK/NAK or poll response arrived
+    void UBXBaudRateChanged(uint32_t baudRate);
+    /**
+     * @brief utilization of the uart link, emitted every Config::Hardware::GNSS::utilization_interval
+     * @param rxLoad, txLoad fraction of the link capacity used in receive and transmit direction
+     */
+    void UBXLinkUtilization(uint32_t baudRate, double rxLoad, double txLoad);
 
 public slots:
     // all functions that can be called from other classes through signal/slot mechanics
@@ -91,6 +108,9 @@ public slots:
     void UBXSetCfgTP5(const UbxTimePulseStruct& tp);
     void UBXSetAopCfg(bool enable = true, uint16_t maxOrbErr = 0);
     void UBXSaveCfg(uint8_t devMask = DEV_BBR | DEV_FLASH);
+    // key-value configuration, only for protocol version 27 and newer
+    void UBXValSet(const UbxValConfig& config, uint8_t layers = UbxValConfig::RAM);
+    void UBXValGet(const UbxValConfig& config);
 
     void closeAll();
 
@@ -101,14 +121,37 @@ public slots:
     static const std::string& getProtVersionString() { return fProtVersionString; }
     static double getProtVersion();
 
+    void setInputRecorder(std::shared_ptr<InputRecorder> recorder) { m_input_recorder = recorder; }
+    void setReplayMode(bool replay = true) { m_replay_mode = replay; }
+    void setMaxBaudRate(int baudRate) { m_max_baud_rate = baudRate; } //!< upper limit of the baud rate negotiation, 0 keeps the detected rate
+    /**
+     * @brief detects the baud rate of the receiver and switches both sides to the highest rate up to the maximum that works
+     * Blocks the gnss thread until the link is established.
+     */
+    void negotiateBaudRate();
+    void injectRawData(const QByteArray& data); //!< feeds replayed raw receiver data into the message parser
+
 private:
     // all functions for sending and receiving raw data used by other functions in "public slots" section
     // and scanning raw data up to the point where "UbxMessage" object is generated
     bool scanUnknownMessage(std::string& buffer, UbxMessage& message);
+    void processRawData(const QByteArray& data);
     bool sendUBX(uint16_t msgID, const std::string& payload, uint16_t nBytes);
     bool sendUBX(uint16_t msgID, unsigned char* payload, uint16_t nBytes);
     bool sendUBX(const UbxMessage& msg);
-    void sendQueuedMsg(bool afterTimeout = false);
+    void flushTxBuffer();
+    /**
+     * @brief polls the port configuration at baudRate and waits for any valid ubx message
+     * @param outProtocolMask set from the port configuration, 0 if it was not received
+     */
+    auto probeBaudRate(int baudRate, uint8_t& outProtocolMask) -> bool;
+    auto switchBaudRate(int baudRate, uint8_t outProtocolMask) -> bool;
+    void writeCfgPrt(int baudRate, uint8_t outProtocolMask); //!< writes CFG-PRT immediately, bypassing the send queue
+    auto cfgPrtPayload(uint8_t port, uint8_t outProtocolMask, int baudRate) const -> std::string;
+    void emitLinkUtilization();
+    void checkLink();
+    void sendQueuedMsg();
+    void restartAckTimer();
     void delay(int millisecondsWait);
 
     // all functions only used for processing and showing "UbxMessage"
@@ -135,6 +178,7 @@ private:
     void UBXCfgNavX5(const std::string& msg);
     void UBXCfgAnt(const std::string& msg);
     void UBXCfgTP5(const std::string& msg);
+    void UBXCfgValGet(const std::string& msg);
 
     auto UBXMonVer() -> std::vector<std::string>;
     void UBXMonHW(const std::string& msg);
@@ -157,13 +201,34 @@ private:
     bool discardAllNMEA = true; // if true discard all NMEA messages and do not parse them
     bool showout = false; // if true show the ubx messages sent to the gps board as hex
     bool showin = false;
+    struct PendingMessage {
+        UbxMessage message;
+        std::chrono::steady_clock::time_point sent {};
+        std::size_t retries { 0 };
+        std::size_t unanswered { 1 }; //!< transmissions of this message the receiver did not answer yet
+        bool answered { false }; //!< ACK/NAK reported, only a late answer to an earlier transmission is outstanding
+    };
     std::queue<UbxMessage> outMsgBuffer;
-    std::unique_ptr<UbxMessage> msgWaitingForAck { nullptr };
+    std::deque<PendingMessage> m_in_flight {}; //!< messages sent but not yet acknowledged, in the order the receiver processes them
+    std::map<uint16_t, std::chrono::steady_clock::time_point> m_pending_polls {}; //!< polls answered without ACK and the time they were sent
+    QByteArray m_tx_buffer {}; //!< messages sent within the same event loop turn go out in a single write
+    bool m_tx_flush_scheduled { false };
     QPointer<QTimer> ackTimer;
-    std::size_t sendRetryCounter { 0 };
+    std::shared_ptr<InputRecorder> m_input_recorder {};
+    std::atomic<bool> m_replay_mode { false }; //!< set from the daemon thread once the replay is opened
+    int m_max_baud_rate { 0 };
+    bool m_negotiating { false }; //!< the port is read synchronously while the baud rate is negotiated
+    QPointer<QTimer> m_utilization_timer;
+    quint64 m_rx_bytes { 0 };
+    quint64 m_tx_bytes { 0 };
+    QPointer<QTimer> m_link_watchdog;
+    quint64 m_rx_frames { 0 }; //!< valid ubx messages since the last link check
+    bool m_link_established { false };
+    bool m_link_probed { false }; //!< a poll was sent because the last check interval saw no ubx message
 
     // all global variables used for keeping track of satellites and statistics (gpsProperty)
     gpsProperty<int> leapSeconds;
+    GpsTime::LeapSecondTable m_leap_seconds {};
     gpsProperty<double> noise;
     gpsProperty<double> agc;
     gpsProperty<uint8_t> fix;
@@ -178,7 +243,6 @@ private:
     gpsProperty<int32_t> clkDrift;
     gpsProperty<std::vector<GnssSatellite>> m_satList;
     gpsProperty<GnssPosStruct> geodeticPos;
-    const int MSGTIMEOUT = 1500;
     std::queue<gpsTimestamp> fTimestamps;
     static std::string fProtVersionString;
 
@@ -0,0 +1,116 @@
+#ifndef EVENTANALYZER_H
+#define EVENTANALYZER_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+
+/**
+ * @brief On-node coincidence analysis of the time marks with the gpio event lines and the TDC
+ * The gpio edges and TDC interrupts are time stamped with the free running µs tick of pigpio,
+ * the time marks with GNSS time. The offset between both time bases is acquired from the intervals
+ * of consecutive events, which are unique for randomly arriving particles, and afterwards tracked
+ * together with the drift of the tick oscillator on every coincidence found.
+ * Each time mark is checked for an edge within the coincidence window on every channel and for a TDC
+ * measurement which completed within tdc_window after it. The result of every time mark is returned
+ * for histogramming, the counters are accumulated into a Summary for periodic publication.
+ * Not thread safe, all methods have to be called from the same thread.
+ */
+class EventAnalyzer {
+public:
+    static constexpr std::size_t max_channels { 4 };
+
+    struct Config {
+        std::chrono::nanoseconds coincidence_window { std::chrono::microseconds { 20 } };
+        std::chrono::nanoseconds tdc_window { std::chrono::milliseconds { 2 } };
+        std::chrono::nanoseconds buffer_span { std::chrono::seconds { 5 } }; //!< time span of edges, TDC measurements and time marks kept for matching
+    };
+
+    struct Result {
+        std::int64_t time_ns { 0 }; //!< time of the mark
+        std::int64_t interval_ns { 0 }; //!< time since the preceding mark, 0 if there is none in the buffer
+        std::uint8_t channel_mask { 0 }; //!< bit n is set if channel n had a coincident edge
+        std::uint8_t multiplicity { 0 }; //!< number of channels with a coincident edge
+        std::array<double, max_channels> residual_ns {}; //!< edge time - mark time, valid for the channels in channel_mask
+        bool tdc_matched { false };
+        double tdc_us { 0. };
+        bool locked { false }; //!< false while the time bases are not aligned, no coincidences are evaluated then
+    };
+
+    struct Summary {
+        std::size_t marks { 0 };
+        std::size_t analysed_marks { 0 }; //!< marks evaluated while locked
+        std::array<std::size_t, max_channels + 1> multiplicity {};
+        std::array<std::size_t, max_channels> channel_matches {};
+        std::array<double, max_channels> residual_rms_ns {};
+        std::size_t tdc_matches { 0 };
+        std::size_t acquisitions { 0 }; //!< number of times the time bases were (re)aligned
+        std::int64_t first_ns { 0 };
+        std::int64_t last_ns { 0 };
+        bool locked { false };
+
+        [[nodiscard]] auto rate() const -> double; //!< mean rate of the marks in Hz
+    };
+
+    EventAnalyzer();
+    explicit EventAnalyzer(Config config);
+
+    void add_gpio_event(std::size_t channel, std::uint32_t tick);
+    void add_tdc(std::uint32_t tick, double t_diff_us);
+    [[nodiscard]] auto add_time_mark(std::int64_t time_ns) -> Result;
+
+    /**
+     * @brief the counters accumulated since the last call
+     */
+    [[nodiscard]] auto take_summary() -> Summary;
+    [[nodiscard]] auto locked() const -> bool { return m_locked; }
+    void reset();
+
+private:
+    struct Edge {
+        std::int64_t time_ns { 0 };
+        std::size_t channel { 0 };
+    };
+    struct TdcMeasurement {
+        std::int64_t time_ns { 0 };
+        double t_diff_us { 0. };
+    };
+
+    static constexpr std::int64_t c_acquisition_tolerance_ns { 50000 }; ///< max mismatch of two intervals during acquisition
+    static constexpr std::size_t c_acquisition_hits { 3 }; ///< consecutive consistent offsets required for the lock
+    static constexpr std::size_t c_max_misses { 10 }; ///< consecutive marks without coincidence after which the lock is dropped
+    static constexpr double c_offset_gain { 0.25 };
+    static constexpr double c_drift_gain { 0.02 };
+
+    [[nodiscard]] auto unwrap(std::uint32_t tick) -> std::int64_t;
+    [[nodiscard]] auto predicted_offset(std::int64_t mark_ns) const -> double;
+    void acquire(std::int64_t mark_ns, std::int64_t interval_ns);
+    void match(std::int64_t mark_ns, Result& result);
+    void prune();
+
+    Config m_config;
+    std::deque<Edge> m_edges {};
+    std::deque<TdcMeasurement> m_tdc {};
+    std::deque<std::int64_t> m_marks {};
+
+    bool m_tick_valid { false };
+    std::uint32_t m_last_tick { 0 };
+    std::int64_t m_last_tick_ns { 0 };
+
+    bool m_locked { false };
+    double m_offset_ns { 0. }; //!< mark time - tick time at m_offset_time_ns
+    double m_drift { 0. }; //!< change of the offset per ns
+    std::int64_t m_offset_time_ns { 0 };
+    std::size_t m_misses { 0 };
+    std::int64_t m_candidate_ns { 0 };
+    std::int64_t m_candidate_time_ns { 0 };
+    std::int64_t m_first_candidate_ns { 0 }; //!< first offset of the current acquisition, for the initial drift
+    std::int64_t m_first_candidate_time_ns { 0 };
+    std::size_t m_candidate_hits { 0 };
+
+    Summary m_summary {};
+    std::array<double, max_channels> m_residual_sum2 {};
+};
+
+#endif // EVENTANALYZER_H
@@ -0,0 +1,104 @@
+#ifndef EVENTFILTER_H
+#define EVENTFILTER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Filter stage for the raw gpio edges, applied directly in the gpio callback
+ * Only edges of registered channels are filtered, all other edges are accepted unconditionally.
+ * An edge of a registered channel is suppressed, if
+ * - the channel is in burst state, i.e. more than burst_threshold edges followed each other within burst_interval,
+ * - the channel requires a coincidence and the reference channel had no edge within the coincidence window before,
+ * - the edge lies within the deadtime after the last accepted edge of the channel.
+ * The deadtime is adapted with hysteresis to the raw edge rate of the channel: it is increased while the
+ * rate exceeds rate_high and decreased while it is below rate_low.
+ * process() must only be called from one thread at a time, statistics() may be called from any thread.
+ */
+class EventFilter {
+public:
+    enum class Verdict : std::uint8_t {
+        Accepted = 0,
+        Burst,
+        Coincidence,
+        Deadtime
+    };
+
+    struct Config {
+        std::vector<unsigned int> channels {}; //!< bcm pins of the filtered channels
+        std::vector<std::pair<unsigned int, unsigned int>> coincidences {}; //!< pairs of (channel, reference channel)
+        std::chrono::microseconds coincidence_window { 0 }; //!< max delay of a channel edge w.r.t. the reference edge, 0 disables the coincidence requirement
+        std::chrono::microseconds min_deadtime { 0 };
+        std::chrono::microseconds max_deadtime { 10000 };
+        std::chrono::microseconds deadtime_step { 50 };
+        double rate_high { 100. }; //!< raw rate in Hz above which the deadtime is increased
+        double rate_low { 50. }; //!< raw rate in Hz below which the deadtime is decreased
+        std::chrono::microseconds burst_interval { 1000 };
+        unsigned int burst_threshold { 50 };
+    };
+
+    struct ChannelStatistics {
+        unsigned int gpio { 0 };
+        std::uint64_t accepted { 0 };
+        std::uint64_t suppressed_burst { 0 };
+        std::uint64_t suppressed_coincidence { 0 };
+        std::uint64_t suppressed_deadtime { 0 };
+        std::chrono::microseconds deadtime { 0 };
+        double rate { 0. }; //!< smoothed raw edge rate in Hz
+        bool burst { false };
+    };
+
+    static constexpr unsigned int max_gpio { 32 };
+
+    EventFilter() = default;
+    explicit EventFilter(Config config);
+
+    /**
+     * @brief decide about the edge of the given gpio at the given pigpio tick (us, wrapping)
+     */
+    [[nodiscard]] auto process(unsigned int gpio, std::uint32_t tick) -> Verdict;
+
+    /**
+     * @brief the accumulated counters and current state of all filtered channels
+     */
+    [[nodiscard]] auto statistics() const -> std::vector<ChannelStatistics>;
+
+    [[nodiscard]] static auto name(Verdict verdict) -> const char*;
+
+private:
+    static constexpr double c_rate_smoothing { 1. / 16. };
+
+    struct Channel {
+        bool filtered { false };
+        int reference { -1 };
+        bool seen { false };
+        bool accepted_once { false };
+        std::uint32_t last_tick { 0 };
+        std::uint32_t last_accepted_tick { 0 };
+        double mean_interval_us { 0. };
+        std::uint32_t deadtime_us { 0 };
+        unsigned int pileup { 0 };
+
+        // published for statistics()
+        std::atomic<std::uint64_t> accepted { 0 };
+        std::atomic<std::uint64_t> suppressed_burst { 0 };
+        std::atomic<std::uint64_t> suppressed_coincidence { 0 };
+        std::atomic<std::uint64_t> suppressed_deadtime { 0 };
+        std::atomic<std::uint32_t> current_deadtime_us { 0 };
+        std::atomic<double> current_rate { 0. };
+        std::atomic<bool> burst { false };
+    };
+
+    void updateDeadtime(Channel& channel);
+
+    Config m_config {};
+    std::uint32_t m_burst_interval_us { 0 };
+    std::uint32_t m_coincidence_window_us { 0 };
+    std::array<Channel, max_gpio> m_channels {};
+};
+
+#endif // EVENTFILTER_H
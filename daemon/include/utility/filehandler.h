@@ -10,6 +10,7 @@
 #include <QStandardPaths>
 #include <QVector>
 #include <config.h>
+#include <eventformatter.h>
 #include <muondetector_structs.h>
 
 class FileHandler : public QObject {
@@ -34,6 +35,7 @@ signals:
 public slots:
     void start();
     void writeToDataFile(const QString& data); //!< writes data to the file opened in "dataFile"
+    void writeEventToDataFile(EventRecord record); //!< writes the text encoded event to the file opened in "dataFile"
     void writeToLogFile(const QString& log); //!< writes log data to the file opened in "logFile"
     void setLogRotatePeriod(std::chrono::seconds period) { m_logrotate_period = period; }
 
@@ -43,6 +45,7 @@ private slots:
 private:
     QFile* dataFile = nullptr; //!< pointer to the file the events are currently written to
     QFile* logFile = nullptr; //!< pointer to the file the log information is written to
+    EventFormatter m_event_formatter {};
     QString hashedMacAddress;
     QString configFilePath;
     QString loginDataFilePath;
@@ -0,0 +1,112 @@
+#ifndef INPUTRECORDER_H
+#define INPUTRECORDER_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+
+/**
+ * @brief Binary capture of the raw detector input streams
+ * All inputs which drive the daemon's processing chain (pigpio edge ticks, raw bytes
+ * from the u-blox uart and ADC samples) are written to one file with a monotonic
+ * timestamp, so that a session can be replayed deterministically with InputReplay.
+ * File layout (host byte order):
+ *  header: 8 byte magic "MUONREC\0", uint16 format version
+ *  record: uint8 type, uint64 ns since start of capture, uint32 payload size, payload
+ * The record methods are thread-safe, they are called from the pigpio callback thread,
+ * the gnss thread and the main thread.
+ */
+class InputRecorder {
+public:
+    enum class RecordType : std::uint8_t {
+        GpioTick = 1, //!< payload: uint8 gpio, uint8 level, uint32 pigpio tick
+        UbxData = 2, //!< payload: raw bytes as read from the serial port
+        AdcSample = 3 //!< payload: uint8 channel, int32 value, float voltage, float lsb voltage
+    };
+    static constexpr char magic[8] { 'M', 'U', 'O', 'N', 'R', 'E', 'C', '\0' };
+    static constexpr std::uint16_t format_version { 1 };
+    static constexpr std::size_t record_header_size { sizeof(std::uint8_t) + sizeof(std::uint64_t) + sizeof(std::uint32_t) };
+
+    InputRecorder() = default;
+    ~InputRecorder();
+
+    auto open(const std::string& filename) -> bool;
+    void close();
+    [[nodiscard]] auto isOpen() const -> bool { return m_open.load(std::memory_order_relaxed); }
+    [[nodiscard]] auto recordCount() const -> std::uint64_t { return m_count.load(std::memory_order_relaxed); }
+
+    void recordGpioTick(unsigned int gpio, unsigned int level, std::uint32_t tick);
+    void recordUbxData(const char* data, std::size_t size);
+    void recordAdcSample(unsigned int channel, int value, float voltage, float lsb_voltage);
+
+private:
+    void write(RecordType type, const char* payload, std::uint32_t size);
+
+    std::ofstream m_file {};
+    std::mutex m_mutex {};
+    std::chrono::steady_clock::time_point m_start {};
+    std::atomic<bool> m_open { false };
+    std::atomic<std::uint64_t> m_count { 0 };
+};
+
+/**
+ * @brief Replays a capture file written by InputRecorder
+ * The records are emitted with their original relative timing scaled by the speed factor.
+ * A speed factor <= 0 replays the file as fast as possible, yielding to the event loop
+ * after each batch of records.
+ */
+class InputReplay : public QObject {
+    Q_OBJECT
+
+public:
+    InputReplay(const QString& filename, double speed = 1., QObject* parent = nullptr);
+    ~InputReplay() override = default;
+
+    [[nodiscard]] auto isValid() const -> bool { return m_valid; }
+    [[nodiscard]] auto recordCount() const -> std::uint64_t { return m_count; }
+
+signals:
+    void gpioTick(unsigned int gpio, unsigned int level, quint32 tick);
+    void ubxData(const QByteArray& data);
+    void adcSample(quint8 channel, int value, float voltage, float lsb_voltage);
+    void finished();
+
+public slots:
+    void start();
+    void stop();
+
+private slots:
+    void onTimeout();
+
+private:
+    static constexpr std::size_t c_max_speed_batch { 256 };
+
+    struct Record {
+        InputRecorder::RecordType type {};
+        std::uint64_t timestamp_ns { 0 };
+        std::string payload {};
+    };
+
+    auto readRecord(Record& record) -> bool;
+    void dispatch(const Record& record);
+    void scheduleNext();
+
+    std::ifstream m_file {};
+    double m_speed { 1. };
+    bool m_valid { false };
+    bool m_pending { false };
+    Record m_next {};
+    std::uint64_t m_count { 0 };
+    QElapsedTimer m_elapsed {};
+    QTimer m_timer {};
+};
+
+#endif // INPUTRECORDER_H
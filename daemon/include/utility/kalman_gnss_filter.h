@@ -1,45 +1,110 @@
 #ifndef KALMAN_GNSS_H
 #define KALMAN_GNSS_H
 
-#include <QObject>
-#include <QString>
+#include "utility/matrix.h"
+
 #include <chrono>
 #include <cmath>
+#include <cstddef>
 
+/**
+ * @brief Kalman filter for the receiver position and clock
+ * The state holds the position as local east, north and up offsets in meters w.r.t. the first fix,
+ * the receiver clock bias in ns and the clock drift in ns/s, with the full covariance matrix.
+ * It fuses the position solutions (NAV-POSLLH), the clock solutions (NAV-CLOCK) and the time pulse
+ * quantisation error (TIM-TP), whose observed variance is added to the noise of the clock bias measurements.
+ * All matrices are fixed size, the filter does not allocate and may run at the full navigation rate.
+ */
 class KalmanGnssFilter {
 public:
+    enum State : std::size_t {
+        East = 0,
+        North,
+        Up,
+        ClockBias,
+        ClockDrift,
+        StateSize
+    };
+
+    using StateVector = Matrix<StateSize, 1>;
+    using Covariance = Matrix<StateSize, StateSize>;
+
+    /**
+     * @brief correction of a receiver time stamp
+     * The receiver converts its local capture time into GNSS time with the clock bias of its latest
+     * navigation solution. offset_ns is the difference between that bias and the filtered one,
+     * extrapolated to the time of the event. It has to be added to the time stamp.
+     */
+    struct TimeCorrection {
+        double offset_ns { 0. };
+        double accuracy_ns { 0. }; //!< one standard deviation of the corrected time stamp w.r.t. the clock model
+        bool valid { false };
+    };
+
     KalmanGnssFilter() = delete;
     KalmanGnssFilter(double accuracy_decay = 1.);
 
-    /// <summary>
-    /// Kalman filter processing for lattitude and longitude
-    /// </summary>
-    /// <param name="lat_measurement_degrees">new measurement of lattitude</param>
-    /// <param name="lng_measurement">new measurement of longitude</param>
-    /// <param name="alt_measurement">new measurement of altitude</param>
-    /// <param name="accuracy">measurement of 1 standard deviation error in metres</param>
-    /// <returns>new state</returns>
-    void process(double lat_measurement, double lng_measurement, double alt_measurement, double accuracy);
+    /**
+     * @brief process a new position solution
+     * @param hor_accuracy, vert_accuracy one standard deviation error in metres
+     */
+    void process(double lat_measurement, double lng_measurement, double alt_measurement, double hor_accuracy, double vert_accuracy);
+    /**
+     * @brief process a new clock solution
+     * @param bias_accuracy_ns, drift_accuracy_ns_per_s one standard deviation error
+     */
+    void process_clock(double bias_ns, double drift_ns_per_s, double bias_accuracy_ns, double drift_accuracy_ns_per_s);
+    void process_quantization_error(double quantization_error_ns);
+
+    [[nodiscard]] auto time_correction(std::chrono::steady_clock::time_point time = std::chrono::steady_clock::now()) const -> TimeCorrection;
+
     [[nodiscard]] auto get_timestamp() const -> std::chrono::time_point<std::chrono::steady_clock> { return m_timestamp; }
-    [[nodiscard]] auto get_latitude() const -> double { return m_lat; }
-    [[nodiscard]] auto get_longitude() const -> double { return m_lng; }
-    [[nodiscard]] auto get_altitude() const -> double { return m_alt; }
-    [[nodiscard]] auto get_accuracy() const -> double { return std::sqrt(m_variance); }
-    [[nodiscard]] auto valid() const -> bool { return (m_variance >= 0.); }
+    [[nodiscard]] auto get_latitude() const -> double;
+    [[nodiscard]] auto get_longitude() const -> double;
+    [[nodiscard]] auto get_altitude() const -> double { return m_ref_alt + m_state[Up]; }
+    [[nodiscard]] auto get_hor_accuracy() const -> double { return std::sqrt(m_covariance(East, East) + m_covariance(North, North)); }
+    [[nodiscard]] auto get_vert_accuracy() const -> double { return std::sqrt(m_covariance(Up, Up)); }
+    [[nodiscard]] auto get_accuracy() const -> double { return std::hypot(get_hor_accuracy(), get_vert_accuracy()); }
+    [[nodiscard]] auto get_clock_bias() const -> double { return m_state[ClockBias]; }
+    [[nodiscard]] auto get_clock_drift() const -> double { return m_state[ClockDrift]; }
+    [[nodiscard]] auto get_state() const -> const StateVector& { return m_state; }
+    [[nodiscard]] auto get_covariance() const -> const Covariance& { return m_covariance; }
+    [[nodiscard]] auto valid() const -> bool { return m_position_valid; }
+    [[nodiscard]] auto clock_valid() const -> bool { return m_clock_updates >= c_min_clock_updates; }
     void reset();
+    void reset_position();
+    void reset_clock();
 
 private:
-    static constexpr double c_min_accuracy { 1. };
+    static constexpr double c_min_accuracy { 1. }; ///< lower limit of the position measurement error in m
+    static constexpr double c_min_clock_accuracy { 1. }; ///< lower limit of the clock bias measurement error in ns
+    static constexpr double c_clock_phase_noise { 1. }; ///< white frequency noise of the receiver oscillator in ns^2/s
+    static constexpr double c_clock_frequency_noise { 0.01 }; ///< random walk frequency noise in (ns/s)^2/s
+    static constexpr double c_clock_jump { 1000. }; ///< bias innovations above this (in ns) are treated as clock steering jumps
+    static constexpr double c_quantization_window { 100. }; ///< number of time pulses over which the quantisation variance is averaged
+    static constexpr std::size_t c_min_clock_updates { 10 };
+    static constexpr std::chrono::seconds c_max_clock_age { 10 };
+
+    void predict(std::chrono::steady_clock::time_point time);
+    template <std::size_t M>
+    void update(const Matrix<M, StateSize>& H, const Matrix<M, 1>& z, const Matrix<M, M>& R);
+
     double m_accuracy_decay { 1. }; ///< free parameter describing the decay of accuracy over time, unit: meters per second
 
     std::chrono::time_point<std::chrono::steady_clock> m_timestamp {};
-    double m_lat { 0. };
-    double m_lng { 0. };
-    double m_alt { 0. };
-
-    double m_variance; // P matrix.  Negative means object uninitialised.  NB: units irrelevant, as long as same units used throughout
+    StateVector m_state {};
+    Covariance m_covariance {};
+    bool m_position_valid { false };
+    double m_ref_lat { 0. };
+    double m_ref_lng { 0. };
+    double m_ref_alt { 0. };
 
-    void set_state(double lat, double lng, double alt, double accuracy);
+    std::size_t m_clock_updates { 0 };
+    double m_raw_bias { 0. }; ///< last clock bias as reported by the receiver
+    double m_raw_drift { 0. };
+    std::chrono::time_point<std::chrono::steady_clock> m_raw_clock_timestamp {};
+    double m_quantization_variance { 0. };
+    double m_quantization_weight { 0. };
 };
 
 #endif // KALMAN_GNSS_H
@@ -0,0 +1,136 @@
+#ifndef LATENCYTRACER_H
+#define LATENCYTRACER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Lightweight latency tracing of the event processing pipeline
+ * Each pipeline stage calls trace() which stores a monotonic timestamp in a lock-free
+ * single-producer ring buffer owned by the calling thread. collect() periodically drains
+ * all buffers, merges them in time order and pairs each stage with its predecessor stage
+ * in FIFO order. This is valid since every stage is executed in exactly one thread and the
+ * hand-over between stages happens through queued signals which preserve the order.
+ * Stages which may filter items must therefore only be traced for items which are passed on.
+ */
+class LatencyTracer {
+public:
+    enum class Stage : std::uint8_t {
+        GpioCallback = 0, //!< pigpio callback, right before the gpio signal is emitted
+        GpioDaemon, //!< gpio signal received in the daemon
+        UbxTimeMark, //!< TIM-TM2 message parsed in the gnss thread
+        TimeMarkDaemon, //!< time mark received in the daemon
+        EventMessage, //!< event string formatted and emitted
+        MqttPublish, //!< event handed to the mqtt client
+        FileWrite, //!< event written to the local data file
+        Count
+    };
+    static constexpr std::size_t stage_count { static_cast<std::size_t>(Stage::Count) };
+
+    struct Quantiles {
+        std::chrono::nanoseconds p50 { 0 };
+        std::chrono::nanoseconds p99 { 0 };
+        std::chrono::nanoseconds max { 0 };
+    };
+
+    struct StageStatistics {
+        Stage stage { Stage::Count };
+        std::size_t count { 0 };
+        Quantiles hop {}; //!< latency w.r.t. the preceding stage
+        Quantiles total {}; //!< latency w.r.t. the first stage of the chain
+    };
+
+    static auto instance() -> LatencyTracer&;
+
+    /**
+     * @brief record a trace point of the given stage for the calling thread
+     * wait-free, when the thread's buffer is full the entry is dropped and counted
+     */
+    static void trace(Stage stage) noexcept;
+
+    void setEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+    [[nodiscard]] auto isEnabled() const -> bool { return m_enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief drain all thread buffers and accumulate the stage latencies
+     * must be called from a single thread only
+     */
+    void collect();
+
+    /**
+     * @brief the statistics accumulated since the last reset, only stages with data are reported
+     */
+    [[nodiscard]] auto statistics(bool reset = true) -> std::vector<StageStatistics>;
+    [[nodiscard]] auto droppedCount() const -> std::uint64_t { return m_dropped.load(std::memory_order_relaxed); }
+
+    [[nodiscard]] static auto name(Stage stage) -> std::string;
+    [[nodiscard]] static constexpr auto predecessor(Stage stage) -> Stage
+    {
+        switch (stage) {
+        case Stage::GpioDaemon:
+            return Stage::GpioCallback;
+        case Stage::TimeMarkDaemon:
+            return Stage::UbxTimeMark;
+        case Stage::EventMessage:
+            return Stage::TimeMarkDaemon;
+        case Stage::MqttPublish:
+        case Stage::FileWrite:
+            return Stage::EventMessage;
+        default:
+            return Stage::Count;
+        }
+    }
+
+private:
+    static constexpr std::size_t c_buffer_size { 4096 }; //!< entries per thread, power of 2
+    static constexpr std::size_t c_max_pending { 1024 }; //!< max unmatched items per stage
+    static constexpr std::size_t c_max_samples { 65536 }; //!< max latency samples per stage and statistics period
+
+    struct Entry {
+        std::uint64_t t_ns;
+        Stage stage;
+    };
+
+    struct Item {
+        std::uint64_t t_ns; //!< time the item passed the preceding stage
+        std::uint64_t origin_ns; //!< time the item passed the first stage of the chain
+    };
+
+    class ThreadBuffer {
+    public:
+        auto push(const Entry& entry) noexcept -> bool;
+        template <typename F>
+        void drain(F&& consumer);
+
+    private:
+        std::array<Entry, c_buffer_size> m_ring {};
+        std::atomic<std::size_t> m_head { 0 };
+        std::atomic<std::size_t> m_tail { 0 };
+    };
+
+    LatencyTracer() = default;
+    auto threadBuffer() -> ThreadBuffer&;
+    void process(const Entry& entry);
+    static auto quantiles(std::vector<std::uint64_t>& samples) -> Quantiles;
+
+    std::atomic<bool> m_enabled { true };
+    std::atomic<std::uint64_t> m_dropped { 0 };
+    std::mutex m_registry_mutex {};
+    std::vector<std::shared_ptr<ThreadBuffer>> m_buffers {};
+
+    // only accessed from the collecting thread
+    std::vector<Entry> m_carry {};
+    std::array<std::deque<Item>, stage_count> m_pending {};
+    std::array<std::vector<std::uint64_t>, stage_count> m_hop_samples {};
+    std::array<std::vector<std::uint64_t>, stage_count> m_total_samples {};
+    std::array<std::size_t, stage_count> m_counts {};
+};
+
+#endif // LATENCYTRACER_H
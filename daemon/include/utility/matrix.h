@@ -0,0 +1,180 @@
+#ifndef MATRIX_H
+#define MATRIX_H
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <initializer_list>
+#include <utility>
+
+/**
+ * @brief Fixed size matrix without heap allocation for the small state-space filters
+ * The elements are stored contiguously in row major order. All loops run over compile time
+ * dimensions, so the compiler is free to unroll and vectorize them.
+ */
+template <std::size_t Rows, std::size_t Cols>
+class Matrix {
+public:
+    static constexpr std::size_t rows { Rows };
+    static constexpr std::size_t cols { Cols };
+
+    constexpr Matrix() = default;
+
+    /**
+     * @brief construct from the elements in row major order, missing elements are zero
+     */
+    constexpr Matrix(std::initializer_list<double> values)
+    {
+        std::size_t i { 0 };
+        for (auto value : values) {
+            if (i >= Rows * Cols) {
+                break;
+            }
+            m_data[i++] = value;
+        }
+    }
+
+    [[nodiscard]] static constexpr auto identity() -> Matrix
+    {
+        static_assert(Rows == Cols, "identity is only defined for square matrices");
+        Matrix result {};
+        for (std::size_t i = 0; i < Rows; i++) {
+            result(i, i) = 1.;
+        }
+        return result;
+    }
+
+    [[nodiscard]] static constexpr auto diagonal(const std::array<double, Rows>& values) -> Matrix
+    {
+        static_assert(Rows == Cols, "diagonal is only defined for square matrices");
+        Matrix result {};
+        for (std::size_t i = 0; i < Rows; i++) {
+            result(i, i) = values[i];
+        }
+        return result;
+    }
+
+    [[nodiscard]] constexpr auto operator()(std::size_t row, std::size_t col) -> double& { return m_data[row * Cols + col]; }
+    [[nodiscard]] constexpr auto operator()(std::size_t row, std::size_t col) const -> double { return m_data[row * Cols + col]; }
+    [[nodiscard]] constexpr auto operator[](std::size_t i) -> double& { return m_data[i]; }
+    [[nodiscard]] constexpr auto operator[](std::size_t i) const -> double { return m_data[i]; }
+
+    constexpr auto operator+=(const Matrix& other) -> Matrix&
+    {
+        for (std::size_t i = 0; i < Rows * Cols; i++) {
+            m_data[i] += other.m_data[i];
+        }
+        return *this;
+    }
+
+    constexpr auto operator-=(const Matrix& other) -> Matrix&
+    {
+        for (std::size_t i = 0; i < Rows * Cols; i++) {
+            m_data[i] -= other.m_data[i];
+        }
+        return *this;
+    }
+
+    constexpr auto operator*=(double factor) -> Matrix&
+    {
+        for (auto& value : m_data) {
+            value *= factor;
+        }
+        return *this;
+    }
+
+    [[nodiscard]] constexpr auto transposed() const -> Matrix<Cols, Rows>
+    {
+        Matrix<Cols, Rows> result {};
+        for (std::size_t r = 0; r < Rows; r++) {
+            for (std::size_t c = 0; c < Cols; c++) {
+                result(c, r) = (*this)(r, c);
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief invert a square matrix by Gauss-Jordan elimination with partial pivoting
+     * @param result the inverse, only valid if the method returned true
+     * @return false if the matrix is singular
+     */
+    [[nodiscard]] auto inverse(Matrix& result) const -> bool
+    {
+        static_assert(Rows == Cols, "inverse is only defined for square matrices");
+        Matrix a { *this };
+        result = identity();
+        for (std::size_t col = 0; col < Cols; col++) {
+            std::size_t pivot { col };
+            for (std::size_t r = col + 1; r < Rows; r++) {
+                if (std::abs(a(r, col)) > std::abs(a(pivot, col))) {
+                    pivot = r;
+                }
+            }
+            if (a(pivot, col) == 0.) {
+                return false;
+            }
+            if (pivot != col) {
+                for (std::size_t c = 0; c < Cols; c++) {
+                    std::swap(a(pivot, c), a(col, c));
+                    std::swap(result(pivot, c), result(col, c));
+                }
+            }
+            const double scale { 1. / a(col, col) };
+            for (std::size_t c = 0; c < Cols; c++) {
+                a(col, c) *= scale;
+                result(col, c) *= scale;
+            }
+            for (std::size_t r = 0; r < Rows; r++) {
+                if (r == col) {
+                    continue;
+                }
+                const double factor { a(r, col) };
+                for (std::size_t c = 0; c < Cols; c++) {
+                    a(r, c) -= factor * a(col, c);
+                    result(r, c) -= factor * result(col, c);
+                }
+            }
+        }
+        return true;
+    }
+
+private:
+    alignas(32) std::array<double, Rows * Cols> m_data {};
+};
+
+template <std::size_t Rows, std::size_t Cols>
+[[nodiscard]] constexpr auto operator+(Matrix<Rows, Cols> lhs, const Matrix<Rows, Cols>& rhs) -> Matrix<Rows, Cols>
+{
+    return lhs += rhs;
+}
+
+template <std::size_t Rows, std::size_t Cols>
+[[nodiscard]] constexpr auto operator-(Matrix<Rows, Cols> lhs, const Matrix<Rows, Cols>& rhs) -> Matrix<Rows, Cols>
+{
+    return lhs -= rhs;
+}
+
+template <std::size_t Rows, std::size_t Cols>
+[[nodiscard]] constexpr auto operator*(Matrix<Rows, Cols> lhs, double factor) -> Matrix<Rows, Cols>
+{
+    return lhs *= factor;
+}
+
+template <std::size_t Rows, std::size_t Inner, std::size_t Cols>
+[[nodiscard]] constexpr auto operator*(const Matrix<Rows, Inner>& lhs, const Matrix<Inner, Cols>& rhs) -> Matrix<Rows, Cols>
+{
+    // i-k-j order, the innermost loop runs over contiguous rows of rhs and result
+    Matrix<Rows, Cols> result {};
+    for (std::size_t i = 0; i < Rows; i++) {
+        for (std::size_t k = 0; k < Inner; k++) {
+            const double factor { lhs(i, k) };
+            for (std::size_t j = 0; j < Cols; j++) {
+                result(i, j) += factor * rhs(k, j);
+            }
+        }
+    }
+    return result;
+}
+
+#endif // MATRIX_H
@@ -10,11 +10,7 @@
 
 using namespace std::literals;
 
-constexpr double MAX_AVG_RATE { 100. };
-constexpr unsigned long MAX_BURST_MULTIPLICITY { 10 };
 constexpr std::chrono::microseconds MAX_BUFFER_TIME { 60s };
-constexpr std::chrono::microseconds MAX_DEADTIME { static_cast<unsigned long>(1e+6 / MAX_AVG_RATE) };
-constexpr std::chrono::microseconds DEADTIME_INCREMENT { 50 };
 
 class CounterRateBuffer : public QObject {
     Q_OBJECT
@@ -53,14 +49,15 @@ public:
         std::chrono::microseconds deadtime {};
     };
     */
+    /**
+     * @brief rate buffer for the events of one gpio
+     * The events are expected to be filtered already, see EventFilter.
+     */
     EventRateBuffer(unsigned int gpio, QObject* parent = nullptr);
     ~EventRateBuffer() = default;
-    void setRateLimit(double max_cps);
-    [[nodiscard]] auto currentRateLimit() const -> double { return fRateLimit; }
     void clear();
 
     [[nodiscard]] auto avgRate() const -> double;
-    [[nodiscard]] auto currentDeadtime() const -> std::chrono::microseconds;
     [[nodiscard]] auto lastInterval() const -> std::chrono::nanoseconds;
     [[nodiscard]] auto lastEventTime() const -> EventTime;
 
@@ -73,11 +70,9 @@ public slots:
     void onEvent(uint8_t gpio);
 
 private:
-    double fRateLimit { MAX_AVG_RATE };
     uint8_t m_gpio { 255 };
     std::chrono::microseconds m_buffer_time { MAX_BUFFER_TIME };
     std::queue<EventTime, std::list<EventTime>> m_eventbuffer {};
-    std::chrono::microseconds m_current_deadtime { 0 };
     std::chrono::nanoseconds m_last_interval { 0 };
     EventTime m_instance_start {};
 };
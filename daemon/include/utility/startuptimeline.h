@@ -0,0 +1,60 @@
+#ifndef STARTUPTIMELINE_H
+#define STARTUPTIMELINE_H
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Bookkeeping of the daemon start-up phases
+ * Phases may run concurrently, each one is started with begin() and ended with finish() or timeout().
+ * The times are given relative to the construction of the timeline.
+ * Not thread safe, all methods have to be called from the same thread.
+ */
+class StartupTimeline {
+public:
+    enum class State {
+        Running,
+        Finished,
+        Failed,
+        TimedOut
+    };
+
+    struct Phase {
+        std::string name {};
+        std::chrono::milliseconds begin {};
+        std::chrono::milliseconds end {};
+        State state { State::Running };
+
+        [[nodiscard]] auto duration() const -> std::chrono::milliseconds { return end - begin; }
+    };
+
+    StartupTimeline();
+
+    void begin(const std::string& name);
+    /**
+     * @brief ends the phase, a phase which already timed out keeps its state but gets the actual end time
+     */
+    void finish(const std::string& name, bool success = true);
+    /**
+     * @brief marks the phase as timed out, if it is still running
+     * @return true if the phase was still running
+     */
+    auto timeout(const std::string& name) -> bool;
+
+    [[nodiscard]] auto running(const std::string& name) const -> bool;
+    [[nodiscard]] auto complete() const -> bool; //!< true if no phase is running anymore
+    [[nodiscard]] auto elapsed() const -> std::chrono::milliseconds;
+    [[nodiscard]] auto phases() const -> const std::vector<Phase>& { return m_phases; }
+
+    [[nodiscard]] static auto state_string(State state) -> std::string;
+
+private:
+    [[nodiscard]] auto find(const std::string& name) -> Phase*;
+    [[nodiscard]] auto find(const std::string& name) const -> const Phase*;
+
+    std::chrono::steady_clock::time_point m_start {};
+    std::vector<Phase> m_phases {};
+};
+
+#endif // STARTUPTIMELINE_H
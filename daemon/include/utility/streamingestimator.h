@@ -0,0 +1,101 @@
+#ifndef STREAMINGESTIMATOR_H
+#define STREAMINGESTIMATOR_H
+
+#include <array>
+#include <cstddef>
+
+/**
+ * @brief P² estimator (Jain and Chlamtac) for a single quantile in constant memory
+ * Five markers track the minimum, the p/2, p, (1+p)/2 quantiles and the maximum.
+ * With a forgetting factor below 1 the marker positions decay, so the estimate follows
+ * a slowly changing distribution with an effective window of 1/(1-forgetting) samples.
+ */
+class P2Quantile {
+public:
+    explicit P2Quantile(double quantile = 0.5, double forgetting = 1.);
+
+    void add(double x);
+    void reset();
+
+    [[nodiscard]] auto value() const -> double;
+    [[nodiscard]] auto lower() const -> double; //!< estimate of the p/2 quantile
+    [[nodiscard]] auto upper() const -> double; //!< estimate of the (1+p)/2 quantile
+    [[nodiscard]] auto count() const -> std::size_t { return m_count; }
+
+private:
+    [[nodiscard]] auto parabolic(std::size_t i, double d) const -> double;
+    [[nodiscard]] auto linear(std::size_t i, double d) const -> double;
+
+    double m_p { 0.5 };
+    double m_forgetting { 1. };
+    std::array<double, 5> m_q {}; //!< marker heights
+    std::array<double, 5> m_n {}; //!< actual marker positions
+    std::array<double, 5> m_np {}; //!< desired marker positions
+    std::array<double, 5> m_dn {}; //!< increments of the desired positions
+    std::size_t m_count { 0 };
+};
+
+/**
+ * @brief exponentially weighted mean and variance with Huber clipping of outliers
+ * Residuals larger than clip standard deviations are clipped before they enter the estimate.
+ */
+class RobustMean {
+public:
+    explicit RobustMean(double forgetting = 1., double clip = 3.);
+
+    void add(double x);
+    void reset();
+
+    [[nodiscard]] auto value() const -> double { return m_mean; }
+    [[nodiscard]] auto stddev() const -> double;
+    [[nodiscard]] auto weight() const -> double { return m_weight; } //!< effective number of samples
+
+private:
+    double m_forgetting { 1. };
+    double m_clip { 3. };
+    double m_mean { 0. };
+    double m_variance { 0. };
+    double m_weight { 0. };
+};
+
+/**
+ * @brief streaming location and spread estimate of one coordinate, O(1) per sample
+ * The most probable value is approximated by the empirical relation mpv = 3 * median - 2 * mean.
+ * drift() is the displacement of the location estimate over the last drift_window samples,
+ * obtained from the exponentially averaged signed steps of the estimate. It is large while the
+ * estimate still moves and shrinks towards its statistical fluctuation once it has converged.
+ */
+class StreamingEstimator {
+public:
+    enum class Location {
+        Mean,
+        Median,
+        Mpv
+    };
+
+    /**
+     * @param window effective number of samples after which old samples are forgotten, 0 never forgets
+     * @param drift_window number of samples over which the drift of the estimate is measured
+     */
+    explicit StreamingEstimator(Location location = Location::Median, double window = 0., double drift_window = 1000.);
+
+    void add(double x);
+    void reset();
+    void set_location(Location location);
+
+    [[nodiscard]] auto value() const -> double;
+    [[nodiscard]] auto spread() const -> double; //!< robust standard deviation of the samples
+    [[nodiscard]] auto drift() const -> double;
+    [[nodiscard]] auto entries() const -> double { return m_mean.weight(); } //!< effective number of samples
+
+private:
+    Location m_location { Location::Median };
+    double m_forgetting { 1. };
+    double m_drift_window { 1000. };
+    P2Quantile m_median;
+    RobustMean m_mean;
+    double m_last_value { 0. };
+    double m_velocity { 0. };
+};
+
+#endif // STREAMINGESTIMATOR_H
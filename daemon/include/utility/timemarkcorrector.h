@@ -0,0 +1,95 @@
+#ifndef TIMEMARKCORRECTOR_H
+#define TIMEMARKCORRECTOR_H
+
+#include <ublox_structs.h>
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Correction stage for the TIM-TM2 time marks
+ * Every time mark is held back until the time pulse epochs (TIM-TP) and the clock solutions (NAV-CLOCK)
+ * on both sides of it are known. The time mark is then corrected by
+ * - the quantisation error (sawtooth) of the receiver tick grid, interpolated between the surrounding time pulses,
+ * - the difference between the clock bias interpolated between the surrounding clock solutions
+ *   and the bias the receiver extrapolated from the preceding solution with its drift.
+ * The clock correction needs time marks in GNSS time base, the quantisation correction pulses in the
+ * same time base as the marks. Time marks without bracketing data within max_delay are released
+ * with the corrections which are available at that time.
+ */
+class TimeMarkCorrector {
+public:
+    struct Result {
+        UbxTimeMarkStruct tm {}; //!< the corrected time mark, accuracy_ns holds the uncertainty
+        double quantization_ns { 0. }; //!< sawtooth correction, subtracted from the time stamps
+        double clock_ns { 0. }; //!< clock bias correction, subtracted from the time stamps
+        double uncertainty_ns { 0. }; //!< one standard deviation of the corrected time stamps
+        bool quantization_corrected { false };
+        bool clock_corrected { false };
+    };
+
+    explicit TimeMarkCorrector(std::chrono::milliseconds max_delay = std::chrono::milliseconds { 2500 });
+
+    /**
+     * @brief add the announcement of the next time pulse
+     * @param tow_sub_ms sub millisecond part of the time of week, scaled with 2^-32 ms
+     */
+    void add_time_pulse(std::uint16_t week, std::uint32_t tow_ms, std::uint32_t tow_sub_ms, std::int32_t quantization_error_ps, bool utc);
+    void add_clock(std::uint32_t tow_ms, std::int32_t bias_ns, std::int32_t drift_ns_per_s, std::uint32_t time_accuracy_ns);
+    void add_time_mark(const UbxTimeMarkStruct& tm);
+
+    /**
+     * @brief append the time marks which are ready to results, in order of their arrival
+     * @param flush release all pending time marks regardless of the available data
+     */
+    void take_ready(std::vector<Result>& results, bool flush = false);
+
+    [[nodiscard]] auto pending() const -> std::size_t { return m_pending.size(); }
+    [[nodiscard]] auto max_delay() const -> std::chrono::milliseconds { return m_max_delay; }
+    void reset();
+
+private:
+    struct PulseEpoch {
+        std::int64_t time_ns { 0 };
+        double quantization_ns { 0. };
+        bool utc { false };
+    };
+    struct ClockSolution {
+        std::int64_t time_ns { 0 };
+        double bias_ns { 0. };
+        double drift_ns_per_s { 0. };
+        double accuracy_ns { 0. };
+    };
+    struct PendingMark {
+        UbxTimeMarkStruct tm {};
+        std::chrono::steady_clock::time_point arrival {};
+    };
+
+    static constexpr std::size_t c_history { 8 }; ///< number of pulse epochs and clock solutions kept
+    static constexpr std::size_t c_max_pending { 4096 }; ///< time marks beyond this are released uncorrected
+    static constexpr std::int64_t c_max_bracket_ns { 2000000000 }; ///< max distance between two bracketing epochs
+    static constexpr double c_max_quantization_step { 10. }; ///< larger changes of the quantisation error between two pulses are wraps of the sawtooth, in ns
+    static constexpr double c_clock_jump { 1000. }; ///< larger deviations from the extrapolated bias are steering jumps of the receiver clock, in ns
+
+    [[nodiscard]] auto ready(const PendingMark& mark, std::chrono::steady_clock::time_point now) const -> bool;
+    [[nodiscard]] auto correct(const UbxTimeMarkStruct& tm) const -> Result;
+    [[nodiscard]] auto gnss_time(std::uint32_t tow_ms) const -> std::int64_t;
+
+    template <typename T>
+    [[nodiscard]] static auto bracket(const std::deque<T>& history, std::int64_t time) -> std::pair<const T*, const T*>;
+
+    std::chrono::milliseconds m_max_delay;
+    std::deque<PulseEpoch> m_pulses {};
+    std::deque<ClockSolution> m_clocks {};
+    std::deque<PendingMark> m_pending {};
+    std::uint16_t m_week { 0 };
+    std::uint32_t m_week_tow_ms { 0 }; //!< time of week of the pulse which defined m_week
+    bool m_week_valid { false };
+    std::chrono::steady_clock::time_point m_last_pulse_arrival {};
+    std::chrono::steady_clock::time_point m_last_clock_arrival {};
+};
+
+#endif // TIMEMARKCORRECTOR_H
@@ -0,0 +1,94 @@
+#ifndef UBXRATESCHEDULER_H
+#define UBXRATESCHEDULER_H
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+
+/**
+ * @brief Output rates of the periodic ubx messages derived from the demand of their consumers and the uart load
+ * Every consumer declares the rate it needs per message, the fastest declared rate wins
+ * and messages nobody asks for are switched off.
+ * Rates are given like in UBX-CFG-MSG, i.e. as number of navigation solutions per message.
+ * When the receiver TX buffer fills up or the estimated uart load exceeds its limit,
+ * all but the essential messages are throttled in steps of two, bulk messages twice as strong.
+ * A rate forced by the user overrides both the demand and the throttling.
+ */
+class UbxRateScheduler {
+public:
+    enum class Priority {
+        Essential, //!< never throttled
+        Normal,
+        Bulk //!< large messages, throttled with the square of the throttle factor
+    };
+
+    /**
+     * @param nav_rate navigation solutions per second
+     * @param baud_rate of the uart link to the receiver
+     */
+    void set_link(double nav_rate, std::uint32_t baud_rate);
+    /**
+     * @brief adds a message to the set of scheduled messages
+     * @param payload_size typical payload size in bytes, used for the load estimation
+     * @param event_driven the message is sent at most once per event, e.g. UBX-TIM-TM2
+     */
+    void add_message(std::uint16_t msg_id, Priority priority, std::size_t payload_size, bool event_driven = false);
+    /**
+     * @brief unsupported messages are switched off regardless of the demand
+     */
+    void set_supported(std::uint16_t msg_id, bool supported);
+    /**
+     * @brief declares the rate consumer needs for msg_id, a rate of 0 withdraws the demand
+     */
+    void declare(const std::string& consumer, std::uint16_t msg_id, std::uint8_t rate);
+    void withdraw(const std::string& consumer);
+    /**
+     * @brief forces the rate of msg_id regardless of the demand and the throttling, a rate of 0 switches it off
+     */
+    void force(std::uint16_t msg_id, std::uint8_t rate);
+    /**
+     * @brief feeds a new load measurement and adapts the throttling by at most one step
+     * @param tx_usage receiver TX buffer usage in %
+     * @param event_rate rate of event driven messages in Hz
+     */
+    void set_load(double tx_usage, double event_rate);
+
+    [[nodiscard]] auto rates() const -> std::map<std::uint16_t, std::uint8_t>;
+    /**
+     * @brief all rates, which are considered applied afterwards
+     */
+    [[nodiscard]] auto take_rates() -> std::map<std::uint16_t, std::uint8_t>;
+    /**
+     * @brief the rates which changed since they were last taken
+     */
+    [[nodiscard]] auto take_changes() -> std::map<std::uint16_t, std::uint8_t>;
+    [[nodiscard]] auto throttle() const -> unsigned int;
+    /**
+     * @brief estimated fraction of the uart capacity used by the scheduled messages
+     */
+    [[nodiscard]] auto uart_load() const -> double;
+
+private:
+    struct Message {
+        Priority priority { Priority::Normal };
+        std::size_t payload_size { 0 };
+        bool event_driven { false };
+        bool supported { true };
+        std::optional<std::uint8_t> forced {};
+        std::map<std::string, std::uint8_t> demand {};
+    };
+
+    [[nodiscard]] auto rate(const Message& message, unsigned int throttle) const -> std::uint8_t;
+    [[nodiscard]] auto uart_load(unsigned int throttle) const -> double;
+
+    double m_nav_rate { 1. };
+    double m_uart_capacity { 960. }; //!< bytes per second
+    double m_tx_usage { 0. };
+    double m_event_rate { 0. };
+    unsigned int m_throttle { 1 };
+    std::map<std::uint16_t, Message> m_messages {};
+    std::map<std::uint16_t, std::uint8_t> m_applied {};
+};
+
+#endif // UBXRATESCHEDULER_H
@@ -0,0 +1,85 @@
+#ifndef UBXVALCONFIG_H
+#define UBXVALCONFIG_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief configuration keys of the u-blox key-value interface (protocol version 27 and newer)
+ * The size of the value is encoded in bits 28..30 of the key.
+ */
+namespace UbxCfgKey {
+constexpr std::uint32_t RATE_MEAS { 0x30210001 }; //!< measurement interval in ms
+constexpr std::uint32_t RATE_NAV { 0x30210002 }; //!< measurements per navigation solution
+constexpr std::uint32_t NAVSPG_DYNMODEL { 0x20110021 };
+constexpr std::uint32_t NAVSPG_INFIL_MINSVS { 0x201100a1 };
+constexpr std::uint32_t NAVSPG_INFIL_MAXSVS { 0x201100a2 };
+constexpr std::uint32_t NAVSPG_INFIL_MINCNO { 0x201100a3 };
+constexpr std::uint32_t ANA_USE_ANA { 0x10230001 }; //!< AssistNow Autonomous
+constexpr std::uint32_t UART1_BAUDRATE { 0x40520001 };
+constexpr std::uint32_t UART1INPROT_UBX { 0x10730001 };
+constexpr std::uint32_t UART1INPROT_NMEA { 0x10730002 };
+constexpr std::uint32_t UART1OUTPROT_UBX { 0x10740001 };
+constexpr std::uint32_t UART1OUTPROT_NMEA { 0x10740002 };
+}
+
+/**
+ * @brief Set of configuration items for UBX-CFG-VALSET and UBX-CFG-VALGET
+ * The items are kept in the order they were set, setting a key twice replaces the value.
+ * The payloads are split such that no message exceeds max_keys_per_message items,
+ * a set spanning more than one message is applied as a single transaction.
+ */
+class UbxValConfig {
+public:
+    enum Layer : std::uint8_t {
+        RAM = 0x01,
+        BBR = 0x02,
+        FLASH = 0x04
+    };
+
+    struct Item {
+        std::uint32_t key { 0 };
+        std::uint64_t value { 0 };
+    };
+
+    static constexpr std::size_t max_keys_per_message { 64 };
+
+    void set(std::uint32_t key, std::uint64_t value);
+    /**
+     * @brief sets the output rate of a ubx message on the uart
+     * @return false if the message has no configuration key
+     */
+    auto set_msg_rate(std::uint16_t msg_id, std::uint8_t rate) -> bool;
+
+    [[nodiscard]] auto items() const -> const std::vector<Item>&;
+    [[nodiscard]] auto empty() const -> bool;
+
+    /**
+     * @brief payloads of the UBX-CFG-VALSET messages writing all items to the given layers
+     */
+    [[nodiscard]] auto valset_payloads(std::uint8_t layers) const -> std::vector<std::string>;
+    /**
+     * @brief payloads of the UBX-CFG-VALGET messages polling all keys from the RAM layer
+     */
+    [[nodiscard]] auto valget_payloads() const -> std::vector<std::string>;
+    /**
+     * @brief decodes the key-value pairs of a UBX-CFG-VALGET response
+     */
+    [[nodiscard]] static auto parse_valget(const std::string& payload) -> std::vector<Item>;
+
+    [[nodiscard]] static auto value_size(std::uint32_t key) -> std::size_t;
+    /**
+     * @brief key of the output rate on the uart for msg_id, 0 if there is none
+     */
+    [[nodiscard]] static auto msg_rate_key(std::uint16_t msg_id) -> std::uint32_t;
+    /**
+     * @brief the ubx message belonging to an output rate key, 0 for any other key
+     */
+    [[nodiscard]] static auto msg_id_from_key(std::uint32_t key) -> std::uint16_t;
+
+private:
+    std::vector<Item> m_items {};
+};
+
+#endif // UBXVALCONFIG_H
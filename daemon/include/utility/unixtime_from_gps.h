@@ -1,21 +1,162 @@
 #ifndef UNIXTIME_FROM_GPS_H
 #define UNIXTIME_FROM_GPS_H
 
-#include <QDateTime>
+#include <array>
 #include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <limits>
 
-static timespec unixtime_from_gps(int week_nr, long int s_of_week, long int ns)
+namespace GpsTime {
+constexpr std::int64_t epoch_unix_seconds { 315964800 }; //!< 1980-01-06 00:00:00 UTC
+constexpr std::int64_t seconds_per_week { 7 * 24 * 3600 };
+constexpr std::int64_t ns_per_second { 1000000000 };
+
+/**
+ * @brief days since 1970-01-01 of a date in the proleptic gregorian calendar
+ */
+constexpr auto days_from_civil(std::int64_t year, unsigned month, unsigned day) -> std::int64_t
+{
+    year -= (month <= 2);
+    const std::int64_t era { (year >= 0 ? year : year - 399) / 400 };
+    const auto yoe { static_cast<unsigned>(year - era * 400) };
+    const unsigned doy { (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1 };
+    const unsigned doe { yoe * 365 + yoe / 4 - yoe / 100 + doy };
+    return era * 146097 + static_cast<std::int64_t>(doe) - 719468;
+}
+
+/**
+ * @brief nanoseconds since the unix epoch of a GPS time given as week, second of week and nanoseconds
+ * ns may be negative or exceed one second. With leap_seconds = 0 the result is on the GPS time scale.
+ */
+constexpr auto to_unix_ns(std::int64_t week_nr, std::int64_t s_of_week, std::int64_t ns, std::int64_t leap_seconds = 0) -> std::int64_t
 {
-    QDateTime gpsTimeStart(QDate(1980, 1, 6), QTime(0, 0, 0, 0), Qt::UTC);
-    quint64 gpsOffsetToEpoch = gpsTimeStart.toMSecsSinceEpoch() / 1000;
-    quint64 secs = gpsOffsetToEpoch;
-    secs += week_nr * 7 * 24 * 3600; // 7 days per week, 24 hours per day and 3600 seconds per hour
-    secs += s_of_week;
-    struct timespec ts;
-    ts.tv_sec = secs;
-    ts.tv_nsec = ns;
+    return (epoch_unix_seconds + week_nr * seconds_per_week + s_of_week - leap_seconds) * ns_per_second + ns;
+}
 
+/**
+ * @brief split nanoseconds since the epoch into a normalised timespec, rounding towards -inf
+ */
+constexpr auto to_timespec(std::int64_t unix_ns) -> timespec
+{
+    std::int64_t sec { unix_ns / ns_per_second };
+    std::int64_t nsec { unix_ns % ns_per_second };
+    // branch free floor division, the comparison evaluates to 0 or 1
+    const std::int64_t negative { nsec < 0 };
+    sec -= negative;
+    nsec += negative * ns_per_second;
+    timespec ts {};
+    ts.tv_sec = static_cast<time_t>(sec);
+    ts.tv_nsec = static_cast<long>(nsec);
     return ts;
 }
 
+/**
+ * @brief GPS time of a leap second insertion at the start of the UTC day year-month-01
+ * @param offset_before leap second offset GPS - UTC before the insertion
+ */
+constexpr auto leap_second_insertion(std::int64_t year, unsigned month, std::int64_t offset_before) -> std::int64_t
+{
+    return days_from_civil(year, month, 1) * 86400 - epoch_unix_seconds + offset_before + 1;
+}
+
+/**
+ * @brief leap second offset GPS - UTC
+ * The built-in table holds all leap seconds up to the date of this release. The receiver reports the
+ * current offset in NAV-TIMEGPS and NAV-TIMEUTC. A larger one than the table knows is a leap second
+ * introduced later and is taken over from the time it was reported.
+ */
+class LeapSecondTable {
+public:
+    /**
+     * @param gps_seconds seconds since the GPS epoch
+     */
+    [[nodiscard]] constexpr auto offset(std::int64_t gps_seconds) const -> int
+    {
+        return table_offset(gps_seconds) + static_cast<int>(gps_seconds >= m_reported_since) * m_reported_extra;
+    }
+
+    /**
+     * @brief take over the offset reported by the receiver
+     * @param gps_seconds time of the report in seconds since the GPS epoch
+     */
+    constexpr void update(std::int64_t gps_seconds, int leap_seconds)
+    {
+        const int extra { leap_seconds - table_offset(gps_seconds) };
+        if (extra > m_reported_extra) {
+            m_reported_extra = extra;
+            m_reported_since = gps_seconds;
+        }
+    }
+
+    [[nodiscard]] constexpr auto latest() const -> int { return offset(std::numeric_limits<std::int64_t>::max()); }
+
+private:
+    [[nodiscard]] static constexpr auto table_offset(std::int64_t gps_seconds) -> int
+    {
+        int result { 0 };
+        for (const auto since : c_insertions) {
+            result += static_cast<int>(gps_seconds >= since);
+        }
+        return result;
+    }
+
+    static constexpr std::array<std::int64_t, 18> c_insertions {
+        leap_second_insertion(1981, 7, 0), leap_second_insertion(1982, 7, 1), leap_second_insertion(1983, 7, 2), leap_second_insertion(1985, 7, 3),
+        leap_second_insertion(1988, 1, 4), leap_second_insertion(1990, 1, 5), leap_second_insertion(1991, 1, 6), leap_second_insertion(1992, 7, 7),
+        leap_second_insertion(1993, 7, 8), leap_second_insertion(1994, 7, 9), leap_second_insertion(1996, 1, 10), leap_second_insertion(1997, 7, 11),
+        leap_second_insertion(1999, 1, 12), leap_second_insertion(2006, 1, 13), leap_second_insertion(2009, 1, 14), leap_second_insertion(2012, 7, 15),
+        leap_second_insertion(2015, 7, 16), leap_second_insertion(2017, 1, 17)
+    };
+
+    std::int64_t m_reported_since { std::numeric_limits<std::int64_t>::max() };
+    int m_reported_extra { 0 };
+};
+
+static_assert(days_from_civil(2017, 1, 1) * 86400 == 1483228800);
+static_assert(to_timespec(-1).tv_sec == -1 && to_timespec(-1).tv_nsec == 999999999);
+static_assert(to_timespec(-ns_per_second).tv_sec == -1 && to_timespec(-ns_per_second).tv_nsec == 0);
+static_assert(to_timespec(1500000000).tv_sec == 1 && to_timespec(1500000000).tv_nsec == 500000000);
+// both sides of the leap second at the end of 2016: 23:59:60 UTC still has the old offset
+static_assert(LeapSecondTable {}.offset(leap_second_insertion(2017, 1, 17) - 1) == 17);
+static_assert(LeapSecondTable {}.offset(leap_second_insertion(2017, 1, 17)) == 18);
+static_assert(LeapSecondTable {}.offset(leap_second_insertion(1981, 7, 0) - 1) == 0);
+static_assert(LeapSecondTable {}.latest() == 18);
+// a leap second unknown to the table is taken over from the time it was reported
+static_assert([] {
+    constexpr std::int64_t reported { leap_second_insertion(2030, 1, 18) };
+    LeapSecondTable table {};
+    table.update(reported, 19);
+    return table.offset(reported - 1) == 18 && table.offset(reported) == 19 && table.latest() == 19;
+}());
+}
+
+/**
+ * @brief convert a GPS time to a timespec on the unix time axis
+ * Without leap seconds the result stays on the GPS time scale, as the event time stamps always did.
+ */
+constexpr auto unixtime_from_gps(std::int64_t week_nr, std::int64_t s_of_week, std::int64_t ns, std::int64_t leap_seconds = 0) -> timespec
+{
+    return GpsTime::to_timespec(GpsTime::to_unix_ns(week_nr, s_of_week, ns, leap_seconds));
+}
+
+// the 10 bit week number rolled over on 1999-08-22 and 2019-04-07, the full week number continues across
+static_assert(unixtime_from_gps(1023, GpsTime::seconds_per_week - 1, 0).tv_sec + 1 == unixtime_from_gps(1024, 0, 0).tv_sec);
+static_assert(unixtime_from_gps(1024, 0, 0).tv_sec == GpsTime::days_from_civil(1999, 8, 22) * 86400);
+static_assert(unixtime_from_gps(2048, 0, 0).tv_sec == GpsTime::days_from_civil(2019, 4, 7) * 86400);
+static_assert(unixtime_from_gps(2047, GpsTime::seconds_per_week, 0).tv_sec == unixtime_from_gps(2048, 0, 0).tv_sec);
+// a negative sub-second part borrows from the previous week
+static_assert(unixtime_from_gps(2048, 0, -1).tv_sec == unixtime_from_gps(2047, GpsTime::seconds_per_week - 1, 0).tv_sec);
+static_assert(unixtime_from_gps(2048, 0, -1).tv_nsec == 999999999);
+static_assert(unixtime_from_gps(2048, 0, 0, 18).tv_sec == GpsTime::days_from_civil(2019, 4, 7) * 86400 - 18);
+
+/**
+ * @brief convert a GPS time to a std::chrono time point of the system clock
+ */
+constexpr auto unixtime_from_gps_chrono(std::int64_t week_nr, std::int64_t s_of_week, std::int64_t ns, std::int64_t leap_seconds = 0)
+    -> std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds>
+{
+    return std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds> { std::chrono::nanoseconds { GpsTime::to_unix_ns(week_nr, s_of_week, ns, leap_seconds) } };
+}
+
 #endif // UNIXTIME_FROM_GPS_H
@@ -10,6 +10,7 @@
 #include <Qt>
 #include <QtGlobal>
 #include <QtNetwork>
+#include <algorithm>
 #include <chrono>
 #include <config.h>
 #include <daemon.h>
@@ -49,6 +50,36 @@ static QVector<uint16_t> allMsgCfgID({ UBX_MSG::TIM_TM2, UBX_MSG::TIM_TP,
     UBX_MSG::MON_HW, UBX_MSG::MON_HW2, UBX_MSG::MON_IO, UBX_MSG::MON_MSGPP,
     UBX_MSG::MON_RXBUF, UBX_MSG::MON_RXR, UBX_MSG::MON_TXBUF });
 
+// periodic ubx messages handled by the rate scheduler
+// the daemon rate is what the daemon needs for logging and time keeping,
+// the client rate is requested as long as at least one client is connected
+struct ScheduledUbxMsg {
+    uint16_t msgID;
+    UbxRateScheduler::Priority priority;
+    std::size_t payloadSize;
+    bool eventDriven;
+    uint8_t daemonRate;
+    uint8_t clientRate;
+};
+static const std::vector<ScheduledUbxMsg> scheduledUbxMsgs({
+    { UBX_MSG::TIM_TM2, UbxRateScheduler::Priority::Essential, 28, true, 1, 1 },
+    { UBX_MSG::TIM_TP, UbxRateScheduler::Priority::Normal, 16, false, 0, 0 },
+    { UBX_MSG::NAV_TIMEUTC, UbxRateScheduler::Priority::Normal, 20, false, 131, 131 },
+    { UBX_MSG::MON_HW, UbxRateScheduler::Priority::Normal, 60, false, 255, 47 },
+    { UBX_MSG::MON_HW2, UbxRateScheduler::Priority::Normal, 28, false, 255, 49 },
+    { UBX_MSG::NAV_POSLLH, UbxRateScheduler::Priority::Normal, 28, false, 127, 127 },
+    { UBX_MSG::NAV_TIMEGPS, UbxRateScheduler::Priority::Normal, 16, false, 0, 0 },
+    { UBX_MSG::NAV_SOL, UbxRateScheduler::Priority::Normal, 52, false, 0, 0 },
+    { UBX_MSG::NAV_STATUS, UbxRateScheduler::Priority::Normal, 16, false, 71, 71 },
+    { UBX_MSG::NAV_CLOCK, UbxRateScheduler::Priority::Normal, 20, false, 189, 189 },
+    { UBX_MSG::MON_RXBUF, UbxRateScheduler::Priority::Normal, 24, false, 255, 53 },
+    { UBX_MSG::MON_TXBUF, UbxRateScheduler::Priority::Essential, 28, false, 51, 51 }, // measures the uart load
+    { UBX_MSG::NAV_SBAS, UbxRateScheduler::Priority::Bulk, 12, false, 0, 0 },
+    { UBX_MSG::NAV_DOP, UbxRateScheduler::Priority::Normal, 18, false, 254, 254 },
+    { UBX_MSG::NAV_SAT, UbxRateScheduler::Priority::Bulk, 368, false, 255, 69 },
+    { UBX_MSG::NAV_SVINFO, UbxRateScheduler::Priority::Bulk, 368, false, 255, 69 } });
+static constexpr int gnssMeasRate { 10 }; //!< navigation solutions per second
+
 // signal handling stuff: put code to execute before shutdown down there
 static int setup_unix_signal_handlers()
 {
@@ -202,6 +233,7 @@ Daemon::Daemon(configuration cfg, QObject* parent)
     // try to find out on which hardware version we are running
     // for this to work, we have to initialize and read the eeprom first
     // EEPROM 24AA02 type
+    m_startup.begin("eeprom");
     std::shared_ptr<EEPROM24AA02> eep24aa02_p;
     std::set<uint8_t> possible_addresses { 0x50 };
     auto found_dev_addresses = findI2cDeviceType<EEPROM24AA02>(possible_addresses);
@@ -241,14 +273,16 @@ Daemon::Daemon(configuration cfg, QObject* parent)
         hwIdStr = "0x" + hwIdStr;
         qInfo() << "EEP unique ID:" << hwIdStr;
     }
-    CalibStruct verStruct = calib->getCalibItem("VERSION");
-    unsigned int version = 0;
-    ShowerDetectorCalib::getValueFromString(verStruct.value, version);
+    calib->setChangeHandler([this](ShowerDetectorCalib::Item) { logCalibParameters(); });
+    logCalibParameters();
+    const unsigned int version = static_cast<unsigned int>(calib->value(ShowerDetectorCalib::Item::Version));
     if (version > 0) {
         MuonPi::Version::hardware.major = version;
         qInfo() << "Found HW version" << MuonPi::Version::hardware.major << "in eeprom";
     }
 
+    m_startup.finish("eeprom", eep_p != nullptr);
+
     // set up the pin definitions (hw version specific)
     GPIO_PINMAP = GPIO_PINMAP_VERSIONS[MuonPi::Version::hardware.major];
 
@@ -314,7 +348,59 @@ Daemon::Daemon(configuration cfg, QObject* parent)
     // connect the once-log flag reset slot of log engine with the logRotate signal of filehandler
     connect(fileHandler, &FileHandler::logRotateSignal, &logEngine, &LogEngine::onOnceLogTrigger);
 
+    // set up histograms
+    setupHistos();
+    setupTcpDispatcher();
+    setupUbxRateScheduler();
+
+    // open the capture file for recording of the raw input streams, if requested
+    if (!config.capture_file.isEmpty()) {
+        m_input_recorder = std::make_shared<InputRecorder>();
+        if (m_input_recorder->open(config.capture_file.toStdString())) {
+            qInfo() << "recording raw input streams to" << config.capture_file;
+        } else {
+            m_input_recorder.reset();
+        }
+    }
+
+    // the hardware interfaces which do not depend on each other are started first, so that the gpio event acquisition
+    // and the gnss module connection are set up in their threads while the i2c devices are probed here.
+    // The acquisition stays inhibited until the thresholds are applied at the end of the i2c phase.
+    // connect to the pigpio daemon interface for gpio control
+    beginStartupPhase("pigpiod", Config::Startup::pigpiod_timeout);
+    connectToPigpiod();
+
+    // set up rate buffers for all GPIO input signals
+    for (auto [signal, pin] : GPIO_PINMAP) {
+        if (GPIO_SIGNAL_MAP.at(signal).direction == DIR_IN) {
+            auto ratebuf = std::make_shared<EventRateBuffer>(pin);
+            connect(pigHandler, &PigpiodHandler::signal, ratebuf.get(), &EventRateBuffer::onEvent);
+            // connect(&ratebuf, &EventRateBuffer::filteredEvent, this, &Daemon::sendGpioPinEvent);
+            m_gpio_ratebuffers.emplace(pin, ratebuf);
+        }
+    }
+
+    // establish ublox gnss module connection
+    if (!config.gpsdevname.isEmpty()) {
+        beginStartupPhase("gnss", Config::Startup::gnss_timeout);
+    }
+    connectToGps();
+
+    // set up rate buffer for ublox counter
+    m_ublox_ratebuffer = std::make_shared<CounterRateBuffer>(std::numeric_limits<std::uint16_t>::max());
+    connect(qtGps, &QtSerialUblox::UBXReceivedTimeTM2, this, [this](const UbxTimeMarkStruct& tm) {
+        this->m_ublox_ratebuffer->onCounterValue(tm.evtCounter);
+    });
+
+    // configure the ublox module with preset ubx messages, if required
+    if (config.gnss_config) {
+        configGps();
+    }
+    pollAllUbxMsgRate();
+
     // instantiate, detect and initialize all other i2c devices
+    // the bus is accessed from this thread only, so the device probes are serialized
+    m_startup.begin("i2c");
 
     // MIC184 or LM75 temp sensor
     possible_addresses = { 0x48, 0x49, 0x4a, 0x4b, 0x4c, 0x4d, 0x4e, 0x4f };
@@ -534,6 +620,7 @@ Daemon::Daemon(configuration cfg, QObject* parent)
 #endif
         }
         oled_p->begin();
+        oled_p->setTransferChunkSize(Config::Hardware::OLED::transfer_chunk_size);
         oled_p->clearDisplay();
 
         // text display tests
@@ -572,6 +659,11 @@ Daemon::Daemon(configuration cfg, QObject* parent)
             dynamic_cast<i2cDevice*>(temp_sensor_p.get())->getCapabilities();
     }
 
+    finishStartupPhase("i2c", dac_p != nullptr);
+    if (pigHandler != nullptr) {
+        pigHandler->setInhibited(false);
+    }
+
     if (config.serverAddress.isEmpty()) {
         // if not otherwise specified: listen on all available addresses
         daemonAddress = QHostAddress(QHostAddress::Any);
@@ -598,37 +690,6 @@ Daemon::Daemon(configuration cfg, QObject* parent)
     // create network discovery service
     networkDiscovery = new NetworkDiscovery(NetworkDiscovery::DeviceType::DAEMON, daemonPort, this);
 
-    // connect to the pigpio daemon interface for gpio control
-    connectToPigpiod();
-
-    // set up rate buffers for all GPIO input signals
-    for (auto [signal, pin] : GPIO_PINMAP) {
-        if (GPIO_SIGNAL_MAP.at(signal).direction == DIR_IN) {
-            auto ratebuf = std::make_shared<EventRateBuffer>(pin);
-            connect(pigHandler, &PigpiodHandler::signal, ratebuf.get(), &EventRateBuffer::onEvent);
-            // connect(&ratebuf, &EventRateBuffer::filteredEvent, this, &Daemon::sendGpioPinEvent);
-            m_gpio_ratebuffers.emplace(pin, ratebuf);
-        }
-    }
-
-    // set up histograms
-    setupHistos();
-
-    // establish ublox gnss module connection
-    connectToGps();
-
-    // set up rate buffer for ublox counter
-    m_ublox_ratebuffer = std::make_shared<CounterRateBuffer>(std::numeric_limits<std::uint16_t>::max());
-    connect(qtGps, &QtSerialUblox::UBXReceivedTimeTM2, this, [this](const UbxTimeMarkStruct& tm) {
-        this->m_ublox_ratebuffer->onCounterValue(tm.evtCounter);
-    });
-
-    // configure the ublox module with preset ubx messages, if required
-    if (config.gnss_config) {
-        configGps();
-    }
-    pollAllUbxMsgRate();
-
     // set up cyclic timer monitoring following operational parameters:
     // temp, vadc, vbias, ibias
     parameterMonitorTimer.setInterval(Config::Hardware::monitor_interval);
@@ -636,6 +697,17 @@ Daemon::Daemon(configuration cfg, QObject* parent)
     connect(&parameterMonitorTimer, &QTimer::timeout, this, &Daemon::aquireMonitoringParameters);
     parameterMonitorTimer.start();
 
+    // periodically drain the latency trace buffers of all pipeline threads
+    latencyCollectTimer.setInterval(Config::Latency::collect_interval);
+    latencyCollectTimer.setSingleShot(false);
+    connect(&latencyCollectTimer, &QTimer::timeout, this, []() { LatencyTracer::instance().collect(); });
+    latencyCollectTimer.start();
+
+    // releases the held back time marks, if the data for their correction does not arrive
+    timeMarkReleaseTimer.setInterval(m_time_mark_corrector.max_delay());
+    timeMarkReleaseTimer.setSingleShot(true);
+    connect(&timeMarkReleaseTimer, &QTimer::timeout, this, [this]() { releaseTimeMarks(); });
+
     emit logParameter(LogParameter("maxGeohashLength", QString::number(config.maxGeohashLength), LogParameter::LOG_ONCE));
     emit logParameter(LogParameter("softwareVersionString", QString::fromStdString(MuonPi::Version::software.string()), LogParameter::LOG_ONCE));
     emit logParameter(LogParameter("hardwareVersionString", QString::fromStdString(MuonPi::Version::hardware.string()), LogParameter::LOG_ONCE));
@@ -643,6 +715,72 @@ Daemon::Daemon(configuration cfg, QObject* parent)
     m_geopos_manager.set_lockin_ready_callback(std::bind(&Daemon::onGeoPosLockInReady, this, std::placeholders::_1));
     m_geopos_manager.set_valid_pos_callback(std::bind(&Daemon::onGeoPosValid, this, std::placeholders::_1));
     m_geopos_manager.set_mode_config(config.position_mode_config);
+
+    if (!config.replay_file.isEmpty()) {
+        setupInputReplay();
+    }
+}
+
+void Daemon::beginStartupPhase(const std::string& name, std::chrono::milliseconds timeout)
+{
+    m_startup.begin(name);
+    QTimer::singleShot(timeout, this, [this, name, timeout]() {
+        if (m_startup.timeout(name)) {
+            qWarning() << "start-up phase" << QString::fromStdString(name) << "did not finish within" << timeout.count() << "ms";
+            finishStartupPhase(name, false);
+        }
+    });
+}
+
+void Daemon::finishStartupPhase(const std::string& name, bool success)
+{
+    m_startup.finish(name, success);
+    if (m_startup_reported || !m_startup.complete()) {
+        return;
+    }
+    m_startup_reported = true;
+    std::chrono::milliseconds total {};
+    for (const auto& phase : m_startup.phases()) {
+        qInfo().nospace() << "start-up phase " << QString::fromStdString(phase.name) << ": " << phase.begin.count() << " ms .. "
+                          << phase.end.count() << " ms (" << QString::fromStdString(StartupTimeline::state_string(phase.state)) << ")";
+        emit logParameter(LogParameter("startup_" + QString::fromStdString(phase.name), QString::number(phase.duration().count()) + " ms", LogParameter::LOG_ONCE));
+        total = std::max(total, phase.end);
+    }
+    emit logParameter(LogParameter("startupDuration", QString::number(total.count()) + " ms", LogParameter::LOG_ONCE));
+}
+
+void Daemon::setupInputReplay()
+{
+    m_input_replay = new InputReplay(config.replay_file, config.replay_speed, this);
+    if (!m_input_replay->isValid()) {
+        qCritical() << "replay of" << config.replay_file << "not possible";
+        return;
+    }
+    // mute the live inputs and feed the recorded streams into the processing chain instead
+    if (!pigHandler.isNull()) {
+        pigHandler->setReplayMode(true);
+        connect(m_input_replay, &InputReplay::gpioTick, pigHandler, &PigpiodHandler::injectTick);
+        // replayed ticks must not trigger conversions of the live ADC
+        disconnect(pigHandler, &PigpiodHandler::samplingTrigger, this, &Daemon::sampleAdc0Event);
+    }
+    if (!qtGps.isNull()) {
+        qtGps->setReplayMode(true);
+        connect(m_input_replay, &InputReplay::ubxData, qtGps, &QtSerialUblox::injectRawData);
+    }
+    if (adc_p) {
+        // conversions of the bias readout would otherwise show up between the replayed samples
+        adc_p->registerConversionReadyCallback({});
+    }
+    connect(m_input_replay, &InputReplay::adcSample, this, [this](quint8 channel, int value, float voltage, float lsb_voltage) {
+        onAdcSampleReady(ADS1115::Sample { std::chrono::steady_clock::now(), value, voltage, lsb_voltage, channel });
+    });
+    connect(m_input_replay, &InputReplay::finished, this, [this]() {
+        qInfo() << "replay of" << config.replay_file << "finished," << m_input_replay->recordCount() << "records processed";
+    });
+    // the replayed time marks start over, nothing of the live history may leak into the analysis
+    resetEventAnalysis();
+    qInfo() << "replaying raw input streams from" << config.replay_file << "at speed factor" << config.replay_speed;
+    QTimer::singleShot(0, m_input_replay, &InputReplay::start);
 }
 
 void Daemon::onGeoPosLockInReady(GeoPosition pos)
@@ -719,7 +857,22 @@ void Daemon::connectToPigpiod()
 {
     const QVector<unsigned int> gpio_pins({ GPIO_PINMAP[EVT_AND], GPIO_PINMAP[EVT_XOR],
         GPIO_PINMAP[TIMEPULSE], GPIO_PINMAP[EXT_TRIGGER] });
-    pigHandler = new PigpiodHandler(gpio_pins);
+    EventFilter::Config filter_config {};
+    filter_config.channels = { GPIO_PINMAP[EVT_AND], GPIO_PINMAP[EVT_XOR] };
+    // an AND edge requires one of the inputs to fire first, which raises the XOR line
+    filter_config.coincidences = { { GPIO_PINMAP[EVT_AND], GPIO_PINMAP[EVT_XOR] } };
+    filter_config.coincidence_window = config.event_coincidence_window;
+    filter_config.min_deadtime = MuonPi::Config::EventFilter::min_deadtime;
+    filter_config.max_deadtime = MuonPi::Config::EventFilter::max_deadtime;
+    filter_config.deadtime_step = MuonPi::Config::EventFilter::deadtime_step;
+    filter_config.rate_high = MuonPi::Config::EventFilter::rate_high;
+    filter_config.rate_low = MuonPi::Config::EventFilter::rate_low;
+    filter_config.burst_interval = MuonPi::Config::EventFilter::burst_interval;
+    filter_config.burst_threshold = MuonPi::Config::EventFilter::burst_threshold;
+    pigHandler = new PigpiodHandler(gpio_pins, filter_config);
+    pigHandler->setInputRecorder(m_input_recorder.get());
+    // no events are acquired before the discriminator thresholds and the bias are applied, see the end of the i2c phase
+    pigHandler->setInhibited(true);
     tdc7200 = new TDC7200(GPIO_PINMAP[TDC_INTB]);
     pigThread = new QThread();
     pigThread->setObjectName("muondetector-daemon-pigpio");
@@ -739,11 +892,17 @@ void Daemon::connectToPigpiod()
         if (m_histo_map.find("Time-to-Digital Time Diff") != m_histo_map.end()) {
             m_histo_map["Time-to-Digital Time Diff"]->fill(usecs);
         }
+        if (config.event_analysis) {
+            m_event_analyzer.add_tdc(m_last_tdc_tick, usecs);
+        }
     });
     connect(tdc7200, &TDC7200::statusUpdated, this, [this](bool isPresent) {
         spiDevicePresent = isPresent;
         sendSpiStats();
     });
+    // the pigpiod connection has to be set up before the tdc is initialised
+    connect(pigThread, &QThread::started, pigHandler, &PigpiodHandler::initialise);
+    connect(pigHandler, &PigpiodHandler::initialisationFinished, this, [this]() { finishStartupPhase("pigpiod"); });
     connect(pigThread, &QThread::started, tdc7200, &TDC7200::initialise);
     connect(pigThread, &QThread::finished, tdc7200, &TDC7200::deleteLater);
 
@@ -763,6 +922,17 @@ void Daemon::connectToPigpiod()
             onStatusLed2Event(50);
         }
     });
+    if (config.event_analysis) {
+        connect(pigHandler, &PigpiodHandler::gpioEvent, this, [this](uint8_t gpio_pin, uint32_t tick) {
+            if (gpio_pin == GPIO_PINMAP[EVT_AND]) {
+                m_event_analyzer.add_gpio_event(0, tick);
+            } else if (gpio_pin == GPIO_PINMAP[EVT_XOR]) {
+                m_event_analyzer.add_gpio_event(1, tick);
+            } else if (gpio_pin == GPIO_PINMAP[TDC_INTB]) {
+                m_last_tdc_tick = tick;
+            }
+        });
+    }
 
     connect(pigHandler, &PigpiodHandler::samplingTrigger, this, &Daemon::sampleAdc0Event);
     connect(pigHandler, &PigpiodHandler::eventInterval, this, [this](quint64 nsecs) {
@@ -852,6 +1022,9 @@ void Daemon::connectToGps()
 
     // here is where the magic threading happens look closely
     qtGps = new QtSerialUblox(config.gpsdevname, MuonPi::Config::Hardware::GNSS::uart_timeout, config.gnss_baudrate, config.gnss_dump_raw, verbose - 1, config.showout, config.showin);
+    qtGps->setInputRecorder(m_input_recorder);
+    // without the configuration of the receiver enabled the baud rate is only detected, not switched
+    qtGps->setMaxBaudRate((config.gnss_config) ? config.gnss_max_baudrate : 0);
     gpsThread = new QThread();
     gpsThread->setObjectName("muondetector-daemon-gnss");
     qtGps->moveToThread(gpsThread);
@@ -873,6 +1046,27 @@ void Daemon::connectToGps()
     connect(this, &Daemon::sendUbxMsg, qtGps, &QtSerialUblox::enqueueMsg);
     connect(qtGps, &QtSerialUblox::UBXReceivedAckNak, this, &Daemon::UBXReceivedAckNak);
     connect(qtGps, &QtSerialUblox::UBXreceivedMsgRateCfg, this, &Daemon::UBXReceivedMsgRateCfg);
+    connect(qtGps, &QtSerialUblox::UBXreceivedMsgRateCfg, this, [this]() {
+        // the first reply to the message rate poll marks the gnss module as ready
+        if (m_startup.running("gnss")) {
+            finishStartupPhase("gnss");
+        }
+    });
+    connect(qtGps, &QtSerialUblox::UBXRoundTrip, this, [this](uint16_t msgID, std::chrono::duration<double> rtt) {
+        if (verbose > 3) {
+            qDebug() << "ubx round trip: id=" << QString::number(msgID, 16) << " rtt=" << 1e3 * rtt.count() << "ms";
+        }
+        emit logParameter(LogParameter("ubxRoundTripTime", QString::number(1e3 * rtt.count(), 'f', 1) + " ms", LogParameter::LOG_AVERAGE));
+    });
+    connect(qtGps, &QtSerialUblox::UBXBaudRateChanged, this, [this](uint32_t baudRate) {
+        config.gnss_baudrate = static_cast<int>(baudRate);
+        m_ubx_scheduler.set_link(gnssMeasRate, baudRate);
+        emit logParameter(LogParameter("gnssBaudRate", QString::number(baudRate), LogParameter::LOG_ON_CHANGE));
+    });
+    connect(qtGps, &QtSerialUblox::UBXLinkUtilization, this, [this](uint32_t, double rxLoad, double txLoad) {
+        emit logParameter(LogParameter("gnssUartRxLoad", QString::number(1e2 * rxLoad, 'f', 1) + " %", LogParameter::LOG_AVERAGE));
+        emit logParameter(LogParameter("gnssUartTxLoad", QString::number(1e2 * txLoad, 'f', 1) + " %", LogParameter::LOG_AVERAGE));
+    });
     connect(qtGps, &QtSerialUblox::gpsPropertyUpdatedGeodeticPos, this, &Daemon::onGpsPropertyUpdatedGeodeticPos);
     connect(qtGps, &QtSerialUblox::gpsPropertyUpdatedGnss, this, &Daemon::onGpsPropertyUpdatedGnss);
     connect(qtGps, &QtSerialUblox::gpsPropertyUpdatedUint32, this, &Daemon::gpsPropertyUpdatedUint32);
@@ -894,7 +1088,11 @@ void Daemon::connectToGps()
     connect(this, &Daemon::UBXSetMinCNO, qtGps, &QtSerialUblox::UBXSetMinCNO);
     connect(this, &Daemon::UBXSetAopCfg, qtGps, &QtSerialUblox::UBXSetAopCfg);
     connect(this, &Daemon::UBXSaveCfg, qtGps, &QtSerialUblox::UBXSaveCfg);
+    connect(this, &Daemon::UBXValSet, qtGps, &QtSerialUblox::UBXValSet);
+    connect(this, &Daemon::UBXValGet, qtGps, &QtSerialUblox::UBXValGet);
     connect(qtGps, &QtSerialUblox::UBXReceivedTimeTM2, this, &Daemon::onUBXReceivedTimeTM2);
+    connect(qtGps, &QtSerialUblox::UBXReceivedNavClock, this, &Daemon::onUBXReceivedNavClock);
+    connect(qtGps, &QtSerialUblox::UBXReceivedTimePulse, this, &Daemon::onUBXReceivedTimePulse);
 
     connect(qtGps, &QtSerialUblox::UBXReceivedDops, this, [this](const UbxDopStruct& dops) {
         currentDOP = dops;
@@ -913,12 +1111,18 @@ void Daemon::connectToGps()
         qDebug() << "store_local flag =" << config.storeLocal;
 
         if (config.storeLocal) {
-            connect(this, &Daemon::eventMessage, fileHandler, &FileHandler::writeToDataFile);
+            connect(this, &Daemon::eventRecord, fileHandler, &FileHandler::writeEventToDataFile);
+        }
+        if (config.event_analysis && config.event_summary_only) {
+            qInfo() << "publishing event analysis summaries only";
+        } else {
+            connect(this, &Daemon::eventRecord, mqttHandler,
+                [this](const EventRecord& record) {
+                    static const QString topic { QString::fromStdString(Config::MQTT::data_topic) };
+                    mqttHandler->publish(topic, record);
+                    LatencyTracer::trace(LatencyTracer::Stage::MqttPublish);
+                });
         }
-        connect(this, &Daemon::eventMessage, mqttHandler,
-            [this](const QString& content) {
-                mqttHandler->publish(QString::fromStdString(Config::MQTT::data_topic), content);
-            });
     }
     // after thread start there will be a signal emitted which starts the qtGps makeConnection function
     gpsThread->start();
@@ -946,6 +1150,25 @@ void Daemon::incomingConnection(qintptr socketDescriptor)
     connect(tcpConnection, &TcpConnection::toConsole, this, &Daemon::toConsole);
     connect(tcpConnection, &TcpConnection::madeConnection, this, &Daemon::onMadeConnection);
     connect(tcpConnection, &TcpConnection::connectionTimeout, this, &Daemon::onStoppedConnection);
+    connect(tcpConnection, &TcpConnection::sendStatistics, this, [this](quint32 queuedBytes, quint32 droppedMessages, double latencyMean_ms, double latencyMax_ms) {
+        emit logParameter(LogParameter("tcpQueuedBytes", QString::number(queuedBytes), LogParameter::LOG_AVERAGE));
+        emit logParameter(LogParameter("tcpDroppedMessages", QString::number(droppedMessages), LogParameter::LOG_AVERAGE));
+        emit logParameter(LogParameter("tcpSendLatency", QString::number(latencyMean_ms, 'f', 2) + " ms", LogParameter::LOG_AVERAGE));
+        emit logParameter(LogParameter("tcpSendLatencyMax", QString::number(latencyMax_ms, 'f', 2) + " ms", LogParameter::LOG_LATEST));
+    });
+    // the clients display the status messages, so they are requested at a higher rate while any client is connected
+    connect(tcpConnection, &QObject::destroyed, this, [this]() {
+        if (--m_tcp_clients == 0) {
+            m_ubx_scheduler.withdraw("client");
+            applyUbxMsgRates();
+        }
+    });
+    if (m_tcp_clients++ == 0) {
+        for (const auto& msg : scheduledUbxMsgs) {
+            m_ubx_scheduler.declare("client", msg.msgID, msg.clientRate);
+        }
+        applyUbxMsgRates();
+    }
     tcpThread->start();
 
     pollAllUbxMsgRate();
@@ -969,13 +1192,12 @@ void Daemon::setupHistos()
     m_histo_map.emplace("Time-to-Digital Time Diff", std::make_shared<Histogram>("Time-to-Digital Time Diff", 400, 0., 1e6, true, "ns"));
     m_histo_map.emplace("Bias Voltage", std::make_shared<Histogram>("Bias Voltage", 200, 0., 1., true, "V"));
     m_histo_map.emplace("Bias Current", std::make_shared<Histogram>("Bias Current", 200, 0., 50., true, "uA"));
+    m_histo_map.emplace("eventMultiplicity", std::make_shared<Histogram>("eventMultiplicity", 3, 0., 2., false));
+    m_histo_map.emplace("coincidenceTimeResidual", std::make_shared<Histogram>("coincidenceTimeResidual", 41, -20., 20., false, "us"));
+    m_histo_map.emplace("coincidenceInterval", std::make_shared<Histogram>("coincidenceInterval", 200, 0., 2000., true, "ms"));
+    m_histo_map.emplace("coincidentTdcTimeDiff", std::make_shared<Histogram>("coincidentTdcTimeDiff", 400, 0., 1e3, true, "us"));
     m_histo_map.emplace("pDOP", std::make_shared<Histogram>("pDOP", 200, 0., 10., true));
     m_histo_map.emplace("tDOP", std::make_shared<Histogram>("tDOP", 200, 0., 10., true));
-
-    m_geopos_manager.set_histos(
-        m_histo_map["geoLongitude"],
-        m_histo_map["geoLatitude"],
-        m_histo_map["geoHeight"]);
 }
 
 void Daemon::clearHisto(const QString& histoName)
@@ -984,17 +1206,24 @@ void Daemon::clearHisto(const QString& histoName)
         m_histo_map[histoName.toStdString()]->clear();
         emit sendHistogram(*m_histo_map[histoName.toStdString()]);
     }
+    // the lock-in position is no longer estimated from the geo histograms, clearing them restarts the estimate as before
+    if (histoName == "geoLongitude" || histoName == "geoLatitude" || histoName == "geoHeight") {
+        m_geopos_manager.reset_estimators();
+    }
     return;
 }
 
 // ALL FUNCTIONS ABOUT TCPMESSAGE SENDING AND RECEIVING
 void Daemon::receivedTcpMessage(TcpMessage tcpMessage)
 {
-    TCP_MSG_KEY msgID = static_cast<TCP_MSG_KEY>(tcpMessage.getMsgID());
-    if (msgID == TCP_MSG_KEY::MSG_THRESHOLD) {
-        uint8_t channel;
-        float threshold;
-        *(tcpMessage.dStream) >> channel >> threshold;
+    if (!m_tcp_dispatcher.dispatch(tcpMessage)) {
+        qDebug() << "received unknown TCP message: msgID =" << QString::number(tcpMessage.getMsgID());
+    }
+}
+
+void Daemon::setupTcpDispatcher()
+{
+    m_tcp_dispatcher.on<uint8_t, float>(TCP_MSG_KEY::MSG_THRESHOLD, [this](uint8_t channel, float threshold) {
         if (channel > 1)
             return;
         if (threshold < 0.001) {
@@ -1003,30 +1232,23 @@ void Daemon::receivedTcpMessage(TcpMessage tcpMessage)
         } else
             setDacThresh(channel, threshold);
         sendDacThresh(Config::Hardware::DAC::Channel::threshold[channel]);
-    } else if (msgID == TCP_MSG_KEY::MSG_THRESHOLD_REQUEST) {
+    });
+    m_tcp_dispatcher.on(TCP_MSG_KEY::MSG_THRESHOLD_REQUEST, [this]() {
         sendDacThresh(Config::Hardware::DAC::Channel::threshold[0]);
         sendDacThresh(Config::Hardware::DAC::Channel::threshold[1]);
-    } else if (msgID == TCP_MSG_KEY::MSG_BIAS_VOLTAGE) {
-        float voltage;
-        *(tcpMessage.dStream) >> voltage;
+    });
+    m_tcp_dispatcher.on<float>(TCP_MSG_KEY::MSG_BIAS_VOLTAGE, [this](float voltage) {
         setBiasVoltage(voltage);
         clearHisto("pulseHeight");
         sendBiasVoltage();
-    } else if (msgID == TCP_MSG_KEY::MSG_BIAS_VOLTAGE_REQUEST) {
-        sendBiasVoltage();
-    } else if (msgID == TCP_MSG_KEY::MSG_BIAS_SWITCH) {
-        bool status;
-        *(tcpMessage.dStream) >> status;
+    });
+    m_tcp_dispatcher.on(TCP_MSG_KEY::MSG_BIAS_VOLTAGE_REQUEST, [this]() { sendBiasVoltage(); });
+    m_tcp_dispatcher.on<bool>(TCP_MSG_KEY::MSG_BIAS_SWITCH, [this](bool status) {
         setBiasStatus(status);
         sendBiasStatus();
-    } else if (msgID == TCP_MSG_KEY::MSG_BIAS_SWITCH_REQUEST) {
-        sendBiasStatus();
-    } else if (msgID == TCP_MSG_KEY::MSG_BIAS_VOLTAGE_REQUEST) {
-        sendBiasVoltage();
-    } else if (msgID == TCP_MSG_KEY::MSG_PREAMP_SWITCH) {
-        quint8 channel;
-        bool status;
-        *(tcpMessage.dStream) >> channel >> status;
+    });
+    m_tcp_dispatcher.on(TCP_MSG_KEY::MSG_BIAS_SWITCH_REQUEST, [this]() { sendBiasStatus(); });
+    m_tcp_dispatcher.on<quint8, bool>(TCP_MSG_KEY::MSG_PREAMP_SWITCH, [this](quint8 channel, bool status) {
         if (channel == 0) {
             config.preamp_enable[0] = status;
             emit GpioSetState(GPIO_PINMAP[PREAMP_1], status);
@@ -1038,12 +1260,12 @@ void Daemon::receivedTcpMessage(TcpMessage tcpMessage)
         }
         sendPreampStatus(0);
         sendPreampStatus(1);
-    } else if (msgID == TCP_MSG_KEY::MSG_PREAMP_SWITCH_REQUEST) {
+    });
+    m_tcp_dispatcher.on(TCP_MSG_KEY::MSG_PREAMP_SWITCH_REQUEST, [this]() {
         sendPreampStatus(0);
         sendPreampStatus(1);
-    } else if (msgID == TCP_MSG_KEY::MSG_POLARITY_SWITCH) {
-        bool pol1, pol2;
-        *(tcpMessage.dStream) >> pol1 >> pol2;
+    });
+    m_tcp_dispatcher.on<bool, bool>(TCP_MSG_KEY::MSG_POLARITY_SWITCH, [this](bool pol1, bool pol2) {
         if (MuonPi::Version::hardware.major >= 3 && pol1 != config.polarity[0]) {
             config.polarity[0] = pol1;
             emit GpioSetState(GPIO_PINMAP[IN_POL1], config.polarity[0]);
@@ -1055,86 +1277,68 @@ void Daemon::receivedTcpMessage(TcpMessage tcpMessage)
             emit logParameter(LogParameter("polaritySwitch2", QString::number((int)config.polarity[1]), LogParameter::LOG_EVERY));
         }
         sendPolarityStatus();
-    } else if (msgID == TCP_MSG_KEY::MSG_POLARITY_SWITCH_REQUEST) {
-        sendPolarityStatus();
-    } else if (msgID == TCP_MSG_KEY::MSG_GAIN_SWITCH) {
-        bool status;
-        *(tcpMessage.dStream) >> status;
+    });
+    m_tcp_dispatcher.on(TCP_MSG_KEY::MSG_POLARITY_SWITCH_REQUEST, [this]() { sendPolarityStatus(); });
+    m_tcp_dispatcher.on<bool>(TCP_MSG_KEY::MSG_GAIN_SWITCH, [this](bool status) {
         config.hi_gain = status;
         emit GpioSetState(GPIO_PINMAP[GAIN_HL], status);
         clearHisto("pulseHeight");
         emit logParameter(LogParameter("gainSwitch", QString::number((int)config.hi_gain), LogParameter::LOG_EVERY));
         sendGainSwitchStatus();
-        return;
-    } else if (msgID == TCP_MSG_KEY::MSG_GAIN_SWITCH_REQUEST) {
-        sendGainSwitchStatus();
-    } else if (msgID == TCP_MSG_KEY::MSG_UBX_MSG_RATE_REQUEST) {
-        sendUbxMsgRates();
-        return;
-    } else if (msgID == TCP_MSG_KEY::MSG_UBX_RESET) {
+    });
+    m_tcp_dispatcher.on(TCP_MSG_KEY::MSG_GAIN_SWITCH_REQUEST, [this]() { sendGainSwitchStatus(); });
+    m_tcp_dispatcher.on(TCP_MSG_KEY::MSG_UBX_MSG_RATE_REQUEST, [this]() { sendUbxMsgRates(); });
+    m_tcp_dispatcher.on(TCP_MSG_KEY::MSG_UBX_RESET, [this]() {
         uint32_t resetFlags = QtSerialUblox::RESET_WARM | QtSerialUblox::RESET_SW;
         emit resetUbxDevice(resetFlags);
         pollAllUbxMsgRate();
-    } else if (msgID == TCP_MSG_KEY::MSG_UBX_CONFIG_DEFAULT) {
+    });
+    m_tcp_dispatcher.on(TCP_MSG_KEY::MSG_UBX_CONFIG_DEFAULT, [this]() {
         configGps();
         pollAllUbxMsgRate();
-    } else if (msgID == TCP_MSG_KEY::MSG_UBX_MSG_RATE) {
-        QMap<uint16_t, int> ubxMsgRates;
-        *(tcpMessage.dStream) >> ubxMsgRates;
+    });
+    m_tcp_dispatcher.on<QMap<uint16_t, int>>(TCP_MSG_KEY::MSG_UBX_MSG_RATE, [this](QMap<uint16_t, int> ubxMsgRates) {
         setUbxMsgRates(ubxMsgRates);
-    } else if (msgID == TCP_MSG_KEY::MSG_PCA_SWITCH) {
-        quint8 portMask;
-        *(tcpMessage.dStream) >> portMask;
+    });
+    m_tcp_dispatcher.on<quint8>(TCP_MSG_KEY::MSG_PCA_SWITCH, [this](quint8 portMask) {
         setPcaChannel((uint8_t)portMask);
         sendPcaChannel();
         clearHisto("UbxEventLength");
-    } else if (msgID == TCP_MSG_KEY::MSG_PCA_SWITCH_REQUEST) {
-        sendPcaChannel();
-    } else if (msgID == TCP_MSG_KEY::MSG_EVENTTRIGGER) {
-        unsigned int signal;
-        *(tcpMessage.dStream) >> signal;
+    });
+    m_tcp_dispatcher.on(TCP_MSG_KEY::MSG_PCA_SWITCH_REQUEST, [this]() { sendPcaChannel(); });
+    m_tcp_dispatcher.on<unsigned int>(TCP_MSG_KEY::MSG_EVENTTRIGGER, [this](unsigned int signal) {
         setEventTriggerSelection((GPIO_SIGNAL)signal);
         usleep(1000);
         sendEventTriggerSelection();
-        return;
-    } else if (msgID == TCP_MSG_KEY::MSG_EVENTTRIGGER_REQUEST) {
-        sendEventTriggerSelection();
-    } else if (msgID == TCP_MSG_KEY::MSG_GPIO_RATE_REQUEST) {
-        quint8 whichRate;
-        quint16 number;
-        *(tcpMessage.dStream) >> number >> whichRate;
+    });
+    m_tcp_dispatcher.on(TCP_MSG_KEY::MSG_EVENTTRIGGER_REQUEST, [this]() { sendEventTriggerSelection(); });
+    m_tcp_dispatcher.on<quint16, quint8>(TCP_MSG_KEY::MSG_GPIO_RATE_REQUEST, [this](quint16 number, quint8 whichRate) {
         sendGpioRates(number, whichRate);
-    } else if (msgID == TCP_MSG_KEY::MSG_GPIO_RATE_RESET) {
-        clearRates();
-    } else if (msgID == TCP_MSG_KEY::MSG_DAC_REQUEST) {
-        quint8 channel;
-        *(tcpMessage.dStream) >> channel;
+    });
+    m_tcp_dispatcher.on(TCP_MSG_KEY::MSG_GPIO_RATE_RESET, [this]() { clearRates(); });
+    m_tcp_dispatcher.on<quint8>(TCP_MSG_KEY::MSG_DAC_REQUEST, [this](quint8 channel) {
         MCP4728::DacChannel channelData;
         if (!dac_p || !dac_p->probeDevicePresence())
             return;
         dynamic_cast<MCP4728*>(dac_p.get())->readChannel(channel, channelData);
         float voltage = MCP4728::code2voltage(channelData);
         sendDacReadbackValue(channel, voltage);
-    } else if (msgID == TCP_MSG_KEY::MSG_ADC_SAMPLE_REQUEST) {
-        quint8 channel;
-        *(tcpMessage.dStream) >> channel;
-        sampleAdcEvent(channel);
-    } else if (msgID == TCP_MSG_KEY::MSG_TEMPERATURE_REQUEST) {
-        getTemperature();
-    } else if (msgID == TCP_MSG_KEY::MSG_I2C_STATS_REQUEST) {
-        sendI2cStats();
-    } else if (msgID == TCP_MSG_KEY::MSG_I2C_SCAN_BUS) {
+    });
+    m_tcp_dispatcher.on<quint8>(TCP_MSG_KEY::MSG_ADC_SAMPLE_REQUEST, [this](quint8 channel) { sampleAdcEvent(channel); });
+    m_tcp_dispatcher.on(TCP_MSG_KEY::MSG_TEMPERATURE_REQUEST, [this]() { getTemperature(); });
+    m_tcp_dispatcher.on(TCP_MSG_KEY::MSG_I2C_STATS_REQUEST, [this]() { sendI2cStats(); });
+    m_tcp_dispatcher.on(TCP_MSG_KEY::MSG_I2C_SCAN_BUS, [this]() {
         scanI2cBus();
         sendI2cStats();
-    } else if (msgID == TCP_MSG_KEY::MSG_SPI_STATS_REQUEST) {
-        sendSpiStats();
-    } else if (msgID == TCP_MSG_KEY::MSG_CALIB_REQUEST) {
-        sendCalib();
-    } else if (msgID == TCP_MSG_KEY::MSG_CALIB_SAVE) {
+    });
+    m_tcp_dispatcher.on(TCP_MSG_KEY::MSG_SPI_STATS_REQUEST, [this]() { sendSpiStats(); });
+    m_tcp_dispatcher.on(TCP_MSG_KEY::MSG_CALIB_REQUEST, [this]() { sendCalib(); });
+    m_tcp_dispatcher.on(TCP_MSG_KEY::MSG_CALIB_SAVE, [this]() {
         if (calib != nullptr)
             calib->writeToEeprom();
         sendCalib();
-    } else if (msgID == TCP_MSG_KEY::MSG_CALIB_SET) {
+    });
+    m_tcp_dispatcher.handle(TCP_MSG_KEY::MSG_CALIB_SET, [this](TcpMessage& tcpMessage) {
         std::vector<CalibStruct> calibs;
         quint8 nrEntries = 0;
         *(tcpMessage.dStream) >> nrEntries;
@@ -1144,7 +1348,8 @@ void Daemon::receivedTcpMessage(TcpMessage tcpMessage)
             calibs.push_back(item);
         }
         receivedCalibItems(calibs);
-    } else if (msgID == TCP_MSG_KEY::MSG_UBX_GNSS_CONFIG) {
+    });
+    m_tcp_dispatcher.handle(TCP_MSG_KEY::MSG_UBX_GNSS_CONFIG, [this](TcpMessage& tcpMessage) {
         std::vector<GnssConfigStruct> gnss_configs;
         int nrEntries = 0;
         *(tcpMessage.dStream) >> nrEntries;
@@ -1156,50 +1361,41 @@ void Daemon::receivedTcpMessage(TcpMessage tcpMessage)
         emit setGnssConfig(gnss_configs);
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
         emit sendPollUbxMsg(UBX_MSG::CFG_GNSS);
-    } else if (msgID == TCP_MSG_KEY::MSG_UBX_CFG_TP5) {
-        UbxTimePulseStruct tp;
-        *(tcpMessage.dStream) >> tp;
+    });
+    m_tcp_dispatcher.on<UbxTimePulseStruct>(TCP_MSG_KEY::MSG_UBX_CFG_TP5, [this](UbxTimePulseStruct tp) {
         emit UBXSetCfgTP5(tp);
         emit sendPollUbxMsg(UBX_MSG::CFG_TP5);
-    } else if (msgID == TCP_MSG_KEY::MSG_UBX_CFG_SAVE) {
+    });
+    m_tcp_dispatcher.on(TCP_MSG_KEY::MSG_UBX_CFG_SAVE, [this]() {
         emit UBXSaveCfg();
         emit sendPollUbxMsg(UBX_MSG::CFG_TP5);
         emit sendPollUbxMsg(UBX_MSG::CFG_GNSS);
-    } else if (msgID == TCP_MSG_KEY::MSG_QUIT_CONNECTION) {
-        QString closeAddress;
-        *(tcpMessage.dStream) >> closeAddress;
-        emit closeConnection(closeAddress);
-    } else if (msgID == TCP_MSG_KEY::MSG_DAC_EEPROM_SET) {
-        saveDacValuesToEeprom();
-    } else if (msgID == TCP_MSG_KEY::MSG_HISTOGRAM_CLEAR) {
-        QString histoName;
-        *(tcpMessage.dStream) >> histoName;
-        clearHisto(histoName);
-    } else if (msgID == TCP_MSG_KEY::MSG_ADC_MODE_REQUEST) {
+    });
+    m_tcp_dispatcher.on<QString>(TCP_MSG_KEY::MSG_QUIT_CONNECTION, [this](QString closeAddress) { emit closeConnection(closeAddress); });
+    m_tcp_dispatcher.on(TCP_MSG_KEY::MSG_DAC_EEPROM_SET, [this]() { saveDacValuesToEeprom(); });
+    m_tcp_dispatcher.on<QString>(TCP_MSG_KEY::MSG_HISTOGRAM_CLEAR, [this](QString histoName) { clearHisto(histoName); });
+    m_tcp_dispatcher.on(TCP_MSG_KEY::MSG_ADC_MODE_REQUEST, [this]() {
         TcpMessage answer(TCP_MSG_KEY::MSG_ADC_MODE);
         *(answer.dStream) << static_cast<quint8>(adcSamplingMode);
         emit sendTcpMessage(answer);
-    } else if (msgID == TCP_MSG_KEY::MSG_ADC_MODE) {
-        quint8 mode { 0 };
-        *(tcpMessage.dStream) >> mode;
+    });
+    m_tcp_dispatcher.on<quint8>(TCP_MSG_KEY::MSG_ADC_MODE, [this](quint8 mode) {
         setAdcSamplingMode(static_cast<ADC_SAMPLING_MODE>(mode));
         TcpMessage answer(TCP_MSG_KEY::MSG_ADC_MODE);
         *(answer.dStream) << static_cast<quint8>(adcSamplingMode);
         emit sendTcpMessage(answer);
-    } else if (msgID == TCP_MSG_KEY::MSG_LOG_INFO) {
-        sendLogInfo();
-    } else if (msgID == TCP_MSG_KEY::MSG_GPIO_INHIBIT) {
-        bool inhibit = true;
-        *(tcpMessage.dStream) >> inhibit;
+    });
+    m_tcp_dispatcher.on(TCP_MSG_KEY::MSG_LOG_INFO, [this]() { sendLogInfo(); });
+    m_tcp_dispatcher.on(TCP_MSG_KEY::MSG_LATENCY_STATS, [this]() { sendLatencyStatistics(LatencyTracer::instance().statistics(false)); });
+    m_tcp_dispatcher.on<bool>(TCP_MSG_KEY::MSG_GPIO_INHIBIT, [this](bool inhibit) {
         if (pigHandler != nullptr) {
             pigHandler->setInhibited(inhibit);
             TcpMessage answer(TCP_MSG_KEY::MSG_GPIO_INHIBIT);
             *(answer.dStream) << pigHandler->isInhibited();
             emit sendTcpMessage(answer);
         }
-    } else if (msgID == TCP_MSG_KEY::MSG_MQTT_INHIBIT) {
-        bool inhibit { false };
-        *(tcpMessage.dStream) >> inhibit;
+    });
+    m_tcp_dispatcher.on<bool>(TCP_MSG_KEY::MSG_MQTT_INHIBIT, [this](bool inhibit) {
         if (mqttHandler != nullptr) {
             mqttHandler->setInhibited(inhibit);
             TcpMessage answer(TCP_MSG_KEY::MSG_MQTT_INHIBIT);
@@ -1207,20 +1403,29 @@ void Daemon::receivedTcpMessage(TcpMessage tcpMessage)
             emit sendTcpMessage(answer);
             emit requestMqttConnectionStatus();
         }
-    } else if (msgID == TCP_MSG_KEY::MSG_VERSION) {
-        sendVersionInfo();
-    } else if (msgID == TCP_MSG_KEY::MSG_POSITION_MODEL) {
-        PositionModeConfig pos_mode_config {};
-        *(tcpMessage.dStream) >> pos_mode_config;
+    });
+    m_tcp_dispatcher.on(TCP_MSG_KEY::MSG_VERSION, [this]() { sendVersionInfo(); });
+    m_tcp_dispatcher.on<PositionModeConfig>(TCP_MSG_KEY::MSG_POSITION_MODEL, [this](PositionModeConfig pos_mode_config) {
         if (pos_mode_config != m_geopos_manager.get_mode_config()) {
             m_geopos_manager.set_mode_config(pos_mode_config);
             writeSettingsToFile();
         }
         sendPositionModel(m_geopos_manager.get_mode_config());
         sendGeodeticPos(m_geopos_manager.get_current_position().getPosStruct());
-    } else {
-        qDebug() << "received unknown TCP message: msgID =" << QString::number(static_cast<int>(msgID));
+    });
+}
+
+void Daemon::logTcpDispatchStatistics()
+{
+    quint64 count { 0 };
+    std::chrono::nanoseconds max {};
+    for (const auto& entry : m_tcp_dispatcher.statistics()) {
+        count += entry.count;
+        max = std::max(max, entry.max);
     }
+    m_tcp_dispatcher.resetStatistics();
+    emit logParameter(LogParameter("tcpReceivedMessages", QString::number(count), LogParameter::LOG_LATEST));
+    emit logParameter(LogParameter("tcpHandlerTimeMax", QString::number(1e-3 * max.count(), 'f', 1) + " us", LogParameter::LOG_LATEST));
 }
 
 void Daemon::setAdcSamplingMode(ADC_SAMPLING_MODE mode)
@@ -1261,6 +1466,75 @@ void Daemon::sendLogInfo()
     emit sendTcpMessage(answer);
 }
 
+void Daemon::sendLatencyStatistics(const std::vector<LatencyTracer::StageStatistics>& stats)
+{
+    TcpMessage tcpMessage(TCP_MSG_KEY::MSG_LATENCY_STATS);
+    *(tcpMessage.dStream) << static_cast<quint8>(stats.size());
+    for (const auto& stage_stats : stats) {
+        *(tcpMessage.dStream) << QString::fromStdString(LatencyTracer::name(stage_stats.stage))
+                              << static_cast<quint32>(stage_stats.count)
+                              << static_cast<qint64>(stage_stats.hop.p50.count())
+                              << static_cast<qint64>(stage_stats.hop.p99.count())
+                              << static_cast<qint64>(stage_stats.hop.max.count())
+                              << static_cast<qint64>(stage_stats.total.p50.count())
+                              << static_cast<qint64>(stage_stats.total.p99.count())
+                              << static_cast<qint64>(stage_stats.total.max.count());
+    }
+    *(tcpMessage.dStream) << static_cast<quint64>(LatencyTracer::instance().droppedCount());
+    emit sendTcpMessage(tcpMessage);
+}
+
+void Daemon::logLatencyStatistics()
+{
+    const auto stats { LatencyTracer::instance().statistics() };
+    for (const auto& stage_stats : stats) {
+        if (LatencyTracer::predecessor(stage_stats.stage) == LatencyTracer::Stage::Count) {
+            continue;
+        }
+        const QString name { "latency" + QString::fromStdString(LatencyTracer::name(stage_stats.stage)) };
+        emit logParameter(LogParameter(name + "P50", QString::number(1e-3 * stage_stats.hop.p50.count(), 'f', 1) + " us", LogParameter::LOG_LATEST));
+        emit logParameter(LogParameter(name + "P99", QString::number(1e-3 * stage_stats.hop.p99.count(), 'f', 1) + " us", LogParameter::LOG_LATEST));
+        emit logParameter(LogParameter(name + "Max", QString::number(1e-3 * stage_stats.hop.max.count(), 'f', 1) + " us", LogParameter::LOG_LATEST));
+        if (stage_stats.stage == LatencyTracer::Stage::MqttPublish || stage_stats.stage == LatencyTracer::Stage::FileWrite) {
+            // end-to-end latency from the parsed time mark to the sink
+            emit logParameter(LogParameter(name + "TotalP99", QString::number(1e-3 * stage_stats.total.p99.count(), 'f', 1) + " us", LogParameter::LOG_LATEST));
+            emit logParameter(LogParameter(name + "TotalMax", QString::number(1e-3 * stage_stats.total.max.count(), 'f', 1) + " us", LogParameter::LOG_LATEST));
+        }
+    }
+    emit logParameter(LogParameter("latencyTraceDropped", QString::number(LatencyTracer::instance().droppedCount()), LogParameter::LOG_ON_CHANGE));
+    sendLatencyStatistics(stats);
+}
+
+void Daemon::logEventFilterStatistics()
+{
+    if (pigHandler.isNull()) {
+        return;
+    }
+    for (const auto& channel_stats : pigHandler->eventFilter().statistics()) {
+        const GPIO_SIGNAL signal { bcmToGpioSignal(channel_stats.gpio) };
+        const QString name { "eventFilter" + QString::fromStdString(GPIO_SIGNAL_MAP.at(signal).name) };
+        emit logParameter(LogParameter(name + "Accepted", QString::number(channel_stats.accepted), LogParameter::LOG_LATEST));
+        emit logParameter(LogParameter(name + "SuppressedBurst", QString::number(channel_stats.suppressed_burst), LogParameter::LOG_LATEST));
+        emit logParameter(LogParameter(name + "SuppressedCoincidence", QString::number(channel_stats.suppressed_coincidence), LogParameter::LOG_LATEST));
+        emit logParameter(LogParameter(name + "SuppressedDeadtime", QString::number(channel_stats.suppressed_deadtime), LogParameter::LOG_LATEST));
+        emit logParameter(LogParameter(name + "Deadtime", QString::number(channel_stats.deadtime.count()) + " us", LogParameter::LOG_AVERAGE));
+        emit logParameter(LogParameter(name + "Burst", QString::number(static_cast<int>(channel_stats.burst)), LogParameter::LOG_ON_CHANGE));
+    }
+}
+
+void Daemon::logOledStatistics()
+{
+    if (!oled_p) {
+        return;
+    }
+    const auto last { oled_p->lastTransfer() };
+    const auto total { oled_p->totalTransfer() };
+    emit logParameter(LogParameter("oledUpdateBytes", QString::number(last.bytes), LogParameter::LOG_AVERAGE));
+    emit logParameter(LogParameter("oledUpdateBusTime", QString::number(last.bus_time) + " ms", LogParameter::LOG_AVERAGE));
+    emit logParameter(LogParameter("oledBytesWritten", QString::number(total.bytes), LogParameter::LOG_LATEST));
+    emit logParameter(LogParameter("oledBusTime", QString::number(total.bus_time) + " ms", LogParameter::LOG_LATEST));
+}
+
 void Daemon::sendI2cStats()
 {
     TcpMessage tcpMessage(TCP_MSG_KEY::MSG_I2C_STATS);
@@ -1336,7 +1610,9 @@ void Daemon::onGpsPropertyUpdatedGeodeticPos(const GnssPosStruct& pos)
             new_pos_struct.lat * 1e-7,
             1e-3 * new_pos_struct.hMSL,
             1e-3 * new_pos_struct.hAcc,
-            1e-3 * new_pos_struct.vAcc });
+            1e-3 * new_pos_struct.vAcc },
+        currentDOP().hDOP / 100.,
+        currentDOP().vDOP / 100.);
 
     if (1e-3 * pos.vAcc < 100.) {
         if (m_geopos_manager.get_mode() != PositionModeConfig::Mode::LockIn || currentDOP().vDOP / 100. < m_geopos_manager.get_mode_config().lock_in_max_dop) {
@@ -1393,6 +1669,7 @@ void Daemon::sendDacReadbackValue(uint8_t channel, float voltage)
 
 void Daemon::sendGpioPinEvent(uint8_t gpio_pin)
 {
+    LatencyTracer::trace(LatencyTracer::Stage::GpioDaemon);
     TcpMessage tcpMessage(TCP_MSG_KEY::MSG_GPIO_EVENT);
     // reverse lookup of gpio function from given pin (first occurence)
     auto result = std::find_if(GPIO_PINMAP.begin(), GPIO_PINMAP.end(), [&gpio_pin](const std::pair<GPIO_SIGNAL, unsigned int>& item) { return item.second == gpio_pin; });
@@ -1586,6 +1863,9 @@ void Daemon::sendGpioRates(int number, quint8 whichRate)
 
 void Daemon::onAdcSampleReady(ADS1115::Sample sample)
 {
+    if (m_input_recorder) {
+        m_input_recorder->recordAdcSample(sample.channel, sample.value, sample.voltage, sample.lsb_voltage);
+    }
     const uint8_t channel = sample.channel;
     float voltage = sample.voltage;
     if (channel != 0) {
@@ -1632,7 +1912,7 @@ void Daemon::onAdcSampleReady(ADS1115::Sample sample)
 
 void Daemon::sampleAdcEvent(uint8_t channel)
 {
-    if (adc_p == nullptr || adcSamplingMode == ADC_SAMPLING_MODE::DISABLED) {
+    if (adc_p == nullptr || adcSamplingMode == ADC_SAMPLING_MODE::DISABLED || (m_input_replay && m_input_replay->isValid())) {
         return;
     }
     if (std::dynamic_pointer_cast<ADS1115>(adc_p)->getStatus() & i2cDevice::MODE_UNREACHABLE) {
@@ -1790,6 +2070,14 @@ bool Daemon::readEeprom()
 
 void Daemon::setUbxMsgRates(QMap<uint16_t, int>& ubxMsgRates)
 {
+    if (config.gnss_config) {
+        // rates set by the user override the scheduler, including switching off messages the daemon or a client asks for
+        for (QMap<uint16_t, int>::iterator it = ubxMsgRates.begin(); it != ubxMsgRates.end(); it++) {
+            m_ubx_scheduler.force(it.key(), static_cast<uint8_t>(std::clamp(it.value(), 0, 255)));
+        }
+        applyUbxMsgRates();
+        return;
+    }
     for (QMap<uint16_t, int>::iterator it = ubxMsgRates.begin(); it != ubxMsgRates.end(); it++) {
         emit UBXSetCfgMsgRate(it.key(), 1, it.value());
         emit sendPollUbxMsgRate(it.key());
@@ -1799,6 +2087,43 @@ void Daemon::setUbxMsgRates(QMap<uint16_t, int>& ubxMsgRates)
 
 // ALL FUNCTIONS ABOUT UBLOX GPS MODULE
 void Daemon::configGps()
+{
+    // the configuration interface depends on the protocol version of the receiver
+    if (QtSerialUblox::getProtVersion() > 0.1) {
+        applyGpsConfig();
+        return;
+    }
+    m_gnss_config_pending = true;
+    emit sendPollUbxMsg(UBX_MSG::MON_VER);
+    QTimer::singleShot(Config::Hardware::GNSS::version_timeout, this, [this]() {
+        if (!m_gnss_config_pending) {
+            return;
+        }
+        qWarning() << "no GNSS receiver version received, configuring with legacy messages";
+        applyGpsConfig();
+    });
+}
+
+void Daemon::applyGpsConfig()
+{
+    m_gnss_config_pending = false;
+    if (gnssValConfigSupported()) {
+        configGpsValSet();
+    } else {
+        configGpsLegacy();
+    }
+    emit sendPollUbxMsg(UBX_MSG::CFG_GNSS);
+    emit sendPollUbxMsg(UBX_MSG::CFG_NAVX5);
+    emit sendPollUbxMsg(UBX_MSG::CFG_ANT);
+    emit sendPollUbxMsg(UBX_MSG::CFG_TP5);
+}
+
+auto Daemon::gnssValConfigSupported() const -> bool
+{
+    return !m_gnss_valset_failed && QtSerialUblox::getProtVersion() >= Config::Hardware::GNSS::valset_min_protocol;
+}
+
+void Daemon::configGpsLegacy()
 {
     // set up ubx as only outPortProtocol
     emit UBXSetCfgPrt(1, PROTO_UBX);
@@ -1809,55 +2134,127 @@ void Daemon::configGps()
 
     emit UBXSetAopCfg(true);
 
-    emit sendPollUbxMsg(UBX_MSG::MON_VER);
+    emit UBXSetCfgRate(1000 / gnssMeasRate, 1); // UBX_RATE
 
-    int measrate = 10;
-    emit UBXSetCfgRate(1000 / measrate, 1); // UBX_RATE
-
-    emit UBXSetCfgMsgRate(UBX_MSG::TIM_TM2, 1, 1); // TIM-TM2
-    emit UBXSetCfgMsgRate(UBX_MSG::TIM_TP, 1, 0); // TIM-TP
-    emit UBXSetCfgMsgRate(UBX_MSG::NAV_TIMEUTC, 1, 131); // NAV-TIMEUTC
-    emit UBXSetCfgMsgRate(UBX_MSG::MON_HW, 1, 47); // MON-HW
-    emit UBXSetCfgMsgRate(UBX_MSG::MON_HW2, 1, 49); // MON-HW
-    emit UBXSetCfgMsgRate(UBX_MSG::NAV_POSLLH, 1, 127); // MON-POSLLH
-    // probably also configured with UBX-CFG-INFO...
-    emit UBXSetCfgMsgRate(UBX_MSG::NAV_TIMEGPS, 1, 0); // NAV-TIMEGPS
-    emit UBXSetCfgMsgRate(UBX_MSG::NAV_SOL, 1, 0); // NAV-SOL
-    emit UBXSetCfgMsgRate(UBX_MSG::NAV_STATUS, 1, 71); // NAV-STATUS
-    emit UBXSetCfgMsgRate(UBX_MSG::NAV_CLOCK, 1, 189); // NAV-CLOCK
-    emit UBXSetCfgMsgRate(UBX_MSG::MON_RXBUF, 1, 53); // MON-TXBUF
-    emit UBXSetCfgMsgRate(UBX_MSG::MON_TXBUF, 1, 51); // MON-TXBUF
-    emit UBXSetCfgMsgRate(UBX_MSG::NAV_SBAS, 1, 0); // NAV-SBAS
-    emit UBXSetCfgMsgRate(UBX_MSG::NAV_DOP, 1, 254); // NAV-DOP
+    updateUbxMsgSupport();
+    for (const auto& [msgID, rate] : m_ubx_scheduler.take_rates()) {
+        emit UBXSetCfgMsgRate(msgID, 1, rate);
+    }
     // this poll is for checking the port cfg (which protocols are enabled etc.)
     emit sendPollUbxMsg(UBX_MSG::CFG_PRT);
-    emit sendPollUbxMsg(UBX_MSG::MON_VER);
-    emit sendPollUbxMsg(UBX_MSG::MON_VER);
-    emit sendPollUbxMsg(UBX_MSG::MON_VER);
-    emit sendPollUbxMsg(UBX_MSG::CFG_GNSS);
-    emit sendPollUbxMsg(UBX_MSG::CFG_NAVX5);
-    emit sendPollUbxMsg(UBX_MSG::CFG_ANT);
-    emit sendPollUbxMsg(UBX_MSG::CFG_TP5);
+}
 
-    configGpsForVersion();
+void Daemon::configGpsValSet()
+{
+    // the whole profile goes out in a single transaction and is read back with a single poll
+    qDebug() << "setting GNSS dynamic model to" << config.gnss_dynamic_model << "(key-value configuration)";
+    UbxValConfig profile {};
+    profile.set(UbxCfgKey::UART1OUTPROT_UBX, 1);
+    profile.set(UbxCfgKey::UART1OUTPROT_NMEA, 0);
+    profile.set(UbxCfgKey::NAVSPG_DYNMODEL, config.gnss_dynamic_model);
+    profile.set(UbxCfgKey::ANA_USE_ANA, 1);
+    profile.set(UbxCfgKey::RATE_MEAS, 1000 / gnssMeasRate);
+    profile.set(UbxCfgKey::RATE_NAV, 1);
+    updateUbxMsgSupport();
+    for (const auto& [msgID, rate] : m_ubx_scheduler.take_rates()) {
+        profile.set_msg_rate(msgID, rate);
+    }
+    emit UBXValSet(profile, UbxValConfig::RAM);
+    emit UBXValGet(profile);
 }
 
 void Daemon::configGpsForVersion()
 {
     if (QtSerialUblox::getProtVersion() <= 0.1)
         return;
-    if (QtSerialUblox::getProtVersion() > 15.0) {
-        if (std::find(allMsgCfgID.begin(), allMsgCfgID.end(), UBX_MSG::NAV_SAT) == allMsgCfgID.end()) {
-            allMsgCfgID.push_back(UBX_MSG::NAV_SAT);
+    updateUbxMsgSupport();
+    if (!config.gnss_config) {
+        // the rates are left alone without -c, except for the satellite messages the sky view of the gui depends on
+        if (QtSerialUblox::getProtVersion() > 15.0) {
+            emit UBXSetCfgMsgRate(UBX_MSG::NAV_SAT, 1, 69);
+            emit UBXSetCfgMsgRate(UBX_MSG::NAV_SVINFO, 1, 0);
+        } else {
+            emit UBXSetCfgMsgRate(UBX_MSG::NAV_SVINFO, 1, 69);
+        }
+        return;
+    }
+    applyUbxMsgRates();
+}
+
+void Daemon::updateUbxMsgSupport()
+{
+    if (QtSerialUblox::getProtVersion() <= 0.1)
+        return;
+    // NAV-SAT replaces NAV-SVINFO from protocol version 15 on
+    const bool navSat { QtSerialUblox::getProtVersion() > 15.0 };
+    if (navSat && std::find(allMsgCfgID.begin(), allMsgCfgID.end(), UBX_MSG::NAV_SAT) == allMsgCfgID.end()) {
+        allMsgCfgID.push_back(UBX_MSG::NAV_SAT);
+    }
+    m_ubx_scheduler.set_supported(UBX_MSG::NAV_SAT, navSat);
+    m_ubx_scheduler.set_supported(UBX_MSG::NAV_SVINFO, !navSat);
+}
+
+void Daemon::setupUbxRateScheduler()
+{
+    m_ubx_scheduler.set_link(gnssMeasRate, static_cast<uint32_t>(config.gnss_baudrate));
+    for (const auto& msg : scheduledUbxMsgs) {
+        auto priority { msg.priority };
+        // the time mark correction holds back every mark until the TIM-TP and NAV-CLOCK of its second arrived
+        if (config.gnss_time_correction && (msg.msgID == UBX_MSG::TIM_TP || msg.msgID == UBX_MSG::NAV_CLOCK)) {
+            priority = UbxRateScheduler::Priority::Essential;
+        }
+        m_ubx_scheduler.add_message(msg.msgID, priority, msg.payloadSize, msg.eventDriven);
+        m_ubx_scheduler.declare("daemon", msg.msgID, msg.daemonRate);
+    }
+    if (config.gnss_time_correction) {
+        m_ubx_scheduler.declare("timecorrection", UBX_MSG::TIM_TP, 1);
+        m_ubx_scheduler.declare("timecorrection", UBX_MSG::NAV_CLOCK, 1);
+    }
+    // the satellite messages depend on the receiver version, see updateUbxMsgSupport
+    m_ubx_scheduler.set_supported(UBX_MSG::NAV_SAT, false);
+    m_ubx_scheduler.set_supported(UBX_MSG::NAV_SVINFO, false);
+}
+
+void Daemon::applyUbxMsgRates()
+{
+    // the rates are only touched if the daemon configures the receiver and the initial configuration went out
+    if (!config.gnss_config || m_gnss_config_pending || qtGps.isNull()) {
+        return;
+    }
+    const auto changes { m_ubx_scheduler.take_changes() };
+    if (changes.empty()) {
+        return;
+    }
+    if (verbose > 2) {
+        qDebug() << "rescheduling" << changes.size() << "ubx message rates, throttle" << m_ubx_scheduler.throttle();
+    }
+    if (gnssValConfigSupported()) {
+        UbxValConfig rates {};
+        for (const auto& [msgID, rate] : changes) {
+            rates.set_msg_rate(msgID, rate);
         }
-        emit UBXSetCfgMsgRate(UBX_MSG::NAV_SAT, 1, 69); // NAV-SAT
-        emit UBXSetCfgMsgRate(UBX_MSG::NAV_SVINFO, 1, 0);
-    } else
-        emit UBXSetCfgMsgRate(UBX_MSG::NAV_SVINFO, 1, 69); // NAV-SVINFO
+        if (!rates.empty()) {
+            emit UBXValSet(rates, UbxValConfig::RAM);
+            emit UBXValGet(rates);
+        }
+        return;
+    }
+    for (const auto& [msgID, rate] : changes) {
+        emit UBXSetCfgMsgRate(msgID, 1, rate);
+        emit sendPollUbxMsgRate(msgID);
+    }
 }
 
 void Daemon::pollAllUbxMsgRate()
 {
+    if (gnssValConfigSupported()) {
+        UbxValConfig rates {};
+        for (const auto& elem : allMsgCfgID) {
+            rates.set_msg_rate(elem, 0);
+        }
+        emit UBXValGet(rates);
+        return;
+    }
     for (const auto& elem : allMsgCfgID) {
         emit sendPollUbxMsgRate(elem);
     }
@@ -1871,6 +2268,18 @@ void Daemon::UBXReceivedAckNak(uint16_t ackedMsgID, uint16_t ackedCfgMsgID)
     case UBX_MSG::CFG_MSG:
         msgRateCfgs.insert(ackedCfgMsgID, -1);
         break;
+    case UBX_MSG::CFG_VALSET:
+        if (!m_gnss_valset_failed) {
+            qWarning() << "GNSS receiver rejected the key-value configuration, falling back to legacy messages";
+            m_gnss_valset_failed = true;
+            configGpsLegacy();
+        }
+        break;
+    case UBX_MSG::CFG_VALGET:
+        for (const auto& elem : allMsgCfgID) {
+            emit sendPollUbxMsgRate(elem);
+        }
+        break;
     default:
         break;
     }
@@ -2008,6 +2417,11 @@ void Daemon::onUBXReceivedTxBuf(uint8_t txUsage, uint8_t txPeakUsage)
     delete tcpMessage;
     emit logParameter(LogParameter("TXBufUsage", QString::number(txUsage) + " %", LogParameter::LOG_AVERAGE));
     emit logParameter(LogParameter("maxTXBufUsage", QString::number(txPeakUsage) + " %", LogParameter::LOG_LATEST));
+    // the TX buffer report is the load measurement of the rate scheduler
+    m_ubx_scheduler.set_load(txUsage, (m_ublox_ratebuffer) ? m_ublox_ratebuffer->avgRate() : 0.);
+    applyUbxMsgRates();
+    emit logParameter(LogParameter("ubxRateThrottle", QString::number(m_ubx_scheduler.throttle()), LogParameter::LOG_LATEST));
+    emit logParameter(LogParameter("ubxUartLoad", QString::number(100. * m_ubx_scheduler.uart_load(), 'f', 1) + " %", LogParameter::LOG_AVERAGE));
 }
 
 void Daemon::onUBXReceivedRxBuf(uint8_t rxUsage, uint8_t rxPeakUsage)
@@ -2137,6 +2551,10 @@ void Daemon::gpsPropertyUpdatedInt32(int32_t data, std::chrono::duration<double>
         emit logParameter(LogParameter("clockBias", QString::number(data) + " ns", LogParameter::LOG_AVERAGE));
         //propertyMap["clkBias"] = Property("clkBias", (qint32)data);
         break;
+    case 'e':
+        // time pulse quantisation error in ps
+        m_geopos_manager.gnss_filter().process_quantization_error(1e-3 * data);
+        break;
     default:
         break;
     }
@@ -2151,8 +2569,12 @@ void Daemon::UBXReceivedVersion(const QString& swString, const QString& hwString
     emit logParameter(LogParameter("UBX_SW_Version", QString("\"%1\"").arg(swString), LogParameter::LOG_ONCE));
     emit logParameter(LogParameter("UBX_HW_Version", hwString, LogParameter::LOG_ONCE));
     emit logParameter(LogParameter("UBX_Prot_Version", protString, LogParameter::LOG_ONCE));
-    if (initialVersionInfo) {
+    if (m_gnss_config_pending) {
+        applyGpsConfig();
+    } else if (initialVersionInfo) {
         configGpsForVersion();
+    }
+    if (initialVersionInfo) {
         qInfo() << "Ublox version:" << hwString << "(fw:" << swString << "prot:" << protString << ")";
     }
     initialVersionInfo = false;
@@ -2295,55 +2717,14 @@ void Daemon::aquireMonitoringParameters()
     if (adc_p && (!(std::dynamic_pointer_cast<ADS1115>(adc_p)->getStatus() & i2cDevice::MODE_UNREACHABLE)) && (std::dynamic_pointer_cast<ADS1115>(adc_p)->getStatus() & (i2cDevice::MODE_NORMAL | i2cDevice::MODE_FORCE))) {
         double v1 { adc_p->getVoltage(MuonPi::Config::Hardware::ADC::Channel::bias1) };
         double v2 { adc_p->getVoltage(MuonPi::Config::Hardware::ADC::Channel::bias2) };
-        if (calib && calib->getCalibItem("VDIV").name == "VDIV") {
-            CalibStruct vdivItem = calib->getCalibItem("VDIV");
-            std::istringstream istr(vdivItem.value);
-            double vdiv;
-            istr >> vdiv;
-            vdiv /= 100.;
-            logParameter(LogParameter("calib_vdiv", QString::number(vdiv), LogParameter::LOG_ONCE));
-            istr.clear();
-            istr.str(calib->getCalibItem("RSENSE").value);
-            double rsense;
-            istr >> rsense;
-            if (verbose > 2) {
-                qDebug() << "rsense:" << QString::fromStdString(calib->getCalibItem("RSENSE").value) << " (" << rsense << ")";
-            }
-            rsense /= 10. * 1000.; // yields Rsense in MOhm
-            logParameter(LogParameter("calib_rsense", QString::number(rsense * 1000.) + " kOhm", LogParameter::LOG_ONCE));
-            double ubias = v2 * vdiv;
+        if (calib) {
+            const auto& transform { calib->biasTransform() };
+            double ubias = transform.voltage(v2);
             logParameter(LogParameter("vbias", QString::number(ubias) + " V", LogParameter::LOG_AVERAGE));
             m_histo_map["Bias Voltage"]->fill(ubias);
-            double usense = (v1 - v2) * vdiv;
+            double usense = transform.sense_voltage(v1, v2);
             logParameter(LogParameter("vsense", QString::number(usense) + " V", LogParameter::LOG_AVERAGE));
-
-            CalibStruct flagItem = calib->getCalibItem("CALIB_FLAGS");
-            int calFlags = 0;
-
-            istr.clear();
-            istr.str(flagItem.value);
-            istr >> calFlags;
-            if (verbose > 2) {
-#if QT_VERSION < QT_VERSION_CHECK(5, 14, 0)
-                qDebug() << "cal flags:" << QString::fromStdString(flagItem.value) << " (" << (int)calFlags << dec << ")";
-#else
-                qDebug() << "cal flags:" << QString::fromStdString(flagItem.value) << " (" << (int)calFlags << Qt::dec << ")";
-#endif
-            }
-            double icorr = 0.;
-            if (calFlags & CalibStruct::CALIBFLAGS_CURRENT_COEFFS) {
-                double islope, ioffs;
-                istr.clear();
-                istr.str(calib->getCalibItem("COEFF2").value);
-                istr >> ioffs;
-                logParameter(LogParameter("calib_coeff2", QString::number(ioffs), LogParameter::LOG_ONCE));
-                istr.clear();
-                istr.str(calib->getCalibItem("COEFF3").value);
-                istr >> islope;
-                logParameter(LogParameter("calib_coeff3", QString::number(islope), LogParameter::LOG_ONCE));
-                icorr = ubias * islope + ioffs;
-            }
-            double ibias = usense / rsense - icorr;
+            double ibias = transform.current(v1, v2);
             m_histo_map["Bias Current"]->fill(ibias);
             logParameter(LogParameter("ibias", QString::number(ibias) + " uA", LogParameter::LOG_AVERAGE));
 
@@ -2364,6 +2745,25 @@ void Daemon::aquireMonitoringParameters()
         emit logParameter(LogParameter("meanGeoHeightMSL", QString::number(static_pos.altitude, 'f', 2) + " m", LogParameter::LOG_LATEST));
         emit logParameter(LogParameter("geoHorAccuracy", QString::number(static_pos.hor_error, 'f', 2) + " m", LogParameter::LOG_LATEST));
         emit logParameter(LogParameter("geoVertAccuracy", QString::number(static_pos.vert_error, 'f', 2) + " m", LogParameter::LOG_LATEST));
+    } else if (m_geopos_manager.get_mode() == PositionModeConfig::Mode::LockIn) {
+        const auto convergence { m_geopos_manager.get_convergence() };
+        emit logParameter(LogParameter("geoLockInHorDrift", QString::number(convergence.hor_drift, 'f', 2) + " m", LogParameter::LOG_LATEST));
+        emit logParameter(LogParameter("geoLockInVertDrift", QString::number(convergence.vert_drift, 'f', 2) + " m", LogParameter::LOG_LATEST));
+        emit logParameter(LogParameter("geoLockInEntries", QString::number(convergence.entries, 'f', 0), LogParameter::LOG_LATEST));
+    }
+}
+
+void Daemon::logCalibParameters()
+{
+    const auto& transform { calib->biasTransform() };
+    if (verbose > 2) {
+        qDebug() << "rsense:" << transform.rsense << "MOhm, vdiv:" << transform.vdiv << ", cal flags:" << static_cast<int>(calib->value(ShowerDetectorCalib::Item::CalibFlags));
+    }
+    emit logParameter(LogParameter("calib_vdiv", QString::number(transform.vdiv), LogParameter::LOG_ONCE));
+    emit logParameter(LogParameter("calib_rsense", QString::number(transform.rsense * 1000.) + " kOhm", LogParameter::LOG_ONCE));
+    if (transform.current_coeffs) {
+        emit logParameter(LogParameter("calib_coeff2", QString::number(transform.current_offset), LogParameter::LOG_ONCE));
+        emit logParameter(LogParameter("calib_coeff3", QString::number(transform.current_slope), LogParameter::LOG_ONCE));
     }
 }
 
@@ -2394,6 +2794,11 @@ void Daemon::onLogParameterPolled()
     }
 
     sendLogInfo();
+    logLatencyStatistics();
+    logEventFilterStatistics();
+    logOledStatistics();
+    logEventAnalysisSummary();
+    logTcpDispatchStatistics();
     if (verbose > 2) {
         qDebug() << "current data file:" << fileHandler->dataFileInfo().absoluteFilePath();
         qDebug() << "file size: " << fileHandler->dataFileInfo().size() / (1024 * 1024) << "MiB";
@@ -2448,6 +2853,7 @@ void Daemon::onUBXReceivedTimeTM2(const UbxTimeMarkStruct& tm)
         qDebug() << "Daemon::onUBXReceivedTimeTM2(const UbxTimeMarkStruct&): detected invalid time mark message; no rising or falling edge data";
         return;
     }
+    LatencyTracer::trace(LatencyTracer::Stage::TimeMarkDaemon);
     static UbxTimeMarkStruct lastTimeMark {};
 
     long double dts = (tm.falling.tv_sec - tm.rising.tv_sec) * 1.0e9L;
@@ -2457,27 +2863,147 @@ void Daemon::onUBXReceivedTimeTM2(const UbxTimeMarkStruct& tm)
     }
     long double interval = (tm.rising.tv_sec - lastTimeMark.rising.tv_sec) * 1.0e9L;
     interval += (tm.rising.tv_nsec - lastTimeMark.rising.tv_nsec);
-    if (interval < 1e12)
+    // with the event analysis the interval is taken in time order of the published marks
+    if (interval < 1e12 && !config.event_analysis)
         m_histo_map["UbxEventInterval"]->fill(static_cast<double>(1.0e-6L * interval));
     uint16_t diffCount = tm.evtCounter - lastTimeMark.evtCounter;
     emit timeMarkIntervalCountUpdate(diffCount, static_cast<double>(interval * 1.0e-9L));
     lastTimeMark = tm;
 
-    // output is: rising falling timeAcc valid timeBase utcAvailable
-    std::stringstream tempStream;
-    tempStream << tm.rising << tm.falling << tm.accuracy_ns << " " << tm.evtCounter << " "
-               << static_cast<short>(tm.valid) << " " << static_cast<short>(tm.timeBase) << " "
-               << static_cast<short>(tm.utcAvailable);
-    emit eventMessage(QString::fromStdString(tempStream.str()));
+    const auto correction { m_geopos_manager.gnss_filter().time_correction() };
+    if (correction.valid) {
+        emit logParameter(LogParameter("timeCorrection", QString::number(correction.offset_ns, 'f', 1) + " ns", LogParameter::LOG_AVERAGE));
+        emit logParameter(LogParameter("timeCorrectionAccuracy", QString::number(correction.accuracy_ns, 'f', 1) + " ns", LogParameter::LOG_AVERAGE));
+    }
+
+    if (!config.gnss_time_correction) {
+        publishTimeMark(tm);
+        return;
+    }
+    m_time_mark_corrector.add_time_mark(tm);
+    releaseTimeMarks();
+}
+
+void Daemon::releaseTimeMarks()
+{
+    m_corrected_time_marks.clear();
+    m_time_mark_corrector.take_ready(m_corrected_time_marks);
+    for (const auto& result : m_corrected_time_marks) {
+        if (result.quantization_corrected) {
+            emit logParameter(LogParameter("timeMarkQuantCorrection", QString::number(result.quantization_ns, 'f', 2) + " ns", LogParameter::LOG_AVERAGE));
+        }
+        if (result.clock_corrected) {
+            emit logParameter(LogParameter("timeMarkClockCorrection", QString::number(result.clock_ns, 'f', 2) + " ns", LogParameter::LOG_AVERAGE));
+        }
+        emit logParameter(LogParameter("timeMarkUncertainty", QString::number(result.uncertainty_ns, 'f', 2) + " ns", LogParameter::LOG_AVERAGE));
+        publishTimeMark(result.tm);
+    }
+    if (m_time_mark_corrector.pending() > 0 && !timeMarkReleaseTimer.isActive()) {
+        timeMarkReleaseTimer.start();
+    }
+}
+
+void Daemon::publishTimeMark(const UbxTimeMarkStruct& tm)
+{
+    // the record is encoded by each sink on its own, see EventFormatter
+    const EventRecord record { EventRecord::fromTimeMark(tm) };
+    LatencyTracer::trace(LatencyTracer::Stage::EventMessage);
+    emit eventRecord(record);
 
     if (!tm.risingValid || !tm.fallingValid) {
+        EventFormatter formatter {};
+        const auto message { formatter.format(record) };
         qDebug() << "detected timemark message with reconstructed edge time (" << QString((tm.risingValid) ? "falling" : "rising") << ")";
-        qDebug() << "msg:" << QString::fromStdString(tempStream.str());
+        qDebug() << "msg:" << QString::fromLatin1(message.data(), static_cast<int>(message.size()));
     }
 
     TcpMessage tcpMessage(TCP_MSG_KEY::MSG_UBX_TIMEMARK);
     (*tcpMessage.dStream) << tm;
     emit sendTcpMessage(tcpMessage);
+
+    if (config.event_analysis) {
+        analyseTimeMark(tm);
+    }
+}
+
+void Daemon::analyseTimeMark(const UbxTimeMarkStruct& tm)
+{
+    if (!tm.risingValid) {
+        return;
+    }
+    const std::int64_t time_ns { static_cast<std::int64_t>(tm.rising.tv_sec) * 1000000000LL + tm.rising.tv_nsec };
+    const auto result { m_event_analyzer.add_time_mark(time_ns) };
+    if (result.interval_ns > 0) {
+        m_histo_map["UbxEventInterval"]->fill(1e-6 * result.interval_ns);
+    }
+    if (!result.locked) {
+        return;
+    }
+    m_histo_map["eventMultiplicity"]->fill(result.multiplicity);
+    for (std::size_t channel = 0; channel < EventAnalyzer::max_channels; channel++) {
+        if (result.channel_mask & (1U << channel)) {
+            m_histo_map["coincidenceTimeResidual"]->fill(1e-3 * result.residual_ns[channel]);
+        }
+    }
+    if (result.tdc_matched) {
+        m_histo_map["coincidentTdcTimeDiff"]->fill(result.tdc_us);
+    }
+    if (result.multiplicity == 2) {
+        if (m_last_coincidence_ns > 0 && time_ns > m_last_coincidence_ns) {
+            m_histo_map["coincidenceInterval"]->fill(1e-6 * (time_ns - m_last_coincidence_ns));
+        }
+        m_last_coincidence_ns = time_ns;
+    }
+}
+
+void Daemon::resetEventAnalysis()
+{
+    m_event_analyzer.reset();
+    m_last_coincidence_ns = 0;
+}
+
+void Daemon::logEventAnalysisSummary()
+{
+    if (!config.event_analysis) {
+        return;
+    }
+    const auto summary { m_event_analyzer.take_summary() };
+    emit logParameter(LogParameter("eventAnalysisMarks", QString::number(summary.marks), LogParameter::LOG_LATEST));
+    emit logParameter(LogParameter("eventAnalysisRate", QString::number(summary.rate(), 'f', 3) + " Hz", LogParameter::LOG_LATEST));
+    emit logParameter(LogParameter("eventAnalysisLocked", QString::number(static_cast<int>(summary.locked)), LogParameter::LOG_ON_CHANGE));
+    emit logParameter(LogParameter("eventAnalysisAcquisitions", QString::number(summary.acquisitions), LogParameter::LOG_LATEST));
+    if (summary.analysed_marks == 0) {
+        return;
+    }
+    emit logParameter(LogParameter("eventAnalysisAnalysed", QString::number(summary.analysed_marks), LogParameter::LOG_LATEST));
+    for (std::size_t n = 0; n <= 2; n++) {
+        emit logParameter(LogParameter("eventMultiplicity" + QString::number(n), QString::number(summary.multiplicity[n]), LogParameter::LOG_LATEST));
+    }
+    const std::array<GPIO_SIGNAL, 2> channels { EVT_AND, EVT_XOR };
+    for (std::size_t channel = 0; channel < channels.size(); channel++) {
+        const QString name { "eventAnalysis" + QString::fromStdString(GPIO_SIGNAL_MAP.at(channels[channel]).name) };
+        emit logParameter(LogParameter(name + "Matches", QString::number(summary.channel_matches[channel]), LogParameter::LOG_LATEST));
+        emit logParameter(LogParameter(name + "Jitter", QString::number(summary.residual_rms_ns[channel], 'f', 0) + " ns", LogParameter::LOG_LATEST));
+    }
+    emit logParameter(LogParameter("eventAnalysisTdcMatches", QString::number(summary.tdc_matches), LogParameter::LOG_LATEST));
+}
+
+void Daemon::onUBXReceivedNavClock(uint32_t iTOW, int32_t bias, int32_t drift, uint32_t tAcc, uint32_t fAcc)
+{
+    // fAcc is given in ps/s
+    m_geopos_manager.gnss_filter().process_clock(bias, drift, tAcc, 1e-3 * fAcc);
+    if (config.gnss_time_correction) {
+        m_time_mark_corrector.add_clock(iTOW, bias, drift, tAcc);
+        releaseTimeMarks();
+    }
+}
+
+void Daemon::onUBXReceivedTimePulse(uint16_t week, uint32_t towMS, uint32_t towSubMS, int32_t qErr, bool utc)
+{
+    if (config.gnss_time_correction) {
+        m_time_mark_corrector.add_time_pulse(week, towMS, towSubMS, qErr, utc);
+        releaseTimeMarks();
+    }
 }
 
 void Daemon::updateOledDisplay()
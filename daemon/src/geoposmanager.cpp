@@ -1,14 +1,18 @@
 #include "geoposmanager.h"
 #include <QDebug>
+#include <algorithm>
 
 static constexpr double pi() { return 3.14159265358979; }
-static constexpr double sqrt2 { 1.414213562373095 };
+static constexpr double earth_radius_meters { 6367444.5 };
+static constexpr double degree_to_surface_meters { (pi() * 2 * earth_radius_meters) / 360. };
 static double sqr(double x) { return x * x; }
-constexpr size_t MIN_HISTO_ENTRIES { 10 };
+constexpr double MIN_ESTIMATOR_ENTRIES { 10. };
+constexpr double MAX_SAMPLE_ERROR_METERS { 100. };
 
 GeoPosManager::GeoPosManager(const PositionModeConfig& mode_config)
     : m_mode_config(mode_config)
 {
+    set_estimator_location(m_mode_config.filter_config);
 }
 
 void GeoPosManager::set_mode_config(const PositionModeConfig& mode_config)
@@ -16,13 +20,15 @@ void GeoPosManager::set_mode_config(const PositionModeConfig& mode_config)
     if (mode_config.filter_config != m_mode_config.filter_config) {
         switch (mode_config.filter_config) {
         case PositionModeConfig::FilterType::Kalman:
-            m_gnss_pos_kalman.reset();
+            // keep the clock model, it does not depend on the position filter
+            m_gnss_pos_kalman.reset_position();
             break;
         default:
             break;
         }
     }
     m_mode_config = mode_config;
+    set_estimator_location(m_mode_config.filter_config);
     if (m_mode_config.mode == PositionModeConfig::Mode::Static) {
         m_position = m_mode_config.static_position;
     }
@@ -33,55 +39,56 @@ auto GeoPosManager::get_mode_config() const -> const PositionModeConfig&
     return m_mode_config;
 }
 
-void GeoPosManager::set_histos(
-    std::shared_ptr<Histogram> lon,
-    std::shared_ptr<Histogram> lat,
-    std::shared_ptr<Histogram> height)
+void GeoPosManager::set_estimator_location(PositionModeConfig::FilterType filter)
 {
-    m_lon_histo = lon;
-    m_lat_histo = lat;
-    m_height_histo = height;
+    StreamingEstimator::Location location { StreamingEstimator::Location::Median };
+    switch (filter) {
+    case PositionModeConfig::FilterType::HistoMean:
+        location = StreamingEstimator::Location::Mean;
+        break;
+    case PositionModeConfig::FilterType::HistoMpv:
+        location = StreamingEstimator::Location::Mpv;
+        break;
+    default:
+        break;
+    }
+    m_lon_estimator.set_location(location);
+    m_lat_estimator.set_location(location);
+    m_height_estimator.set_location(location);
 }
 
-void GeoPosManager::new_position(const GeoPosition& new_pos)
+void GeoPosManager::new_position(const GeoPosition& new_pos, double hdop, double vdop)
 {
-    bool valid_lock_in_candidate { true };
-    const double totalPosAccuracy = new_pos.pos_error();
+    // the estimators are always fed, so that a switch of the filter type starts with a filled estimate
+    const bool lock_in { m_mode_config.mode == PositionModeConfig::Mode::LockIn };
+    if (new_pos.vert_error < MAX_SAMPLE_ERROR_METERS && (!lock_in || vdop < m_mode_config.lock_in_max_dop)) {
+        m_height_estimator.add(new_pos.altitude);
+    }
+    if (new_pos.hor_error < MAX_SAMPLE_ERROR_METERS && (!lock_in || hdop < m_mode_config.lock_in_max_dop)) {
+        m_lon_estimator.add(new_pos.longitude);
+        m_lat_estimator.add(new_pos.latitude);
+    }
+
     GeoPosition preliminary_pos {};
     switch (m_mode_config.filter_config) {
     case PositionModeConfig::FilterType::None:
         preliminary_pos = new_pos;
         break;
     case PositionModeConfig::FilterType::Kalman:
-        m_gnss_pos_kalman.process(new_pos.latitude, new_pos.longitude, new_pos.altitude, totalPosAccuracy);
+        m_gnss_pos_kalman.process(new_pos.latitude, new_pos.longitude, new_pos.altitude, new_pos.hor_error, new_pos.vert_error);
         preliminary_pos = {
             m_gnss_pos_kalman.get_longitude(),
             m_gnss_pos_kalman.get_latitude(),
             m_gnss_pos_kalman.get_altitude(),
-            m_gnss_pos_kalman.get_accuracy() / sqrt2,
-            m_gnss_pos_kalman.get_accuracy() / sqrt2
+            m_gnss_pos_kalman.get_hor_accuracy(),
+            m_gnss_pos_kalman.get_vert_accuracy()
         };
         break;
     case PositionModeConfig::FilterType::HistoMpv:
     case PositionModeConfig::FilterType::HistoMedian:
     case PositionModeConfig::FilterType::HistoMean:
-        preliminary_pos = get_pos_from_histos();
-        if (m_mode_config.mode == PositionModeConfig::Mode::LockIn) {
-            if (m_height_histo->getEntries() < MuonPi::Config::lock_in_min_histogram_entries
-                || m_lat_histo->getEntries() < MuonPi::Config::lock_in_min_histogram_entries
-                || m_lon_histo->getEntries() < MuonPi::Config::lock_in_min_histogram_entries) {
-                valid_lock_in_candidate = false;
-            }
-            if (m_height_histo->getEntries() > MuonPi::Config::lock_in_max_histogram_entries) {
-                m_height_histo->clear();
-            }
-            if (m_lat_histo->getEntries() > MuonPi::Config::lock_in_max_histogram_entries) {
-                m_lat_histo->clear();
-            }
-            if (m_lon_histo->getEntries() > MuonPi::Config::lock_in_max_histogram_entries) {
-                m_lon_histo->clear();
-            }
-        }
+        preliminary_pos = get_pos_from_estimators();
+        break;
     default:
         break;
     }
@@ -98,56 +105,60 @@ void GeoPosManager::new_position(const GeoPosition& new_pos)
         return;
     }
 
-    if (valid_lock_in_candidate) {
-        check_for_lockin_reached(preliminary_pos);
-    }
+    check_for_lockin_reached(preliminary_pos);
 }
 
-GeoPosition GeoPosManager::get_pos_from_histos() const
+GeoPosition GeoPosManager::get_pos_from_estimators() const
 {
-    constexpr double earth_radius_meters { 6367444.5 };
-    const double degree_to_surface_meters {
-        (pi() * 2 * earth_radius_meters) / 360.
-    };
-
-    if ((m_height_histo && m_height_histo->getEntries() < MIN_HISTO_ENTRIES)
-        || (m_lon_histo && m_lon_histo->getEntries() < MIN_HISTO_ENTRIES)
-        || (m_lat_histo && m_lat_histo->getEntries() < MIN_HISTO_ENTRIES)) {
+    if (m_height_estimator.entries() < MIN_ESTIMATOR_ENTRIES
+        || m_lon_estimator.entries() < MIN_ESTIMATOR_ENTRIES
+        || m_lat_estimator.entries() < MIN_ESTIMATOR_ENTRIES) {
         return GeoPosition {};
     }
 
     GeoPosition preliminary_pos {};
-    switch (m_mode_config.filter_config) {
-    case PositionModeConfig::FilterType::HistoMean:
-        preliminary_pos.altitude = m_height_histo->getMean();
-        preliminary_pos.latitude = m_lat_histo->getMean();
-        preliminary_pos.longitude = m_lon_histo->getMean();
-        break;
-    case PositionModeConfig::FilterType::HistoMedian:
-        preliminary_pos.altitude = m_height_histo->getMedian();
-        preliminary_pos.latitude = m_lat_histo->getMedian();
-        preliminary_pos.longitude = m_lon_histo->getMedian();
-        break;
-    case PositionModeConfig::FilterType::HistoMpv:
-        preliminary_pos.altitude = m_height_histo->getMpv();
-        preliminary_pos.latitude = m_lat_histo->getMpv();
-        preliminary_pos.longitude = m_lon_histo->getMpv();
-        break;
-    default:
-        return GeoPosition {};
-    }
-    preliminary_pos.vert_error = m_height_histo->getRMS();
-    preliminary_pos.hor_error = m_lat_histo->getRMS() * degree_to_surface_meters;
-    preliminary_pos.hor_error *= preliminary_pos.hor_error;
-    preliminary_pos.hor_error += sqr(m_lon_histo->getRMS() * degree_to_surface_meters / pi() * preliminary_pos.latitude / 180.);
-    preliminary_pos.hor_error = std::sqrt(preliminary_pos.hor_error);
+    preliminary_pos.altitude = m_height_estimator.value();
+    preliminary_pos.latitude = m_lat_estimator.value();
+    preliminary_pos.longitude = m_lon_estimator.value();
+    preliminary_pos.vert_error = m_height_estimator.spread();
+    preliminary_pos.hor_error = std::sqrt(
+        sqr(m_lat_estimator.spread() * degree_to_surface_meters)
+        + sqr(m_lon_estimator.spread() * degree_to_surface_meters * std::cos(preliminary_pos.latitude * pi() / 180.)));
     return preliminary_pos;
 }
 
+auto GeoPosManager::get_convergence() const -> Convergence
+{
+    const double latitude { m_lat_estimator.value() };
+    Convergence convergence {};
+    convergence.vert_drift = m_height_estimator.drift();
+    convergence.hor_drift = std::sqrt(
+        sqr(m_lat_estimator.drift() * degree_to_surface_meters)
+        + sqr(m_lon_estimator.drift() * degree_to_surface_meters * std::cos(latitude * pi() / 180.)));
+    convergence.entries = std::min({ m_height_estimator.entries(), m_lat_estimator.entries(), m_lon_estimator.entries() });
+    return convergence;
+}
+
 void GeoPosManager::check_for_lockin_reached(const GeoPosition& preliminary_pos)
 {
     if (m_mode_config.mode != PositionModeConfig::Mode::LockIn)
         return;
+    switch (m_mode_config.filter_config) {
+    case PositionModeConfig::FilterType::HistoMpv:
+    case PositionModeConfig::FilterType::HistoMedian:
+    case PositionModeConfig::FilterType::HistoMean: {
+        // the estimate has to be filled and has to have settled
+        const Convergence convergence { get_convergence() };
+        if (convergence.entries < MuonPi::Config::lock_in_min_entries
+            || convergence.hor_drift > MuonPi::Config::lock_in_max_drift_meters
+            || convergence.vert_drift > MuonPi::Config::lock_in_max_drift_meters) {
+            return;
+        }
+        break;
+    }
+    default:
+        break;
+    }
     if (preliminary_pos.vert_error < m_mode_config.lock_in_min_error_meters
         && preliminary_pos.hor_error < m_mode_config.lock_in_min_error_meters) {
         m_mode_config.mode = PositionModeConfig::Mode::Static;
@@ -191,6 +202,7 @@ auto GeoPosManager::get_mode() const -> PositionModeConfig::Mode
 void GeoPosManager::set_filter(PositionModeConfig::FilterType filter)
 {
     m_mode_config.filter_config = filter;
+    set_estimator_location(filter);
 }
 
 auto GeoPosManager::get_filter() const -> PositionModeConfig::FilterType
@@ -207,3 +219,10 @@ void GeoPosManager::set_valid_pos_callback(std::function<void(GeoPosition)> func
 {
     m_valid_pos_fn = func;
 }
+
+void GeoPosManager::reset_estimators()
+{
+    m_lon_estimator.reset();
+    m_lat_estimator.reset();
+    m_height_estimator.reset();
+}
@@ -1,4 +1,5 @@
 #include "hardware/i2c/adafruit_ssd1306.h"
+#include <algorithm>
 #include <stdint.h>
 #include <string.h>
 
@@ -91,6 +92,8 @@ The driver is used in multiple displays (128x64, 128x32, etc.).
 #define SSD1306_SETHIGHCOLUMN 0x10
 #define SSD1306_SETSTARTLINE 0x40
 #define SSD1306_MEMORYMODE 0x20
+#define SSD1306_COLUMNADDR 0x21
+#define SSD1306_PAGEADDR 0x22
 #define SSD1306_COMSCANINC 0xC0
 #define SSD1306_COMSCANDEC 0xC8
 #define SSD1306_SEGREMAP 0xA0
@@ -121,10 +124,26 @@ The driver is used in Seeed 96x96 display
 inline void Adafruit_SSD1306::fastI2Cwrite(uint8_t d)
 {
     i2cDevice::write(&d, 1);
+    m_total_transfer.bytes++;
+    m_total_transfer.transactions++;
 }
 inline void Adafruit_SSD1306::fastI2Cwrite(char* tbuf, uint32_t len)
 {
     i2cDevice::write((uint8_t*)tbuf, len);
+    m_total_transfer.bytes += len;
+    m_total_transfer.transactions++;
+}
+
+void Adafruit_SSD1306::markDirty(int16_t column, int16_t page)
+{
+    ColumnRange& range = m_dirty[page];
+    range.first = std::min(range.first, column);
+    range.last = std::max(range.last, column);
+}
+
+void Adafruit_SSD1306::markAllDirty()
+{
+    std::fill(m_dirty.begin(), m_dirty.end(), ColumnRange { 0, static_cast<int16_t>(ssd1306_lcdwidth - 1) });
 }
 
 #define _BV(bit) (1 << (bit))
@@ -158,10 +177,14 @@ void Adafruit_SSD1306::drawPixel(int16_t x, int16_t y, uint16_t color)
     p = poledbuff + (x + (y / 8) * ssd1306_lcdwidth);
 
     // x is which column
+    const uint8_t previous = *p;
     if (color == WHITE)
         *p |= _BV((y % 8));
     else
         *p &= ~_BV((y % 8));
+
+    if (*p != previous)
+        markDirty(x, y / 8);
 }
 
 // initializer for OLED Type
@@ -217,6 +240,11 @@ bool Adafruit_SSD1306::init(uint8_t OLED_TYPE, int8_t RST)
     if (!poledbuff)
         return false;
 
+    m_panel.assign(ssd1306_lcdwidth * ssd1306_lcdheight / 8, 0);
+    m_dirty.assign(ssd1306_lcdheight / 8, ColumnRange { ssd1306_lcdwidth, -1 });
+    m_tx_buffer.assign(ssd1306_lcdwidth + 1, 0);
+    m_panel_valid = false;
+
     return (true);
 }
 
@@ -284,6 +312,7 @@ void Adafruit_SSD1306::begin(void)
 
     // Empty uninitialized buffer
     clearDisplay();
+    invalidate();
     ssd1306_command(SSD_Display_On); //--turn on oled panel
 }
 
@@ -420,35 +449,61 @@ void Adafruit_SSD1306::ssd1306_data(uint8_t c)
     fastI2Cwrite(buff, sizeof(buff));
 }
 
-void Adafruit_SSD1306::display(void)
+void Adafruit_SSD1306::invalidate()
 {
-    ssd1306_command(SSD1306_SETLOWCOLUMN | 0x0); // low col = 0
-    ssd1306_command(SSD1306_SETHIGHCOLUMN | 0x0); // hi col = 0
-    ssd1306_command(SSD1306_SETSTARTLINE | 0x0); // line #0
-
-    uint16_t i = 0;
-
-    // pointer to OLED data buffer
-    uint8_t* p = poledbuff;
+    m_panel_valid = false;
+    markAllDirty();
+}
 
-    char buff[17];
-    uint8_t x;
+void Adafruit_SSD1306::display(void)
+{
+    const TransferStatistics before = m_total_transfer;
+    const std::size_t chunk = (m_chunk_size == 0) ? static_cast<std::size_t>(ssd1306_lcdwidth) : m_chunk_size;
+    startTimer();
 
     // Setup D/C to switch to data mode
-    buff[0] = SSD_Data_Mode;
-
-    // loop trough all OLED buffer and
-    // send a bunch of 16 data byte in one xmission
-    for (i = 0; i < (ssd1306_lcdwidth * ssd1306_lcdheight / 8); i += 16) {
-        for (x = 1; x <= 16; x++)
-            buff[x] = *p++;
-
-        fastI2Cwrite(buff, 17);
+    m_tx_buffer[0] = SSD_Data_Mode;
+
+    for (int16_t page = 0; page < ssd1306_lcdheight / 8; page++) {
+        ColumnRange& range = m_dirty[page];
+        int16_t first = range.first;
+        int16_t last = range.last;
+        range = ColumnRange { ssd1306_lcdwidth, -1 };
+
+        // narrow the range down to the bytes which differ from the panel content
+        const uint8_t* p = poledbuff + page * ssd1306_lcdwidth;
+        uint8_t* panel = m_panel.data() + page * ssd1306_lcdwidth;
+        if (m_panel_valid) {
+            while (first <= last && p[first] == panel[first])
+                first++;
+            while (last >= first && p[last] == panel[last])
+                last--;
+        }
+        if (first > last)
+            continue;
+
+        // the panel runs in horizontal addressing mode, so the address window restricts the transfer
+        ssd1306_command(SSD1306_COLUMNADDR, first, last);
+        ssd1306_command(SSD1306_PAGEADDR, page, page);
+        for (std::size_t column = first; column <= static_cast<std::size_t>(last); column += chunk) {
+            const std::size_t len = std::min<std::size_t>(chunk, last - column + 1);
+            memcpy(m_tx_buffer.data() + 1, p + column, len);
+            fastI2Cwrite(m_tx_buffer.data(), len + 1);
+        }
+        memcpy(panel + first, p + first, last - first + 1);
     }
+    m_panel_valid = true;
+
+    stopTimer();
+    m_last_transfer.bytes = m_total_transfer.bytes - before.bytes;
+    m_last_transfer.transactions = m_total_transfer.transactions - before.transactions;
+    m_last_transfer.bus_time = getLastTimeInterval();
+    m_total_transfer.bus_time += m_last_transfer.bus_time;
 }
 
 // clear everything (in the buffer)
 void Adafruit_SSD1306::clearDisplay(void)
 {
     memset(poledbuff, 0, (ssd1306_lcdwidth * ssd1306_lcdheight / 8));
+    markAllDirty();
 }
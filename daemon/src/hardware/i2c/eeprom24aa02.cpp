@@ -1,6 +1,11 @@
 #include "hardware/i2c/eeprom24aa02.h"
+#include <algorithm>
 #include <chrono>
+#include <cstring>
+#include <linux/i2c-dev.h>
+#include <linux/i2c.h>
 #include <stdint.h>
+#include <sys/ioctl.h>
 #include <thread>
 #include <unistd.h>
 
@@ -8,61 +13,128 @@
 * 24AA02 EEPROM
 */
 
+// max. duration of the internal write cycle (c.f. datasheet: Twc = 5 ms), used as upper limit for the ACK polling
+constexpr auto WriteCycleTimeout { std::chrono::milliseconds(10) };
+
 uint8_t EEPROM24AA02::readByte(uint8_t addr)
 {
     uint8_t val = 0;
-    startTimer();
-    readReg(addr, &val, 1); // Read the data at address location
-    stopTimer();
+    readByte(addr, &val);
     return val;
 }
 
 bool EEPROM24AA02::readByte(uint8_t addr, uint8_t* value)
 {
-    startTimer();
-    int n = readReg(addr, value, 1); // Read the data at address location
-    stopTimer();
-    return (n == 1);
+    return (readBytes(addr, 1, value) == 1);
 }
 
 void EEPROM24AA02::writeByte(uint8_t addr, uint8_t data)
 {
-    uint8_t writeBuf[2]; // Buffer to store the 2 bytes that we write to the I2C device
-
-    writeBuf[0] = addr; // address of data byte
-    writeBuf[1] = data; // data byte
-
-    startTimer();
-
-    // Write address first
-    write(writeBuf, 2);
-
-    usleep(5000);
-    stopTimer();
+    writeBytes(addr, 1, &data);
 }
 
 bool EEPROM24AA02::writeBytes(uint8_t addr, uint16_t length, uint8_t* data)
 {
-    static const uint8_t PAGESIZE = 8;
     bool success = true;
+    fLastPagesWritten = 0;
+    if (!fShadowValid) {
+        // without the current content all pages in the range have to be written
+        refresh();
+    }
     startTimer();
-    for (uint16_t i = 0; i < length;) {
+    for (uint16_t i = 0; i < length && addr + i < MEMSIZE;) {
         uint8_t currAddr = addr + i;
         // determine, how many bytes left on current page
-        uint8_t pageRemainder = PAGESIZE - currAddr % PAGESIZE;
-        if (currAddr + pageRemainder >= length)
-            pageRemainder = length - currAddr;
-        int n = writeReg(currAddr, &data[i], pageRemainder);
-        std::this_thread::sleep_for(std::chrono::microseconds(5000));
+        uint16_t pageRemainder = PAGESIZE - currAddr % PAGESIZE;
+        if (i + pageRemainder > length)
+            pageRemainder = length - i;
+        // only the range between the first and the last changed byte of the page is written
+        uint16_t first = 0;
+        uint16_t last = pageRemainder;
+        if (fShadowValid) {
+            while (first < pageRemainder && fShadow[currAddr + first] == data[i + first])
+                first++;
+            while (last > first && fShadow[currAddr + last - 1] == data[i + last - 1])
+                last--;
+        }
+        if (first < last) {
+            int n = writeReg(currAddr + first, &data[i + first], last - first);
+            // the next page is only accepted after the write cycle of this one, even if this write failed
+            const bool cycleDone = waitWriteCycle();
+            success = success && (n == last - first) && cycleDone;
+            if (n == last - first) {
+                std::copy(&data[i + first], &data[i + last], &fShadow[currAddr + first]);
+            } else {
+                fShadowValid = false;
+            }
+            fPageWriteCount[currAddr / PAGESIZE]++;
+            fLastPagesWritten++;
+        }
         i += pageRemainder;
-        success = success && (n == pageRemainder);
     }
     stopTimer();
     return success;
 }
 
+bool EEPROM24AA02::waitWriteCycle()
+{
+    // ACK polling: the device does not acknowledge its address until the internal write cycle is finished
+    // the raw read is used here, since the expected NACKs must not count as IO errors
+    const auto start { std::chrono::steady_clock::now() };
+    uint8_t dummy { 0 };
+    while (std::chrono::steady_clock::now() - start < WriteCycleTimeout) {
+        if (::read(fHandle, &dummy, 1) == 1) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    return false;
+}
+
 int16_t EEPROM24AA02::readBytes(uint8_t regAddr, uint16_t length, uint8_t* data)
 {
+    if (regAddr + length > MEMSIZE) {
+        // reads wrapping around the memory end (used by identify) always go to the device
+        return readBlock(regAddr, length, data);
+    }
+    if (!fShadowValid && !refresh()) {
+        return readBlock(regAddr, length, data);
+    }
+    std::copy(&fShadow[regAddr], &fShadow[regAddr + length], data);
+    return length;
+}
+
+bool EEPROM24AA02::refresh()
+{
+    fShadowValid = (readBlock(0, MEMSIZE, fShadow.data()) == static_cast<int16_t>(MEMSIZE));
+    return fShadowValid;
+}
+
+int16_t EEPROM24AA02::readBlock(uint8_t regAddr, uint16_t length, uint8_t* data)
+{
+    if (fHandle <= 0 || (fMode & MODE_LOCKED))
+        return 0;
+    // address write and sequential read in one combined transaction with repeated start
+    i2c_msg msgs[2] {
+        { fAddress, 0, 1, &regAddr },
+        { fAddress, I2C_M_RD, length, data }
+    };
+    i2c_rdwr_ioctl_data transfer { msgs, 2 };
+    {
+        std::lock_guard<std::mutex> lock(fMutex);
+        startTimer();
+        const int result { ioctl(fHandle, I2C_RDWR, &transfer) };
+        stopTimer();
+        if (result == 2) {
+            fNrBytesRead += length;
+            fGlobalNrBytesRead += length;
+            fNrBytesWritten++;
+            fGlobalNrBytesWritten++;
+            fMode &= ~((uint8_t)MODE_UNREACHABLE);
+            return length;
+        }
+    }
+    // the adapter does not support combined transfers, fall back to separate address write and read
     return i2cDevice::readBytes(regAddr, length, data);
 }
 
@@ -76,7 +148,7 @@ bool EEPROM24AA02::identify()
     const unsigned int N { 256 };
     uint8_t buf[N + 1];
     //	std::cout << " attempt 1: offs=0, len="<<N<<std::endl;
-    if (readBytes(0x00, N, buf) != N) {
+    if (!refresh()) {
         // somehow did not read exact same amount of bytes as it should
         return false;
     }
@@ -1,4 +1,5 @@
 #include "hardware/i2c/mcp4728.h"
+#include <algorithm>
 #include <chrono>
 #include <cmath>
 #include <iomanip>
@@ -113,6 +114,16 @@ bool MCP4728::storeSettings()
     if (!waitEepReady())
         return false;
 
+    // skip the write cycle, if the EEPROM already holds the current settings
+    const bool unchanged { std::equal(std::begin(fChannelSetting), std::end(fChannelSetting), std::begin(fChannelSettingEep),
+        [](const DacChannel& current, const DacChannel& stored) {
+            return current.value == stored.value && current.gain == stored.gain && current.vref == stored.vref && current.pd == stored.pd;
+        }) };
+    if (unchanged) {
+        stopTimer();
+        return true;
+    }
+
     buf[0] = COMMAND::DAC_EEP_SEQ_WRITE << 3;
     //buf[0] |= 0x01; // set UDAC bit
     buf[0] |= (startchannel << 1); // command DAC1 DAC0 UDAC
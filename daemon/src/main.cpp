@@ -7,6 +7,7 @@
 #include <QDir>
 #include <QHostAddress>
 #include <QObject>
+#include <algorithm>
 #include <iostream>
 #include <libconfig.h++>
 #include <termios.h>
@@ -103,6 +104,8 @@ int main(int argc, char* argv[])
     qRegisterMetaType<ADC_SAMPLING_MODE>("ADC_SAMPLING_MODE");
     qRegisterMetaType<MuonPi::Version::Version>("MuonPi::Version::Version");
     qRegisterMetaType<UbxDynamicModel>("UbxDynamicModel");
+    qRegisterMetaType<UbxValConfig>("UbxValConfig");
+    qRegisterMetaType<EventRecord>("EventRecord");
 
     qInstallMessageHandler(messageOutput);
 
@@ -304,6 +307,20 @@ int main(int argc, char* argv[])
         QCoreApplication::translate("main", "input polarity ch2 negative (0) or positive (1)"));
     parser.addOption(pol2Option);
 
+    // record/replay of the raw input streams
+    QCommandLineOption recordOption(QStringList() << "record",
+        QCoreApplication::translate("main", "record the raw input streams (gpio ticks, ubx data, adc samples) to file"),
+        QCoreApplication::translate("main", "file"));
+    parser.addOption(recordOption);
+    QCommandLineOption replayOption(QStringList() << "replay",
+        QCoreApplication::translate("main", "replay the raw input streams from a previously recorded file"),
+        QCoreApplication::translate("main", "file"));
+    parser.addOption(replayOption);
+    QCommandLineOption replaySpeedOption(QStringList() << "replay-speed",
+        QCoreApplication::translate("main", "replay speed factor (default 1, 0 = as fast as possible)"),
+        QCoreApplication::translate("main", "factor"));
+    parser.addOption(replaySpeedOption);
+
     // process the actual command line arguments given by the user
     parser.process(a);
     const QStringList args = parser.positionalArguments();
@@ -333,6 +350,27 @@ int main(int argc, char* argv[])
     } catch (const libconfig::SettingNotFoundException&) {
     }
 
+    try {
+        daemonConfig.event_analysis = cfg.lookup("event_analysis");
+    } catch (const libconfig::SettingNotFoundException&) {
+    }
+
+    try {
+        daemonConfig.event_summary_only = cfg.lookup("event_summary_only");
+    } catch (const libconfig::SettingNotFoundException&) {
+    }
+
+    try {
+        int window_us = cfg.lookup("event_coincidence_window");
+        daemonConfig.event_coincidence_window = std::chrono::microseconds { std::max(window_us, 0) };
+    } catch (const libconfig::SettingNotFoundException&) {
+    }
+
+    try {
+        daemonConfig.gnss_time_correction = cfg.lookup("gnss_time_correction");
+    } catch (const libconfig::SettingNotFoundException&) {
+    }
+
     try {
         int model = cfg.lookup("gnss_dynamic_model");
         daemonConfig.gnss_dynamic_model = static_cast<UbxDynamicModel>(model);
@@ -383,8 +421,36 @@ int main(int argc, char* argv[])
                 qWarning() << "No 'ublox_baud' setting in configuration file. Assuming" << daemonConfig.gnss_baudrate;
         }
 
+    try {
+        int maxBaudrateCfg = cfg.lookup("ublox_max_baud");
+        if (verbose > 2)
+            qInfo() << "ublox max baudrate:" << maxBaudrateCfg;
+        daemonConfig.gnss_max_baudrate = std::max(0, maxBaudrateCfg);
+    } catch (const libconfig::SettingNotFoundException& nfex) {
+        if (verbose > 1)
+            qWarning() << "No 'ublox_max_baud' setting in configuration file. Assuming" << daemonConfig.gnss_max_baudrate;
+    }
+
     daemonConfig.gnss_config = parser.isSet(showGnssConfigOption);
 
+    if (parser.isSet(recordOption)) {
+        daemonConfig.capture_file = parser.value(recordOption);
+    }
+    if (parser.isSet(replayOption)) {
+        daemonConfig.replay_file = parser.value(replayOption);
+        if (daemonConfig.replay_file == daemonConfig.capture_file) {
+            qCritical() << "replay and record file must not be identical";
+            return -1;
+        }
+    }
+    if (parser.isSet(replaySpeedOption)) {
+        daemonConfig.replay_speed = parser.value(replaySpeedOption).toDouble(&ok);
+        if (!ok) {
+            daemonConfig.replay_speed = 1.;
+            qWarning() << "wrong input for replay speed...using default:" << daemonConfig.replay_speed;
+        }
+    }
+
     try {
         int port = cfg.lookup("tcp_port");
         if (verbose > 2)
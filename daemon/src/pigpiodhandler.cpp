@@ -1,4 +1,5 @@
 #include "utility/gpio_mapping.h"
+#include "utility/latencytracer.h"
 #include <QDebug>
 #include <QPointer>
 #include <cmath>
@@ -75,6 +76,9 @@ void calcLinearCoefficients(int n, quint64* xarray, qint64* yarray,
     *offs = (double)(b + offsy);
 }
 
+static void processTick(QPointer<PigpiodHandler> pigpioHandler, unsigned int user_gpio,
+    unsigned int level, uint32_t tick);
+
 /* This is the central interrupt routine for all registered GPIO pins
  *
  */
@@ -92,29 +96,32 @@ static void cbFunction(int user_pi, unsigned int user_gpio,
 
     QPointer<PigpiodHandler> pigpioHandler = pigHandlerAddress;
 
+    // live input is muted while recorded data is replayed
+    if (pigpioHandler->isReplayMode())
+        return;
+
+    InputRecorder* recorder = pigpioHandler->inputRecorder();
+    if (recorder != nullptr) {
+        recorder->recordGpioTick(user_gpio, level, tick);
+    }
+
+    processTick(pigpioHandler, user_gpio, level, tick);
+}
+
+/* Processing of a single GPIO edge, either coming live from the pigpio callback
+ * or injected from a replayed capture
+ */
+static void processTick(QPointer<PigpiodHandler> pigpioHandler, unsigned int user_gpio,
+    unsigned int level, uint32_t tick)
+{
     if (pigpioHandler->isInhibited())
         return;
 
     static uint32_t lastTriggerTick = 0;
-    static uint32_t lastTick = 0;
-    static uint16_t pileupCounter = 0;
-
-    // look, if the last event occured just recently
-    // if so, count the pileup counter up
-    // count down if not
-    if (tick - lastTick < MuonPi::Config::event_count_deadtime_ticks) {
-        pileupCounter++;
-        // if more than a certain number of pileups happened in a short period of time, leave immediately
-        if (pileupCounter > MuonPi::Config::event_count_max_pileups) {
-            pileupCounter = MuonPi::Config::event_count_max_pileups;
-            lastTick = tick;
-            return;
-        }
-    } else if (pileupCounter > 0) {
-        pileupCounter--;
-    }
 
-    lastTick = tick;
+    // suppress bursts, edges without coincidence and edges within the deadtime right at the source
+    if (pigpioHandler->eventFilter().process(user_gpio, tick) != EventFilter::Verdict::Accepted)
+        return;
 
     try {
         // allow only registered signals to be processed here
@@ -167,20 +174,28 @@ static void cbFunction(int user_pi, unsigned int user_gpio,
             }
         }
 
+        LatencyTracer::trace(LatencyTracer::Stage::GpioCallback);
         emit pigpioHandler->signal(user_gpio);
+        emit pigpioHandler->gpioEvent(user_gpio, tick);
 
         // level gives the information if it is up or down (only important if trigger is
         // at both: rising and falling edge)
     } catch (std::exception& e) {
         pigpioHandler = 0;
         pigpio_stop(pi);
-        qCritical() << "Exception catched in 'static void cbFunction(int user_pi, unsigned int user_gpio, unsigned int level, uint32_t tick)':" << e.what();
-        qCritical() << "with user_pi=" << user_pi << "user_gpio=" << user_gpio << "level=" << level << "tick=" << tick;
+        qCritical() << "Exception catched in 'static void processTick(QPointer<PigpiodHandler> pigpioHandler, unsigned int user_gpio, unsigned int level, uint32_t tick)':" << e.what();
+        qCritical() << "with user_gpio=" << user_gpio << "level=" << level << "tick=" << tick;
     }
 }
 
-PigpiodHandler::PigpiodHandler(QVector<unsigned int> gpioPins, unsigned int spi_freq, uint32_t spi_flags, QObject* parent)
+void PigpiodHandler::injectTick(unsigned int gpio, unsigned int level, quint32 tick)
+{
+    processTick(this, gpio, level, tick);
+}
+
+PigpiodHandler::PigpiodHandler(QVector<unsigned int> gpioPins, EventFilter::Config filter_config, unsigned int spi_freq, uint32_t spi_flags, QObject* parent)
     : QObject(parent)
+    , m_event_filter { std::move(filter_config) }
 {
     startOfProgram = QDateTime::currentDateTimeUtc();
     lastSamplingTime = startOfProgram;
@@ -188,6 +203,18 @@ PigpiodHandler::PigpiodHandler(QVector<unsigned int> gpioPins, unsigned int spi_
     pigHandlerAddress = this;
     spiClkFreq = spi_freq;
     spiFlags = spi_flags;
+    m_gpio_pins = std::move(gpioPins);
+    gpioClockTimeMeasurementTimer.setInterval(MuonPi::Config::Hardware::GPIO::Clock::Measurement::interval);
+    gpioClockTimeMeasurementTimer.setSingleShot(false);
+    connect(&gpioClockTimeMeasurementTimer, &QTimer::timeout, this, &PigpiodHandler::measureGpioClockTime);
+    gpioClockTimeMeasurementTimer.start();
+}
+
+void PigpiodHandler::initialise()
+{
+    if (isInitialised) {
+        return;
+    }
     pi = pigpio_start((char*)"127.0.0.1", (char*)"8888");
     if (pi < 0) {
         qFatal("Could not connect to pigpio daemon. Is pigpiod running? Start with sudo pigpiod -s 1");
@@ -196,7 +223,7 @@ PigpiodHandler::PigpiodHandler(QVector<unsigned int> gpioPins, unsigned int spi_
 
     isInitialised = true;
 
-    for (auto& gpioPin : gpioPins) {
+    for (auto& gpioPin : m_gpio_pins) {
         set_mode(pi, gpioPin, PI_INPUT);
 
         int result = callback(pi, gpioPin, RISING_EDGE, cbFunction);
@@ -204,10 +231,7 @@ PigpiodHandler::PigpiodHandler(QVector<unsigned int> gpioPins, unsigned int spi_
             qCritical() << "error registering gpio callback for BCM pin" << gpioPin;
         }
     }
-    gpioClockTimeMeasurementTimer.setInterval(MuonPi::Config::Hardware::GPIO::Clock::Measurement::interval);
-    gpioClockTimeMeasurementTimer.setSingleShot(false);
-    connect(&gpioClockTimeMeasurementTimer, &QTimer::timeout, this, &PigpiodHandler::measureGpioClockTime);
-    gpioClockTimeMeasurementTimer.start();
+    emit initialisationFinished();
 }
 
 void PigpiodHandler::setInput(unsigned int gpio)
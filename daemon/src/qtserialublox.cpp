@@ -1,7 +1,10 @@
 #include "qtserialublox.h"
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QEventLoop>
 #include <QThread>
+#include <algorithm>
+#include <config.h>
 #include <iomanip>
 #include <iostream>
 #include <muondetector_structs.h>
@@ -71,84 +74,275 @@ void QtSerialUblox::makeConnection()
     ackTimer = new QTimer();
     ackTimer->setSingleShot(true);
     connect(ackTimer, &QTimer::timeout, this, &QtSerialUblox::ackTimeout);
+    if (!m_replay_mode) {
+        negotiateBaudRate();
+    }
     connect(serialPort, &QSerialPort::readyRead, this, &QtSerialUblox::onReadyRead);
     serialPort->clear(QSerialPort::AllDirections);
+    m_utilization_timer = new QTimer(this);
+    connect(m_utilization_timer, &QTimer::timeout, this, &QtSerialUblox::emitLinkUtilization);
+    m_utilization_timer->start(MuonPi::Config::Hardware::GNSS::utilization_interval);
+    if (!m_replay_mode) {
+        m_link_watchdog = new QTimer(this);
+        connect(m_link_watchdog, &QTimer::timeout, this, &QtSerialUblox::checkLink);
+        m_link_watchdog->start(MuonPi::Config::Hardware::GNSS::link_timeout);
+    }
     if (verbose > 2) {
         emit toConsole("rising               falling               accEst valid timebase utc\n");
     }
 }
 
-void QtSerialUblox::sendQueuedMsg(bool afterTimeout)
+void QtSerialUblox::sendQueuedMsg()
+{
+    // messages are handed to the receiver as long as the window has room,
+    // the acknowledges arrive in the same order the messages were sent
+    while (!outMsgBuffer.empty() && m_in_flight.size() < MuonPi::Config::Hardware::GNSS::send_window) {
+        m_in_flight.push_back(PendingMessage { outMsgBuffer.front(), std::chrono::steady_clock::now(), 0 });
+        outMsgBuffer.pop();
+        sendUBX(m_in_flight.back().message);
+        if (verbose > 3)
+            emit toConsole("sendQueuedMsg: sent fresh message\n");
+    }
+    restartAckTimer();
+}
+
+void QtSerialUblox::restartAckTimer()
 {
-    if (afterTimeout) {
-        if (!msgWaitingForAck) {
-            return;
+    if (ackTimer.isNull()) {
+        return;
+    }
+    if (m_in_flight.empty()) {
+        ackTimer->stop();
+        return;
+    }
+    // resent messages keep their place in the window, so the oldest send time is not necessarily at the front
+    const auto oldest { std::min_element(m_in_flight.begin(), m_in_flight.end(), [](const PendingMessage& lhs, const PendingMessage& rhs) {
+        return lhs.sent < rhs.sent;
+    }) };
+    const auto elapsed { std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - oldest->sent) };
+    ackTimer->start(std::max<int>(0, timeout - static_cast<int>(elapsed.count())));
+}
+
+void QtSerialUblox::ackTimeout()
+{
+    const auto now { std::chrono::steady_clock::now() };
+    for (auto it { m_in_flight.begin() }; it != m_in_flight.end();) {
+        if (now - it->sent < std::chrono::milliseconds { timeout }) {
+            ++it;
+            continue;
+        }
+        if (it->answered) {
+            // the answer to the earlier transmission got lost, nothing is outstanding anymore
+            it = m_in_flight.erase(it);
+            continue;
+        }
+        if (verbose > 2) {
+            std::stringstream tempStream;
+            tempStream << "ack timeout, trying to resend message 0x" << std::setfill('0') << std::setw(2) << std::hex
+                       << static_cast<int>(it->message.class_id()) << " 0x" << std::setfill('0') << std::setw(2) << std::hex << static_cast<int>(it->message.message_id());
+            for (unsigned int i = 0; i < it->message.payload().size(); i++) {
+                tempStream << " 0x" << std::setfill('0') << std::setw(2) << std::hex << (int)(it->message.payload()[i]);
+            }
+            tempStream << std::endl;
+            emit toConsole(QString::fromStdString(tempStream.str()));
         }
-        if (++sendRetryCounter >= MAX_SEND_RETRIES) {
-            sendRetryCounter = 0;
-            ackTimer->stop();
-            msgWaitingForAck.reset(nullptr);
+        if (++it->retries >= MAX_SEND_RETRIES) {
+            // a message without any answer is reported like a NAK
+            const std::string& payload { it->message.payload() };
+            emit UBXReceivedAckNak(it->message.full_id(),
+                (payload.size() < 2) ? 0 : (uint16_t)((uint8_t)payload[0]) << 8U | (uint8_t)payload[1]);
+            it = m_in_flight.erase(it);
             if (verbose > 2)
                 emit toConsole("sendQueuedMsg: deleted message after 5 timeouts\n");
-            sendQueuedMsg();
-            return;
+            continue;
         }
-        ackTimer->start(timeout);
-        sendUBX(*msgWaitingForAck);
+        it->sent = now;
+        it->unanswered++;
+        sendUBX(it->message);
         if (verbose > 2)
             emit toConsole("sendQueuedMsg: repeated resend after timeout\n");
-        return;
+        ++it;
     }
-    if (outMsgBuffer.empty()) {
+    sendQueuedMsg();
+}
+
+void QtSerialUblox::onReadyRead()
+{
+    // this function gets called when the serial port emits readyRead signal
+    if (serialPort.isNull() || m_negotiating) {
         return;
     }
-    if (msgWaitingForAck) {
-        if (verbose > 2) {
-            emit toConsole("tried to send queued message but ack for previous message not yet received\n");
-        }
+    QByteArray temp = serialPort->readAll();
+    m_rx_bytes += static_cast<quint64>(temp.size());
+    // live input is muted while recorded data is replayed
+    if (m_replay_mode) {
         return;
     }
-    msgWaitingForAck = std::make_unique<UbxMessage>(outMsgBuffer.front());
-    outMsgBuffer.pop();
-    ackTimer->start(timeout);
-    sendUBX(*msgWaitingForAck);
-    if (verbose > 3)
-        emit toConsole("sendQueuedMsg: sent fresh message\n");
+    if (m_input_recorder != nullptr) {
+        m_input_recorder->recordUbxData(temp.constData(), static_cast<std::size_t>(temp.size()));
+    }
+    processRawData(temp);
 }
 
-void QtSerialUblox::ackTimeout()
+void QtSerialUblox::negotiateBaudRate()
 {
-    if (!msgWaitingForAck) {
+    if (serialPort.isNull()) {
         return;
     }
-    if (verbose > 2) {
-        std::stringstream tempStream;
-        tempStream << "ack timeout, trying to resend message 0x" << std::setfill('0') << std::setw(2) << std::hex
-                   << static_cast<int>(msgWaitingForAck->class_id()) << " 0x" << std::setfill('0') << std::setw(2) << std::hex << static_cast<int>(msgWaitingForAck->message_id());
-        for (unsigned int i = 0; i < msgWaitingForAck->payload().size(); i++) {
-            tempStream << " 0x" << std::setfill('0') << std::setw(2) << std::hex << (int)(msgWaitingForAck->payload()[i]);
+    m_negotiating = true;
+    // look for the receiver at the configured baud rate first, then at all other candidates
+    std::vector<int> candidates { _baudRate };
+    for (const int baudRate : MuonPi::Config::Hardware::GNSS::baud_rates) {
+        if (baudRate != _baudRate) {
+            candidates.push_back(baudRate);
+        }
+    }
+    uint8_t outProtocolMask { 0 };
+    int detected { 0 };
+    for (const int baudRate : candidates) {
+        if (probeBaudRate(baudRate, outProtocolMask)) {
+            detected = baudRate;
+            break;
         }
-        tempStream << std::endl;
-        emit toConsole(QString::fromStdString(tempStream.str()));
     }
-    sendQueuedMsg(true);
+    if (detected == 0) {
+        emit toConsole(QString("could not detect the baud rate of the gnss receiver, using %1\n").arg(_baudRate));
+        serialPort->setBaudRate(_baudRate);
+        m_negotiating = false;
+        return;
+    }
+    if (verbose > 1) {
+        emit toConsole(QString("detected gnss receiver at %1 baud\n").arg(detected));
+    }
+    _baudRate = detected;
+    // the out protocols of the port are kept, so without the port configuration the rate cannot be changed
+    if (outProtocolMask != 0) {
+        // step down from the highest allowed rate until the receiver answers at the new rate
+        const auto& rates { MuonPi::Config::Hardware::GNSS::baud_rates };
+        for (auto it { rates.rbegin() }; it != rates.rend() && *it > detected; ++it) {
+            if (*it > m_max_baud_rate) {
+                continue;
+            }
+            if (switchBaudRate(*it, outProtocolMask)) {
+                _baudRate = *it;
+                break;
+            }
+            if (verbose > 1) {
+                emit toConsole(QString("gnss receiver did not answer at %1 baud\n").arg(*it));
+            }
+        }
+    }
+    serialPort->setBaudRate(_baudRate);
+    m_negotiating = false;
+    emit UBXBaudRateChanged(static_cast<uint32_t>(_baudRate));
 }
 
-void QtSerialUblox::onReadyRead()
+auto QtSerialUblox::probeBaudRate(int baudRate, uint8_t& outProtocolMask) -> bool
 {
-    // this function gets called when the serial port emits readyRead signal
-    if (serialPort.isNull()) {
+    outProtocolMask = 0;
+    serialPort->setBaudRate(baudRate);
+    serialPort->clear(QSerialPort::AllDirections);
+    const std::string poll { UbxMessage { UBX_MSG::CFG_PRT, std::string(1, static_cast<char>(s_default_target)) }.raw_message_string() };
+    serialPort->write(poll.c_str(), static_cast<qint64>(poll.size()));
+    serialPort->waitForBytesWritten(MuonPi::Config::Hardware::GNSS::baud_probe_timeout);
+
+    std::string buffer {};
+    bool valid { false };
+    QElapsedTimer elapsed {};
+    elapsed.start();
+    // any valid message proves the baud rate, the port configuration may take longer behind the periodic output
+    auto deadline = [&valid]() {
+        return (valid) ? MuonPi::Config::Hardware::GNSS::baud_probe_response_timeout : MuonPi::Config::Hardware::GNSS::baud_probe_timeout;
+    };
+    while (elapsed.elapsed() < deadline()) {
+        if (!serialPort->waitForReadyRead(static_cast<int>(deadline() - elapsed.elapsed()))) {
+            break;
+        }
+        const QByteArray data { serialPort->readAll() };
+        m_rx_bytes += static_cast<quint64>(data.size());
+        buffer.append(data.constData(), static_cast<std::size_t>(data.size()));
+        UbxMessage message {};
+        while (scanUnknownMessage(buffer, message)) {
+            valid = true;
+            if (message.full_id() == UBX_MSG::CFG_PRT && message.payload().size() >= 20
+                && static_cast<uint8_t>(message.payload()[0]) == s_default_target) {
+                outProtocolMask = static_cast<uint8_t>(message.payload()[14]);
+                return true;
+            }
+        }
+    }
+    return valid;
+}
+
+auto QtSerialUblox::switchBaudRate(int baudRate, uint8_t outProtocolMask) -> bool
+{
+    const int previous { static_cast<int>(serialPort->baudRate()) };
+    writeCfgPrt(baudRate, outProtocolMask);
+    uint8_t mask { 0 };
+    if (probeBaudRate(baudRate, mask)) {
+        return true;
+    }
+    // the new rate is not stable, if the receiver switched at all it is sent back to the previous rate
+    writeCfgPrt(previous, outProtocolMask);
+    probeBaudRate(previous, mask);
+    return false;
+}
+
+void QtSerialUblox::writeCfgPrt(int baudRate, uint8_t outProtocolMask)
+{
+    const std::string raw { UbxMessage { UBX_MSG::CFG_PRT, cfgPrtPayload(s_default_target, outProtocolMask, baudRate) }.raw_message_string() };
+    serialPort->write(raw.c_str(), static_cast<qint64>(raw.size()));
+    serialPort->waitForBytesWritten(MuonPi::Config::Hardware::GNSS::baud_probe_timeout);
+    m_tx_bytes += raw.size();
+    QThread::msleep(MuonPi::Config::Hardware::GNSS::baud_switch_settle);
+}
+
+void QtSerialUblox::emitLinkUtilization()
+{
+    const double seconds { std::chrono::duration<double>(MuonPi::Config::Hardware::GNSS::utilization_interval).count() };
+    // 8N1: ten bits on the line per byte
+    const double capacity { _baudRate / 10. * seconds };
+    emit UBXLinkUtilization(static_cast<uint32_t>(_baudRate), m_rx_bytes / capacity, m_tx_bytes / capacity);
+    m_rx_bytes = 0;
+    m_tx_bytes = 0;
+}
+
+void QtSerialUblox::checkLink()
+{
+    if (m_replay_mode) {
         return;
     }
-    QByteArray temp = serialPort->readAll();
+    if (m_rx_frames > 0) {
+        m_link_established = true;
+        m_link_probed = false;
+    } else if (m_link_established && !m_link_probed) {
+        // the periodic messages may be slower than the check interval, a poll at the current rate has to be answered
+        m_link_probed = true;
+        sendUBX(UbxMessage { UBX_MSG::CFG_PRT, std::string(1, static_cast<char>(s_default_target)) });
+    } else if (m_link_established) {
+        // the receiver fell back to its stored baud rate, e.g. after a power cycle or a watchdog reset
+        m_link_established = false;
+        m_link_probed = false;
+        emit toConsole("no ubx message from the gnss receiver, detecting its baud rate again\n");
+        negotiateBaudRate();
+    }
+    m_rx_frames = 0;
+}
+
+void QtSerialUblox::injectRawData(const QByteArray& data)
+{
+    processRawData(data);
+}
+
+void QtSerialUblox::processRawData(const QByteArray& temp)
+{
     if (dumpRaw) {
         emit toConsole(QString(temp));
     }
-    for (int i = 0; i < temp.size(); i++) {
-        m_buffer += temp.data()[i];
-    }
+    m_buffer.append(temp.constData(), static_cast<std::size_t>(temp.size()));
     UbxMessage message;
     while (scanUnknownMessage(m_buffer, message)) {
+        m_rx_frames++;
         // so it found a message therefore we can now process the message
         if (showin) {
             std::stringstream tempStream {};
@@ -244,31 +438,45 @@ bool QtSerialUblox::sendUBX(uint16_t msgID, unsigned char* payload, uint16_t nBy
 
 bool QtSerialUblox::sendUBX(const UbxMessage& msg)
 {
-    std::string raw_data_string { msg.raw_message_string() };
-    if (!serialPort.isNull()) {
-        QByteArray block(raw_data_string.c_str(), raw_data_string.size());
-        if (serialPort->write(block)) {
-            if (serialPort->waitForBytesWritten(timeout)) {
-                if (showout) {
-                    std::stringstream tempStream {};
-                    tempStream << "out: ";
-                    for (std::string::size_type i = 2; i < raw_data_string.length(); i++) {
-                        tempStream << "0x" << std::setfill('0') << std::setw(2) << std::hex << (int)raw_data_string[i] << " ";
-                    }
-                    tempStream << "\n";
-                    emit toConsole(QString::fromStdString(tempStream.str()));
-                }
-                return true;
-            } else {
-                emit toConsole("wait for bytes written timeout while trying to write to serialPort\n");
-            }
-        } else {
-            emit toConsole("error writing to serialPort\n");
-        }
-    } else {
+    if (serialPort.isNull()) {
         emit toConsole("error: serialPort not instantiated\n");
+        return false;
+    }
+    const std::string raw_data_string { msg.raw_message_string() };
+    m_tx_buffer.append(raw_data_string.c_str(), static_cast<int>(raw_data_string.size()));
+    if (showout) {
+        std::stringstream tempStream {};
+        tempStream << "out: ";
+        for (std::string::size_type i = 2; i < raw_data_string.length(); i++) {
+            tempStream << "0x" << std::setfill('0') << std::setw(2) << std::hex << (int)raw_data_string[i] << " ";
+        }
+        tempStream << "\n";
+        emit toConsole(QString::fromStdString(tempStream.str()));
+    }
+    if (!m_tx_flush_scheduled) {
+        m_tx_flush_scheduled = true;
+        QTimer::singleShot(0, this, &QtSerialUblox::flushTxBuffer);
+    }
+    return true;
+}
+
+void QtSerialUblox::flushTxBuffer()
+{
+    m_tx_flush_scheduled = false;
+    if (serialPort.isNull() || m_tx_buffer.isEmpty()) {
+        return;
+    }
+    const qint64 written { serialPort->write(m_tx_buffer) };
+    if (written < 0) {
+        emit toConsole("error writing to serialPort\n");
+        return;
+    }
+    m_tx_buffer.remove(0, static_cast<int>(written));
+    m_tx_bytes += static_cast<quint64>(written);
+    if (!m_tx_buffer.isEmpty()) {
+        m_tx_flush_scheduled = true;
+        QTimer::singleShot(0, this, &QtSerialUblox::flushTxBuffer);
     }
-    return false;
 }
 
 void QtSerialUblox::UBXSetCfgRate(uint16_t measRate, uint16_t navRate)
@@ -299,15 +507,20 @@ void QtSerialUblox::UBXSetCfgPrt(uint8_t port, uint8_t outProtocolMask)
     if (verbose > 3) {
         emit toConsole(QString("Ublox UBXSetCfgPort running in thread " + QString("0x%1\n").arg((int)syscall(SYS_gettid))));
     }
+    if (port >= s_nr_targets) {
+        emit UBXCfgError("port > " + QString::number(s_nr_targets - 1) + " is not possible");
+        return;
+    }
+    enqueueMsg(UBX_MSG::CFG_PRT, cfgPrtPayload(port, outProtocolMask, _baudRate));
+}
+
+auto QtSerialUblox::cfgPrtPayload(uint8_t port, uint8_t outProtocolMask, int baudRate) const -> std::string
+{
     unsigned char data[20];
     // initialise all contents from data as 0 first!
     for (int i = 0; i < 20; i++) {
         data[i] = 0;
     }
-    if (port >= s_nr_targets) {
-        emit UBXCfgError("port > " + QString::number(s_nr_targets - 1) + " is not possible");
-        return;
-    }
     if (port == 1) {
         // port 1 is UART port, payload for other ports may differ
         // setup payload. Bit masks are set up byte wise from lowest to highest byte
@@ -323,9 +536,9 @@ void QtSerialUblox::UBXSetCfgPrt(uint8_t port, uint8_t outProtocolMask)
         data[7] = 0; //part of mode option but no meaning
 
         // baudrate: (check if it works)
-        data[8] = (uint8_t)(((uint32_t)_baudRate) & 0x000000ff);
-        data[9] = (uint8_t)((((uint32_t)_baudRate) & 0x0000ff00) >> 8);
-        data[10] = (uint8_t)((((uint32_t)_baudRate) & 0x00ff0000) >> 16);
+        data[8] = (uint8_t)(((uint32_t)baudRate) & 0x000000ff);
+        data[9] = (uint8_t)((((uint32_t)baudRate) & 0x0000ff00) >> 8);
+        data[10] = (uint8_t)((((uint32_t)baudRate) & 0x00ff0000) >> 16);
         data[11] = 0; //not needed because baudRate will never be over 16777216 (2^24)
 
         // inProtoMask enables/disables possible protocols for sending messages to the gps module:
@@ -342,7 +555,7 @@ void QtSerialUblox::UBXSetCfgPrt(uint8_t port, uint8_t outProtocolMask)
         data[18] = 0;
         data[19] = 0; // reserved
     }
-    enqueueMsg(UBX_MSG::CFG_PRT, toStdString(data, 20));
+    return toStdString(data, 20);
 }
 
 void QtSerialUblox::UBXSetCfgMsgRate(uint16_t msgID, uint8_t port, uint8_t rate)
@@ -384,6 +597,10 @@ void QtSerialUblox::UBXReset(uint32_t resetFlags)
 
     UbxMessage newMessage { UBX_MSG::CFG_RST, toStdString(data, 4) };
     sendUBX(newMessage);
+    // the receiver comes back with the baud rate of its stored configuration
+    if (!m_replay_mode) {
+        QTimer::singleShot(MuonPi::Config::Hardware::GNSS::reset_settle, this, &QtSerialUblox::negotiateBaudRate);
+    }
 }
 
 void QtSerialUblox::UBXSetMinMaxSVs(uint8_t minSVs, uint8_t maxSVs)
@@ -450,6 +667,21 @@ void QtSerialUblox::UBXSaveCfg(uint8_t devMask)
     enqueueMsg(UBX_MSG::CFG_CFG, toStdString(data, 13));
 }
 
+void QtSerialUblox::UBXValSet(const UbxValConfig& config, uint8_t layers)
+{
+    // all messages of a transaction are queued at once, the receiver applies them with the last one
+    for (const auto& payload : config.valset_payloads(layers)) {
+        enqueueMsg(UBX_MSG::CFG_VALSET, payload);
+    }
+}
+
+void QtSerialUblox::UBXValGet(const UbxValConfig& config)
+{
+    for (const auto& payload : config.valget_payloads()) {
+        enqueueMsg(UBX_MSG::CFG_VALGET, payload);
+    }
+}
+
 void QtSerialUblox::onRequestGpsProperties()
 {
 }
@@ -480,17 +712,17 @@ void QtSerialUblox::pollMsg(uint16_t msgID)
     case UBX_MSG::CFG_PRT: // CFG-PRT
         // in this special case "rate" is the port ID
         temp[0] = 1;
-        outMsgBuffer.push(UbxMessage { msgID, toStdString(temp, 1) });
-        if (!msgWaitingForAck) {
-            sendQueuedMsg();
-        }
+        enqueueMsg(msgID, toStdString(temp, 1));
         break;
     case UBX_MSG::MON_VER:
         // the VER message apparently does not confirm reception with an ACK
+        m_pending_polls[msgID] = std::chrono::steady_clock::now();
         sendUBX(UbxMessage { msgID, "" });
         break;
     default:
         // for most messages the poll msg is just the message without payload
+        // the poll does not occupy the ack window, only the response is awaited
+        m_pending_polls[msgID] = std::chrono::steady_clock::now();
         sendUBX(UbxMessage { msgID, "" });
         break;
     }
@@ -510,7 +742,5 @@ void QtSerialUblox::enqueueMsg(uint16_t msgID, const std::string& payload)
 {
     UbxMessage newMessage { msgID, payload };
     outMsgBuffer.push(newMessage);
-    if (!msgWaitingForAck) {
-        sendQueuedMsg();
-    }
+    sendQueuedMsg();
 }
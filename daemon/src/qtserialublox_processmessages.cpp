@@ -1,4 +1,5 @@
 #include "qtserialublox.h"
+#include "utility/latencytracer.h"
 #include "utility/unixtime_from_gps.h"
 #include <custom_io_operators.h>
 
@@ -6,6 +7,7 @@
 #include <ublox_messages.h>
 
 #include <QThread>
+#include <algorithm>
 #include <cctype>
 #include <iomanip>
 #include <sstream>
@@ -65,7 +67,7 @@ void QtSerialUblox::processMessage(const UbxMessage& msg)
         { UBX_MSG::NAV_STATUS, std::make_pair([&] { UBXNavStatus(msg.payload()); }, "UBX-NAV-STATUS") }, { UBX_MSG::NAV_DOP, std::make_pair([&] { UBXNavDOP(msg.payload()); }, "UBX-NAV-DOP") }, { UBX_MSG::NAV_TIMEGPS, std::make_pair([&] { UBXNavTimeGPS(msg.payload()); }, "UBX-NAV-TIMEGPS") }, { UBX_MSG::NAV_TIMEUTC, std::make_pair([&] { UBXNavTimeUTC(msg.payload()); }, "UBX-NAV-TIMEUTC") }, { UBX_MSG::NAV_CLOCK, std::make_pair([&] { UBXNavClock(msg.payload()); }, "UBX-NAV-CLOCK") }, { UBX_MSG::NAV_SVINFO, std::make_pair([&] { UBXNavSVinfo(msg.payload(), true); }, "UBX-NAV-SVINFO") }, { UBX_MSG::NAV_SAT, std::make_pair([&] { UBXNavSat(msg.payload(), true); }, "UBX-NAV-SAT") }, { UBX_MSG::NAV_POSLLH, std::make_pair([&] { UBXNavPosLLH(msg.payload()); }, "UBX-NAV-POSLLH") }
 
         ,
-        { UBX_MSG::CFG_ANT, std::make_pair([&] { UBXCfgAnt(msg.payload()); }, "UBX-CFG-ANT") }, { UBX_MSG::CFG_NAVX5, std::make_pair([&] { UBXCfgNavX5(msg.payload()); }, "UBX-CFG-NAVX5") }, { UBX_MSG::CFG_NAV5, std::make_pair([&] { UBXCfgNav5(msg.payload()); }, "UBX-CFG-NAV5") }, { UBX_MSG::CFG_TP5, std::make_pair([&] { UBXCfgTP5(msg.payload()); }, "UBX-CFG-TP5") }, { UBX_MSG::CFG_GNSS, std::make_pair([&] { UBXCfgGNSS(msg.payload()); }, "UBX-CFG-GNSS") }, { UBX_MSG::CFG_MSG, std::make_pair([&] { UBXCfgMSG(msg.payload()); }, "UBX-CFG-MSG") }
+        { UBX_MSG::CFG_ANT, std::make_pair([&] { UBXCfgAnt(msg.payload()); }, "UBX-CFG-ANT") }, { UBX_MSG::CFG_NAVX5, std::make_pair([&] { UBXCfgNavX5(msg.payload()); }, "UBX-CFG-NAVX5") }, { UBX_MSG::CFG_NAV5, std::make_pair([&] { UBXCfgNav5(msg.payload()); }, "UBX-CFG-NAV5") }, { UBX_MSG::CFG_TP5, std::make_pair([&] { UBXCfgTP5(msg.payload()); }, "UBX-CFG-TP5") }, { UBX_MSG::CFG_GNSS, std::make_pair([&] { UBXCfgGNSS(msg.payload()); }, "UBX-CFG-GNSS") }, { UBX_MSG::CFG_MSG, std::make_pair([&] { UBXCfgMSG(msg.payload()); }, "UBX-CFG-MSG") }, { UBX_MSG::CFG_VALGET, std::make_pair([&] { UBXCfgValGet(msg.payload()); }, "UBX-CFG-VALGET") }
 
         ,
         { UBX_MSG::MON_RXBUF, std::make_pair([&] { UBXMonRx(msg.payload()); }, "UBX-MON-RXBUF") }, { UBX_MSG::MON_TXBUF, std::make_pair([&] { UBXMonTx(msg.payload()); }, "UBX-MON-TXBUF") }, { UBX_MSG::MON_HW, std::make_pair([&] { UBXMonHW(msg.payload()); }, "UBX-MON-HW") }, { UBX_MSG::MON_HW2, std::make_pair([&] { UBXMonHW2(msg.payload()); }, "UBX-MON-HW2") }, { UBX_MSG::MON_VER, std::make_pair([&] { UBXMonVer(msg.payload()); }, "UBX-MON-VER") }
@@ -77,6 +79,12 @@ void QtSerialUblox::processMessage(const UbxMessage& msg)
     uint8_t classID = msg.class_id();
     uint8_t messageID = msg.message_id();
 
+    const auto poll { m_pending_polls.find(msg.full_id()) };
+    if (poll != m_pending_polls.end()) {
+        emit UBXRoundTrip(poll->first, std::chrono::steady_clock::now() - poll->second);
+        m_pending_polls.erase(poll);
+    }
+
     if (handler.count(msg.full_id()) > 0) {
         const auto& [handle, name] = handler.at(msg.full_id());
         handle();
@@ -91,16 +99,7 @@ void QtSerialUblox::processMessage(const UbxMessage& msg)
             emit toConsole("received UBX-ACK message but data is corrupted\n");
             return;
         }
-        if (!msgWaitingForAck) {
-            if (verbose > 1) {
-                std::stringstream tempStream {};
-                tempStream << "received ACK message but no message is waiting for Ack (msgID: 0x";
-                tempStream << std::setfill('0') << std::setw(2) << std::hex << (int)msg.payload()[0] << " 0x"
-                           << std::setfill('0') << std::setw(2) << std::hex << (int)msg.payload()[1] << ")\n";
-                emit toConsole(QString::fromStdString(tempStream.str()));
-            }
-            return;
-        }
+        auto ackedMsgID = (uint16_t)(msg.payload()[0]) << 8U | msg.payload()[1];
         if (verbose > 3) {
             std::stringstream tempStream {};
             if (messageID == 1) {
@@ -112,24 +111,47 @@ void QtSerialUblox::processMessage(const UbxMessage& msg)
                        << std::setfill('0') << std::setw(2) << std::hex << (int)msg.payload()[1] << "\n";
             emit toConsole(QString::fromStdString(tempStream.str()));
         }
-        auto ackedMsgID = (uint16_t)(msg.payload()[0]) << 8U | msg.payload()[1];
-        if (ackedMsgID != msgWaitingForAck->full_id()) {
-            if (verbose > 2) {
+        // the receiver answers in the order the messages were sent, so the oldest matching message is the acknowledged one
+        auto pending { std::find_if(m_in_flight.begin(), m_in_flight.end(), [ackedMsgID](const PendingMessage& entry) {
+            return !entry.answered && entry.message.full_id() == ackedMsgID;
+        }) };
+        if (pending == m_in_flight.end()) {
+            // a second answer to a message which was resent after a timeout must not be taken for the next message with this id
+            auto duplicate { std::find_if(m_in_flight.begin(), m_in_flight.end(), [ackedMsgID](const PendingMessage& entry) {
+                return entry.answered && entry.message.full_id() == ackedMsgID;
+            }) };
+            if (duplicate != m_in_flight.end()) {
+                if (--duplicate->unanswered == 0) {
+                    m_in_flight.erase(duplicate);
+                    sendQueuedMsg();
+                }
+                return;
+            }
+            if (verbose > 1) {
                 std::stringstream tempStream {};
-                tempStream << "received unexpected UBX-ACK message about msgID: 0x";
+                tempStream << "received ACK message but no message is waiting for Ack (msgID: 0x";
                 tempStream << std::setfill('0') << std::setw(2) << std::hex << (int)msg.payload()[0] << " 0x"
-                           << std::setfill('0') << std::setw(2) << std::hex << (int)msg.payload()[1] << "\n";
+                           << std::setfill('0') << std::setw(2) << std::hex << (int)msg.payload()[1] << ")\n";
                 emit toConsole(QString::fromStdString(tempStream.str()));
             }
             return;
         }
-        if (messageID == 0x00 && msgWaitingForAck) {
-            emit UBXReceivedAckNak(msgWaitingForAck->full_id(),
-                (uint16_t)(msgWaitingForAck->payload()[0]) << 8U
-                    | msgWaitingForAck->payload()[1]);
+        // the answer to a resent message may belong to any of its transmissions, so its round trip time is unknown
+        if (pending->retries == 0) {
+            emit UBXRoundTrip(ackedMsgID, std::chrono::steady_clock::now() - pending->sent);
+        }
+        if (messageID == 0x00) {
+            const std::string& payload { pending->message.payload() };
+            emit UBXReceivedAckNak(ackedMsgID,
+                (payload.size() < 2) ? 0 : (uint16_t)((uint8_t)payload[0]) << 8U | (uint8_t)payload[1]);
         }
-        ackTimer->stop();
-        msgWaitingForAck.reset(nullptr);
+        pending->answered = true;
+        if (--pending->unanswered > 0) {
+            // the entry waits for the answer to the other transmission until the ack timeout
+            restartAckTimer();
+            return;
+        }
+        m_in_flight.erase(pending);
         if (verbose > 3) {
             emit toConsole("processMessage: deleted message after ACK/NACK\n");
         }
@@ -178,6 +200,7 @@ void QtSerialUblox::UBXTimTP(const std::string& msg)
     auto flags { get<uint8_t>(msg.begin() + 14) };
     // ref info
     auto refInfo { get<uint8_t>(msg.begin() + 14) };
+    emit UBXReceivedTimePulse(week, towMS, towSubMS, qErr, flags & 1);
 
     double sr = towMS / 1000.;
     sr = sr - towMS / 1000;
@@ -276,11 +299,6 @@ void QtSerialUblox::UBXTimTM2(const std::string& msg)
     // accuracy estimate
     auto accEst { get<uint32_t>(msg.begin() + 24) };
 
-    double sr = towMsR / 1000.;
-    sr = sr - towMsR / 1000;
-    double sf = towMsF / 1000.;
-    sf = sf - towMsF / 1000;
-
     // meaning of columns:
     // 0d 03 - signature of TIM-TM2 message
     // ch, week nr, second in current week (rising), ns of timestamp in current second (rising),
@@ -295,11 +313,11 @@ void QtSerialUblox::UBXTimTM2(const std::string& msg)
         tempStream << " * last rising edge:" << '\n';
         tempStream << "    week nr        : " << std::dec << wnR << '\n';
         tempStream << "    tow s          : " << std::dec << towMsR / 1000. << " s" << '\n';
-        tempStream << "    tow sub s     : " << std::dec << towSubMsR << " = " << (long int)(sr * 1e9 + towSubMsR) << " ns" << '\n';
+        tempStream << "    tow sub s     : " << std::dec << towSubMsR << " = " << static_cast<std::int64_t>(towMsR % 1000) * 1000000 + towSubMsR << " ns" << '\n';
         tempStream << " * last falling edge:" << '\n';
         tempStream << "    week nr        : " << std::dec << wnF << '\n';
         tempStream << "    tow s          : " << std::dec << towMsF / 1000. << " s" << '\n';
-        tempStream << "    tow sub s      : " << std::dec << towSubMsF << " = " << (long int)(sf * 1e9 + towSubMsF) << " ns" << '\n';
+        tempStream << "    tow sub s      : " << std::dec << towSubMsF << " = " << static_cast<std::int64_t>(towMsF % 1000) * 1000000 + towSubMsF << " ns" << '\n';
         tempStream << " accuracy est      : " << std::dec << accEst << " ns" << '\n';
         tempStream << " flags             : ";
         for (int i = 7; i >= 0; i--)
@@ -332,16 +350,20 @@ void QtSerialUblox::UBXTimTM2(const std::string& msg)
         emit toConsole(QString::fromStdString(tempStream.str()));
     }
 
+    // the event time stamps are kept on the GPS time scale, i.e. without leap seconds
+    const timespec ts_r { unixtime_from_gps(wnR, towMsR / 1000, static_cast<std::int64_t>(towMsR % 1000) * 1000000 + towSubMsR) };
+    const timespec ts_f { unixtime_from_gps(wnF, towMsF / 1000, static_cast<std::int64_t>(towMsF % 1000) * 1000000 + towSubMsF) };
+
     tempStream.clear();
     if (flags & 0x80) {
         // if new rising edge
-        tempStream << unixtime_from_gps(wnR, towMsR / 1000, (long int)(sr * 1e9 + towSubMsR));
+        tempStream << ts_r;
     } else {
         tempStream << ".................... ";
     }
     if (flags & 0x04) {
         // if new falling edge
-        tempStream << unixtime_from_gps(wnF, towMsF / 1000, (long int)(sr * 1e9 + towSubMsF));
+        tempStream << ts_f;
     } else {
         tempStream << ".................... ";
     }
@@ -354,9 +376,6 @@ void QtSerialUblox::UBXTimTM2(const std::string& msg)
         emit toConsole(QString::fromStdString(tempStream.str()) + "\n");
     }
 
-    struct timespec ts_r = unixtime_from_gps(wnR, towMsR / 1000, (long int)(sr * 1e9 + towSubMsR));
-    struct timespec ts_f = unixtime_from_gps(wnF, towMsF / 1000, (long int)(sf * 1e9 + towSubMsF));
-
     struct gpsTimestamp ts;
     ts.rising_time = ts_r;
     ts.falling_time = ts_f;
@@ -421,6 +440,9 @@ void QtSerialUblox::UBXTimTM2(const std::string& msg)
             lastPulseLength = dts;
     }
 
+    if (tm.risingValid || tm.fallingValid) {
+        LatencyTracer::trace(LatencyTracer::Stage::UbxTimeMark);
+    }
     emit UBXReceivedTimeTM2(tm);
 }
 
@@ -609,6 +631,27 @@ void QtSerialUblox::UBXCfgMSG(const std::string& msg)
     emit UBXreceivedMsgRateCfg(msgID, rate);
 }
 
+void QtSerialUblox::UBXCfgValGet(const std::string& msg)
+{
+    const auto items { UbxValConfig::parse_valget(msg) };
+    if (verbose > 2) {
+        std::stringstream tempStream;
+        tempStream << "*** UBX CFG-VALGET message:" << '\n';
+        for (const auto& item : items) {
+            tempStream << " key 0x" << std::setfill('0') << std::setw(8) << std::hex << item.key
+                       << " : " << std::dec << item.value << '\n';
+        }
+        emit toConsole(QString::fromStdString(tempStream.str()));
+    }
+    // the message output rates are reported the same way as with CFG-MSG
+    for (const auto& item : items) {
+        const auto msgID { UbxValConfig::msg_id_from_key(item.key) };
+        if (msgID != 0) {
+            emit UBXreceivedMsgRateCfg(msgID, static_cast<uint8_t>(item.value));
+        }
+    }
+}
+
 void QtSerialUblox::UBXCfgGNSS(const std::string& msg)
 {
     // UBX-CFG-GNSS: GNSS configuration
@@ -809,6 +852,7 @@ void QtSerialUblox::UBXNavClock(const std::string& msg)
 
     emit gpsPropertyUpdatedUint32(fAcc, freqAccuracy.updateAge(), 'f');
     freqAccuracy = fAcc;
+    emit UBXReceivedNavClock(iTOW, clkB, clkD, tAcc, fAcc);
     freqAccuracy.lastUpdate = std::chrono::system_clock::now();
     // meaning of columns:
     // 01 22 - signature of NAV-CLOCK message
@@ -872,11 +916,13 @@ void QtSerialUblox::UBXNavTimeGPS(const std::string& msg)
     emit gpsPropertyUpdatedUint32(tAcc, timeAccuracy.updateAge(), 'a');
     timeAccuracy = tAcc;
     timeAccuracy.lastUpdate = std::chrono::system_clock::now();
+    const std::int64_t gpsSeconds { static_cast<std::int64_t>(wnR) * GpsTime::seconds_per_week + iTOW / 1000 };
     if (flags & 4) {
         leapSeconds = leapS;
+        m_leap_seconds.update(gpsSeconds, leapS);
     }
 
-    struct timespec ts = unixtime_from_gps(wnR, iTOW / 1000, (long int)(sr * 1e9 + fTOW));
+    struct timespec ts = unixtime_from_gps(wnR, iTOW / 1000, static_cast<std::int64_t>(iTOW % 1000) * 1000000 + fTOW, m_leap_seconds.offset(gpsSeconds));
     std::stringstream tempStream;
     tempStream << ts.tv_sec << '.' << ts.tv_nsec << "\n";
     if (verbose > 1) {
@@ -967,6 +1013,16 @@ void QtSerialUblox::UBXNavTimeUTC(const std::string& msg)
         tempStream << "   UTC standard  : " << utcStd << "\n";
         emit toConsole(QString::fromStdString(tempStream.str()));
     }
+
+    if ((flags & 0x07) == 0x07) {
+        // the difference of the GPS time of week and the UTC time modulo one week is the leap second offset
+        constexpr std::int64_t weekMs { GpsTime::seconds_per_week * 1000 };
+        const std::int64_t utcGpsMs { (GpsTime::days_from_civil(year, month, day) * 86400 + hour * 3600 + min * 60 + sec - GpsTime::epoch_unix_seconds) * 1000
+            + (nano + 500000) / 1000000 };
+        const std::int64_t diffMs { ((static_cast<std::int64_t>(iTOW) - utcGpsMs) % weekMs + weekMs) % weekMs };
+        const int leapS { static_cast<int>((diffMs + 500) / 1000) };
+        m_leap_seconds.update(utcGpsMs / 1000 + leapS, leapS);
+    }
 }
 
 void QtSerialUblox::UBXMonHW(const std::string& msg)
@@ -0,0 +1,248 @@
+#include "utility/eventanalyzer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+auto EventAnalyzer::Summary::rate() const -> double
+{
+    if (marks < 2 || last_ns <= first_ns) {
+        return 0.;
+    }
+    return 1e9 * static_cast<double>(marks - 1) / static_cast<double>(last_ns - first_ns);
+}
+
+EventAnalyzer::EventAnalyzer()
+    : EventAnalyzer(Config {})
+{
+}
+
+EventAnalyzer::EventAnalyzer(Config config)
+    : m_config { config }
+{
+}
+
+void EventAnalyzer::reset()
+{
+    m_edges.clear();
+    m_tdc.clear();
+    m_marks.clear();
+    m_tick_valid = false;
+    m_locked = false;
+    m_misses = 0;
+    m_candidate_hits = 0;
+    m_summary = {};
+    m_residual_sum2 = {};
+}
+
+auto EventAnalyzer::unwrap(std::uint32_t tick) -> std::int64_t
+{
+    // the µs tick wraps every 71.6 minutes, the signed difference to the latest tick survives this
+    if (!m_tick_valid) {
+        m_tick_valid = true;
+        m_last_tick = tick;
+        m_last_tick_ns = static_cast<std::int64_t>(tick) * 1000;
+        return m_last_tick_ns;
+    }
+    const auto delta { static_cast<std::int32_t>(tick - m_last_tick) };
+    const std::int64_t time_ns { m_last_tick_ns + static_cast<std::int64_t>(delta) * 1000 };
+    if (delta > 0) {
+        m_last_tick = tick;
+        m_last_tick_ns = time_ns;
+    }
+    return time_ns;
+}
+
+void EventAnalyzer::prune()
+{
+    const std::int64_t oldest { m_last_tick_ns - m_config.buffer_span.count() };
+    while (!m_edges.empty() && m_edges.front().time_ns < oldest) {
+        m_edges.pop_front();
+    }
+    while (!m_tdc.empty() && m_tdc.front().time_ns < oldest) {
+        m_tdc.pop_front();
+    }
+}
+
+void EventAnalyzer::add_gpio_event(std::size_t channel, std::uint32_t tick)
+{
+    if (channel >= max_channels) {
+        return;
+    }
+    const Edge edge { unwrap(tick), channel };
+    // edges arrive in order, except for the rare case of two channels firing within one tick
+    const auto it { std::upper_bound(m_edges.begin(), m_edges.end(), edge.time_ns,
+        [](std::int64_t time, const Edge& other) { return time < other.time_ns; }) };
+    m_edges.insert(it, edge);
+    prune();
+}
+
+void EventAnalyzer::add_tdc(std::uint32_t tick, double t_diff_us)
+{
+    m_tdc.push_back(TdcMeasurement { unwrap(tick), t_diff_us });
+    prune();
+}
+
+auto EventAnalyzer::add_time_mark(std::int64_t time_ns) -> Result
+{
+    Result result {};
+    result.time_ns = time_ns;
+
+    // time ordered buffer of the marks, the interval is taken to the preceding mark in time
+    const auto it { std::upper_bound(m_marks.begin(), m_marks.end(), time_ns) };
+    if (it != m_marks.begin()) {
+        result.interval_ns = time_ns - *std::prev(it);
+    }
+    m_marks.insert(it, time_ns);
+    while (!m_marks.empty() && m_marks.front() < m_marks.back() - m_config.buffer_span.count()) {
+        m_marks.pop_front();
+    }
+
+    if (m_summary.marks == 0) {
+        m_summary.first_ns = time_ns;
+        m_summary.last_ns = time_ns;
+    }
+    m_summary.first_ns = std::min(m_summary.first_ns, time_ns);
+    m_summary.last_ns = std::max(m_summary.last_ns, time_ns);
+    m_summary.marks++;
+
+    if (!m_locked && result.interval_ns > 0) {
+        acquire(time_ns, result.interval_ns);
+    }
+    if (m_locked) {
+        match(time_ns, result);
+    }
+    return result;
+}
+
+void EventAnalyzer::acquire(std::int64_t mark_ns, std::int64_t interval_ns)
+{
+    // look for a pair of consecutive edges on one channel with the same interval as the marks
+    std::array<std::int64_t, max_channels> previous {};
+    std::array<bool, max_channels> previous_valid {};
+    std::int64_t best_mismatch { c_acquisition_tolerance_ns };
+    std::int64_t candidate { 0 };
+    bool found { false };
+    for (const auto& edge : m_edges) {
+        if (previous_valid[edge.channel]) {
+            const std::int64_t mismatch { std::abs((edge.time_ns - previous[edge.channel]) - interval_ns) };
+            if (mismatch < best_mismatch) {
+                best_mismatch = mismatch;
+                candidate = mark_ns - edge.time_ns;
+                found = true;
+            }
+        }
+        previous[edge.channel] = edge.time_ns;
+        previous_valid[edge.channel] = true;
+    }
+    if (!found) {
+        return;
+    }
+    if (m_candidate_hits > 0 && std::abs(candidate - m_candidate_ns) < c_acquisition_tolerance_ns) {
+        m_candidate_hits++;
+    } else {
+        m_candidate_hits = 1;
+        m_first_candidate_ns = candidate;
+        m_first_candidate_time_ns = mark_ns;
+    }
+    m_candidate_ns = candidate;
+    m_candidate_time_ns = mark_ns;
+    if (m_candidate_hits < c_acquisition_hits) {
+        return;
+    }
+    m_locked = true;
+    m_offset_ns = static_cast<double>(m_candidate_ns);
+    m_offset_time_ns = m_candidate_time_ns;
+    m_drift = 0.;
+    if (m_candidate_time_ns > m_first_candidate_time_ns) {
+        m_drift = static_cast<double>(m_candidate_ns - m_first_candidate_ns) / static_cast<double>(m_candidate_time_ns - m_first_candidate_time_ns);
+    }
+    m_misses = 0;
+    m_candidate_hits = 0;
+    m_summary.acquisitions++;
+}
+
+auto EventAnalyzer::predicted_offset(std::int64_t mark_ns) const -> double
+{
+    return m_offset_ns + m_drift * static_cast<double>(mark_ns - m_offset_time_ns);
+}
+
+void EventAnalyzer::match(std::int64_t mark_ns, Result& result)
+{
+    const double offset { predicted_offset(mark_ns) };
+    const auto expected { mark_ns - static_cast<std::int64_t>(std::llround(offset)) };
+    const std::int64_t window { m_config.coincidence_window.count() };
+
+    std::array<std::int64_t, max_channels> residual {};
+    auto edge { std::lower_bound(m_edges.begin(), m_edges.end(), expected - window,
+        [](const Edge& other, std::int64_t time) { return other.time_ns < time; }) };
+    for (; edge != m_edges.end() && edge->time_ns <= expected + window; ++edge) {
+        const std::int64_t r { edge->time_ns - expected };
+        const std::uint8_t bit { static_cast<std::uint8_t>(1U << edge->channel) };
+        if (!(result.channel_mask & bit) || std::abs(r) < std::abs(residual[edge->channel])) {
+            residual[edge->channel] = r;
+            result.channel_mask |= bit;
+        }
+    }
+
+    // the TDC interrupt follows the stop signal by the conversion time
+    for (const auto& measurement : m_tdc) {
+        if (measurement.time_ns >= expected - window && measurement.time_ns <= expected + m_config.tdc_window.count()) {
+            result.tdc_matched = true;
+            result.tdc_us = measurement.t_diff_us;
+            break;
+        }
+    }
+
+    result.locked = true;
+    m_summary.analysed_marks++;
+    std::int64_t reference { 0 };
+    bool reference_valid { false };
+    for (std::size_t channel = 0; channel < max_channels; channel++) {
+        if (!(result.channel_mask & (1U << channel))) {
+            continue;
+        }
+        result.multiplicity++;
+        result.residual_ns[channel] = static_cast<double>(residual[channel]);
+        m_summary.channel_matches[channel]++;
+        m_residual_sum2[channel] += result.residual_ns[channel] * result.residual_ns[channel];
+        if (!reference_valid || std::abs(residual[channel]) < std::abs(reference)) {
+            reference = residual[channel];
+            reference_valid = true;
+        }
+    }
+    m_summary.multiplicity[result.multiplicity]++;
+    if (result.tdc_matched) {
+        m_summary.tdc_matches++;
+    }
+
+    if (!reference_valid) {
+        if (++m_misses >= c_max_misses) {
+            m_locked = false;
+        }
+        return;
+    }
+    // alpha-beta tracking of the offset and the drift of the tick oscillator
+    m_misses = 0;
+    const double innovation { -static_cast<double>(reference) };
+    const auto elapsed { static_cast<double>(mark_ns - m_offset_time_ns) };
+    m_offset_ns = offset + c_offset_gain * innovation;
+    if (elapsed > 0.) {
+        m_drift += c_drift_gain * innovation / elapsed;
+    }
+    m_offset_time_ns = mark_ns;
+}
+
+auto EventAnalyzer::take_summary() -> Summary
+{
+    Summary summary { m_summary };
+    for (std::size_t channel = 0; channel < max_channels; channel++) {
+        if (summary.channel_matches[channel] > 0) {
+            summary.residual_rms_ns[channel] = std::sqrt(m_residual_sum2[channel] / static_cast<double>(summary.channel_matches[channel]));
+        }
+    }
+    summary.locked = m_locked;
+    m_summary = {};
+    m_residual_sum2 = {};
+    return summary;
+}
@@ -0,0 +1,134 @@
+#include "utility/eventfilter.h"
+#include <algorithm>
+
+EventFilter::EventFilter(Config config)
+    : m_config { std::move(config) }
+    , m_burst_interval_us { static_cast<std::uint32_t>(m_config.burst_interval.count()) }
+    , m_coincidence_window_us { static_cast<std::uint32_t>(m_config.coincidence_window.count()) }
+{
+    for (auto gpio : m_config.channels) {
+        if (gpio < max_gpio) {
+            m_channels[gpio].filtered = true;
+            m_channels[gpio].deadtime_us = static_cast<std::uint32_t>(m_config.min_deadtime.count());
+            m_channels[gpio].current_deadtime_us = m_channels[gpio].deadtime_us;
+        }
+    }
+    for (auto [gpio, reference] : m_config.coincidences) {
+        if (gpio < max_gpio && reference < max_gpio && m_channels[gpio].filtered) {
+            m_channels[gpio].reference = static_cast<int>(reference);
+        }
+    }
+}
+
+auto EventFilter::process(unsigned int gpio, std::uint32_t tick) -> Verdict
+{
+    if (gpio >= max_gpio) {
+        return Verdict::Accepted;
+    }
+    Channel& channel { m_channels[gpio] };
+    const bool seen_before { channel.seen };
+    // the tick counter wraps every ~72 minutes, the unsigned difference stays valid
+    const std::uint32_t interval { tick - channel.last_tick };
+    channel.seen = true;
+    channel.last_tick = tick;
+    if (!channel.filtered) {
+        return Verdict::Accepted;
+    }
+
+    if (seen_before) {
+        if (channel.mean_interval_us <= 0.) {
+            channel.mean_interval_us = interval;
+        } else {
+            channel.mean_interval_us += c_rate_smoothing * (interval - channel.mean_interval_us);
+        }
+        updateDeadtime(channel);
+
+        // look, if the last edge occured just recently
+        // if so, count the pileup counter up, count down if not
+        if (interval < m_burst_interval_us) {
+            if (channel.pileup < m_config.burst_threshold) {
+                channel.pileup++;
+            }
+        } else if (channel.pileup > 0) {
+            channel.pileup--;
+        }
+        channel.burst.store(channel.pileup >= m_config.burst_threshold, std::memory_order_relaxed);
+    }
+
+    if (channel.pileup >= m_config.burst_threshold) {
+        channel.suppressed_burst.fetch_add(1, std::memory_order_relaxed);
+        return Verdict::Burst;
+    }
+
+    if (m_coincidence_window_us > 0 && channel.reference >= 0) {
+        const Channel& reference { m_channels[static_cast<std::size_t>(channel.reference)] };
+        if (!reference.seen || (tick - reference.last_tick) > m_coincidence_window_us) {
+            channel.suppressed_coincidence.fetch_add(1, std::memory_order_relaxed);
+            return Verdict::Coincidence;
+        }
+    }
+
+    if (channel.accepted_once && (tick - channel.last_accepted_tick) < channel.deadtime_us) {
+        channel.suppressed_deadtime.fetch_add(1, std::memory_order_relaxed);
+        return Verdict::Deadtime;
+    }
+
+    channel.accepted_once = true;
+    channel.last_accepted_tick = tick;
+    channel.accepted.fetch_add(1, std::memory_order_relaxed);
+    return Verdict::Accepted;
+}
+
+void EventFilter::updateDeadtime(Channel& channel)
+{
+    const double rate { (channel.mean_interval_us > 0.) ? 1.0e6 / channel.mean_interval_us : 0. };
+    const auto step { static_cast<std::uint32_t>(m_config.deadtime_step.count()) };
+    const auto min_deadtime { static_cast<std::uint32_t>(m_config.min_deadtime.count()) };
+    const auto max_deadtime { static_cast<std::uint32_t>(m_config.max_deadtime.count()) };
+    // between rate_low and rate_high the deadtime is kept, which avoids toggling around a single threshold
+    if (rate > m_config.rate_high) {
+        channel.deadtime_us = std::min(channel.deadtime_us + step, max_deadtime);
+    } else if (rate < m_config.rate_low) {
+        channel.deadtime_us = (channel.deadtime_us > min_deadtime + step) ? channel.deadtime_us - step : min_deadtime;
+    }
+    channel.current_deadtime_us.store(channel.deadtime_us, std::memory_order_relaxed);
+    channel.current_rate.store(rate, std::memory_order_relaxed);
+}
+
+auto EventFilter::statistics() const -> std::vector<ChannelStatistics>
+{
+    std::vector<ChannelStatistics> stats {};
+    for (unsigned int gpio = 0; gpio < max_gpio; gpio++) {
+        const Channel& channel { m_channels[gpio] };
+        if (!channel.filtered) {
+            continue;
+        }
+        ChannelStatistics channel_stats {};
+        channel_stats.gpio = gpio;
+        channel_stats.accepted = channel.accepted.load(std::memory_order_relaxed);
+        channel_stats.suppressed_burst = channel.suppressed_burst.load(std::memory_order_relaxed);
+        channel_stats.suppressed_coincidence = channel.suppressed_coincidence.load(std::memory_order_relaxed);
+        channel_stats.suppressed_deadtime = channel.suppressed_deadtime.load(std::memory_order_relaxed);
+        channel_stats.deadtime = std::chrono::microseconds { channel.current_deadtime_us.load(std::memory_order_relaxed) };
+        channel_stats.rate = channel.current_rate.load(std::memory_order_relaxed);
+        channel_stats.burst = channel.burst.load(std::memory_order_relaxed);
+        stats.push_back(channel_stats);
+    }
+    return stats;
+}
+
+auto EventFilter::name(Verdict verdict) -> const char*
+{
+    switch (verdict) {
+    case Verdict::Accepted:
+        return "accepted";
+    case Verdict::Burst:
+        return "burst";
+    case Verdict::Coincidence:
+        return "coincidence";
+    case Verdict::Deadtime:
+        return "deadtime";
+    default:
+        return "unknown";
+    }
+}
@@ -1,4 +1,5 @@
 #include "utility/filehandler.h"
+#include "utility/latencytracer.h"
 #include <QByteArray>
 #include <QCryptographicHash>
 #include <QDebug>
@@ -379,6 +380,17 @@ void FileHandler::writeToDataFile(const QString& data)
     out << data << "\n";
 }
 
+void FileHandler::writeEventToDataFile(EventRecord record)
+{
+    LatencyTracer::trace(LatencyTracer::Stage::FileWrite);
+    if (dataFile == nullptr) {
+        return;
+    }
+    const auto line { m_event_formatter.format(record) };
+    dataFile->write(line.data(), static_cast<qint64>(line.size()));
+    dataFile->write("\n", 1);
+}
+
 void FileHandler::writeToLogFile(const QString& log)
 {
     if (logFile == nullptr) {
@@ -0,0 +1,233 @@
+#include "utility/inputrecorder.h"
+#include <QDebug>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+template <typename T>
+void append(char*& dest, const T& value)
+{
+    std::memcpy(dest, &value, sizeof(T));
+    dest += sizeof(T);
+}
+
+template <typename T>
+auto extract(const char*& src) -> T
+{
+    T value {};
+    std::memcpy(&value, src, sizeof(T));
+    src += sizeof(T);
+    return value;
+}
+}
+
+InputRecorder::~InputRecorder()
+{
+    close();
+}
+
+auto InputRecorder::open(const std::string& filename) -> bool
+{
+    std::lock_guard<std::mutex> lock { m_mutex };
+    if (m_file.is_open()) {
+        m_file.close();
+    }
+    m_file.open(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!m_file.is_open()) {
+        qWarning() << "InputRecorder: could not open capture file" << QString::fromStdString(filename);
+        m_open = false;
+        return false;
+    }
+    m_file.write(magic, sizeof(magic));
+    m_file.write(reinterpret_cast<const char*>(&format_version), sizeof(format_version));
+    m_start = std::chrono::steady_clock::now();
+    m_count = 0;
+    m_open = true;
+    return true;
+}
+
+void InputRecorder::close()
+{
+    std::lock_guard<std::mutex> lock { m_mutex };
+    m_open = false;
+    if (m_file.is_open()) {
+        m_file.flush();
+        m_file.close();
+    }
+}
+
+void InputRecorder::write(RecordType type, const char* payload, std::uint32_t size)
+{
+    if (!isOpen()) {
+        return;
+    }
+    // the time stamp is taken under the lock, so the records of concurrent writers stay in time order
+    std::lock_guard<std::mutex> lock { m_mutex };
+    if (!m_file.is_open()) {
+        return;
+    }
+    const std::uint64_t timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count();
+    char header[record_header_size];
+    char* p = header;
+    append(p, static_cast<std::uint8_t>(type));
+    append(p, timestamp_ns);
+    append(p, size);
+    m_file.write(header, sizeof(header));
+    m_file.write(payload, size);
+    m_count++;
+}
+
+void InputRecorder::recordGpioTick(unsigned int gpio, unsigned int level, std::uint32_t tick)
+{
+    char payload[sizeof(std::uint8_t) * 2 + sizeof(std::uint32_t)];
+    char* p = payload;
+    append(p, static_cast<std::uint8_t>(gpio));
+    append(p, static_cast<std::uint8_t>(level));
+    append(p, tick);
+    write(RecordType::GpioTick, payload, sizeof(payload));
+}
+
+void InputRecorder::recordUbxData(const char* data, std::size_t size)
+{
+    write(RecordType::UbxData, data, static_cast<std::uint32_t>(size));
+}
+
+void InputRecorder::recordAdcSample(unsigned int channel, int value, float voltage, float lsb_voltage)
+{
+    char payload[sizeof(std::uint8_t) + sizeof(std::int32_t) + 2 * sizeof(float)];
+    char* p = payload;
+    append(p, static_cast<std::uint8_t>(channel));
+    append(p, static_cast<std::int32_t>(value));
+    append(p, voltage);
+    append(p, lsb_voltage);
+    write(RecordType::AdcSample, payload, sizeof(payload));
+}
+
+InputReplay::InputReplay(const QString& filename, double speed, QObject* parent)
+    : QObject(parent)
+    , m_speed { speed }
+{
+    m_timer.setSingleShot(true);
+    connect(&m_timer, &QTimer::timeout, this, &InputReplay::onTimeout);
+
+    m_file.open(filename.toStdString(), std::ios::in | std::ios::binary);
+    if (!m_file.is_open()) {
+        qWarning() << "InputReplay: could not open capture file" << filename;
+        return;
+    }
+    char file_magic[sizeof(InputRecorder::magic)];
+    std::uint16_t version { 0 };
+    m_file.read(file_magic, sizeof(file_magic));
+    m_file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    if (!m_file || std::memcmp(file_magic, InputRecorder::magic, sizeof(file_magic)) != 0) {
+        qWarning() << "InputReplay:" << filename << "is not a capture file";
+        return;
+    }
+    if (version != InputRecorder::format_version) {
+        qWarning() << "InputReplay: unsupported capture format version" << version;
+        return;
+    }
+    m_valid = true;
+}
+
+auto InputReplay::readRecord(Record& record) -> bool
+{
+    char header[InputRecorder::record_header_size];
+    if (!m_file.read(header, sizeof(header))) {
+        return false;
+    }
+    const char* p = header;
+    record.type = static_cast<InputRecorder::RecordType>(extract<std::uint8_t>(p));
+    record.timestamp_ns = extract<std::uint64_t>(p);
+    const auto size = extract<std::uint32_t>(p);
+    record.payload.resize(size);
+    if (size > 0 && !m_file.read(&record.payload[0], size)) {
+        return false;
+    }
+    return true;
+}
+
+void InputReplay::dispatch(const Record& record)
+{
+    const char* p = record.payload.data();
+    switch (record.type) {
+    case InputRecorder::RecordType::GpioTick: {
+        if (record.payload.size() < 6) {
+            break;
+        }
+        const auto gpio = extract<std::uint8_t>(p);
+        const auto level = extract<std::uint8_t>(p);
+        const auto tick = extract<std::uint32_t>(p);
+        emit gpioTick(gpio, level, tick);
+        break;
+    }
+    case InputRecorder::RecordType::UbxData:
+        emit ubxData(QByteArray(record.payload.data(), static_cast<int>(record.payload.size())));
+        break;
+    case InputRecorder::RecordType::AdcSample: {
+        if (record.payload.size() < 13) {
+            break;
+        }
+        const auto channel = extract<std::uint8_t>(p);
+        const auto value = extract<std::int32_t>(p);
+        const auto voltage = extract<float>(p);
+        const auto lsb_voltage = extract<float>(p);
+        emit adcSample(channel, value, voltage, lsb_voltage);
+        break;
+    }
+    default:
+        qWarning() << "InputReplay: skipping record of unknown type" << static_cast<int>(record.type);
+    }
+    m_count++;
+}
+
+void InputReplay::start()
+{
+    if (!m_valid) {
+        emit finished();
+        return;
+    }
+    m_count = 0;
+    m_pending = readRecord(m_next);
+    m_elapsed.start();
+    scheduleNext();
+}
+
+void InputReplay::stop()
+{
+    m_timer.stop();
+    m_pending = false;
+}
+
+void InputReplay::scheduleNext()
+{
+    if (!m_pending) {
+        qInfo() << "InputReplay: replay finished after" << m_count << "records";
+        emit finished();
+        return;
+    }
+    if (m_speed <= 0.) {
+        m_timer.start(0);
+        return;
+    }
+    const auto due_ms = static_cast<qint64>(m_next.timestamp_ns / m_speed / 1.0e6);
+    m_timer.start(static_cast<int>(std::max<qint64>(0, due_ms - m_elapsed.elapsed())));
+}
+
+void InputReplay::onTimeout()
+{
+    if (m_speed <= 0.) {
+        for (std::size_t i = 0; m_pending && i < c_max_speed_batch; i++) {
+            dispatch(m_next);
+            m_pending = readRecord(m_next);
+        }
+    } else {
+        // emit all records which became due in the meantime
+        const auto now_ns = static_cast<std::uint64_t>(m_elapsed.nsecsElapsed() * m_speed);
+        do {
+            dispatch(m_next);
+            m_pending = readRecord(m_next);
+        } while (m_pending && m_next.timestamp_ns <= now_ns);
+    }
+    scheduleNext();
+}
@@ -1,57 +1,203 @@
 #include "utility/kalman_gnss_filter.h"
-#include <iostream>
+
+#include <algorithm>
+
+namespace {
+constexpr double pi { 3.14159265358979 };
+constexpr double earth_radius_meters { 6367444.5 };
+constexpr double degree_to_surface_meters { (pi * 2 * earth_radius_meters) / 360. };
+
+/**
+ * @brief decouple the states [first, last) from all others and set their variances
+ */
+template <std::size_t N>
+void reset_block(Matrix<N, N>& covariance, std::size_t first, std::size_t last, double variance)
+{
+    for (std::size_t i = first; i < last; i++) {
+        for (std::size_t j = 0; j < N; j++) {
+            covariance(i, j) = 0.;
+            covariance(j, i) = 0.;
+        }
+        covariance(i, i) = variance;
+    }
+}
+
+auto seconds(std::chrono::steady_clock::duration duration) -> double
+{
+    return std::chrono::duration_cast<std::chrono::duration<double>>(duration).count();
+}
+}
 
 /**
  * Kalman GNSS Filter
  */
 KalmanGnssFilter::KalmanGnssFilter(double accuracy_decay)
     : m_accuracy_decay(accuracy_decay)
-    , m_variance { -1. }
 {
 }
 
-void KalmanGnssFilter::set_state(double lat, double lng, double alt, double accuracy)
+void KalmanGnssFilter::reset()
 {
-    m_lat = lat;
-    m_lng = lng;
-    m_alt = alt;
-    m_variance = accuracy * accuracy;
-    m_timestamp = std::chrono::steady_clock::now();
+    reset_position();
+    reset_clock();
+    m_timestamp = {};
 }
 
-void KalmanGnssFilter::reset()
+void KalmanGnssFilter::reset_position()
 {
-    m_lat = m_lng = m_alt = 0.;
-    m_variance = -1.;
-}
-
-void KalmanGnssFilter::process(double lat_measurement, double lng_measurement, double alt_measurement, double accuracy)
-{
-    double local_accuracy { accuracy };
-    if (accuracy < c_min_accuracy)
-        local_accuracy = c_min_accuracy;
-    if (m_variance < 0) {
-        // if variance < 0, object is unitialised, so initialise with current values
-        set_state(lat_measurement, lng_measurement, alt_measurement, local_accuracy);
-    } else {
-        // else apply Kalman filter methodology
-        auto current_time = std::chrono::steady_clock::now();
-        unsigned int time_increment_ms = std::chrono::duration_cast<std::chrono::milliseconds>(current_time - m_timestamp).count();
-        if (time_increment_ms > 0) {
-            // time has moved on, so the uncertainty in the current position increases
-            m_variance += time_increment_ms * m_accuracy_decay * m_accuracy_decay / 1000;
-            m_timestamp = current_time;
-            // TO DO: USE VELOCITY INFORMATION HERE TO GET A BETTER ESTIMATE OF CURRENT POSITION
-        }
+    m_position_valid = false;
+    m_ref_lat = m_ref_lng = m_ref_alt = 0.;
+    m_state[East] = m_state[North] = m_state[Up] = 0.;
+    reset_block(m_covariance, East, ClockBias, 0.);
+}
+
+void KalmanGnssFilter::reset_clock()
+{
+    m_clock_updates = 0;
+    m_state[ClockBias] = m_state[ClockDrift] = 0.;
+    reset_block(m_covariance, ClockBias, StateSize, 0.);
+    m_quantization_variance = 0.;
+    m_quantization_weight = 0.;
+}
+
+void KalmanGnssFilter::predict(std::chrono::steady_clock::time_point time)
+{
+    if (m_timestamp == std::chrono::steady_clock::time_point {}) {
+        m_timestamp = time;
+        return;
+    }
+    const double dt { seconds(time - m_timestamp) };
+    if (dt <= 0.) {
+        return;
+    }
+    m_timestamp = time;
+
+    // the position is static with a random walk, the clock bias integrates the drift
+    Covariance F { Covariance::identity() };
+    F(ClockBias, ClockDrift) = dt;
+
+    Covariance Q {};
+    const double position_noise { m_accuracy_decay * m_accuracy_decay * dt };
+    Q(East, East) = Q(North, North) = Q(Up, Up) = position_noise;
+    Q(ClockBias, ClockBias) = c_clock_phase_noise * dt + c_clock_frequency_noise * dt * dt * dt / 3.;
+    Q(ClockBias, ClockDrift) = Q(ClockDrift, ClockBias) = c_clock_frequency_noise * dt * dt / 2.;
+    Q(ClockDrift, ClockDrift) = c_clock_frequency_noise * dt;
+
+    m_state = F * m_state;
+    m_covariance = F * m_covariance * F.transposed() + Q;
+}
+
+template <std::size_t M>
+void KalmanGnssFilter::update(const Matrix<M, StateSize>& H, const Matrix<M, 1>& z, const Matrix<M, M>& R)
+{
+    const Matrix<M, 1> innovation { z - H * m_state };
+    const Matrix<StateSize, M> PHt { m_covariance * H.transposed() };
+    const Matrix<M, M> S { H * PHt + R };
+    Matrix<M, M> S_inv {};
+    if (!S.inverse(S_inv)) {
+        return;
+    }
+    const Matrix<StateSize, M> K { PHt * S_inv };
+    m_state += K * innovation;
+    // Joseph form, keeps the covariance symmetric and positive definite
+    const Covariance I_KH { Covariance::identity() - K * H };
+    m_covariance = I_KH * m_covariance * I_KH.transposed() + K * R * K.transposed();
+}
+
+void KalmanGnssFilter::process(double lat_measurement, double lng_measurement, double alt_measurement, double hor_accuracy, double vert_accuracy)
+{
+    const double hor_variance { std::pow(std::max(hor_accuracy, c_min_accuracy), 2) / 2. };
+    const double vert_variance { std::pow(std::max(vert_accuracy, c_min_accuracy), 2) };
+    predict(std::chrono::steady_clock::now());
 
-        // Kalman gain matrix K = Covariance * Inverse(Covariance + MeasurementVariance)
-        // NB: because K is dimensionless, it doesn't matter that variance has different units to lat and lng
-        double K = m_variance / (m_variance + local_accuracy * local_accuracy);
-        // apply K
-        m_lat += K * (lat_measurement - m_lat);
-        m_lng += K * (lng_measurement - m_lng);
-        m_alt += K * (alt_measurement - m_alt);
-        // new Covariance  matrix is (IdentityMatrix - K) * Covariance
-        m_variance = (1. - K) * m_variance;
+    if (!m_position_valid) {
+        // the first fix defines the origin of the local frame
+        m_ref_lat = lat_measurement;
+        m_ref_lng = lng_measurement;
+        m_ref_alt = alt_measurement;
+        m_state[East] = m_state[North] = m_state[Up] = 0.;
+        reset_block(m_covariance, East, ClockBias, hor_variance);
+        m_covariance(Up, Up) = vert_variance;
+        m_position_valid = true;
+        return;
     }
+
+    Matrix<3, StateSize> H {};
+    H(0, East) = H(1, North) = H(2, Up) = 1.;
+    const Matrix<3, 1> z {
+        (lng_measurement - m_ref_lng) * degree_to_surface_meters * std::cos(m_ref_lat * pi / 180.),
+        (lat_measurement - m_ref_lat) * degree_to_surface_meters,
+        alt_measurement - m_ref_alt
+    };
+    const Matrix<3, 3> R { Matrix<3, 3>::diagonal({ hor_variance, hor_variance, vert_variance }) };
+    update(H, z, R);
+}
+
+void KalmanGnssFilter::process_clock(double bias_ns, double drift_ns_per_s, double bias_accuracy_ns, double drift_accuracy_ns_per_s)
+{
+    const auto now { std::chrono::steady_clock::now() };
+    const double bias_variance { std::pow(std::max(bias_accuracy_ns, c_min_clock_accuracy), 2) + m_quantization_variance };
+    const double drift_variance { std::pow(std::max(drift_accuracy_ns_per_s, 1e-3), 2) };
+    predict(now);
+    m_raw_bias = bias_ns;
+    m_raw_drift = drift_ns_per_s;
+    m_raw_clock_timestamp = now;
+
+    const double innovation { bias_ns - m_state[ClockBias] };
+    const bool jump { m_clock_updates > 0
+        && std::abs(innovation) > c_clock_jump
+        && innovation * innovation > 100. * (m_covariance(ClockBias, ClockBias) + bias_variance) };
+    if (m_clock_updates == 0 || jump) {
+        // (re)start the clock model, the receiver steers its clock in steps
+        m_state[ClockBias] = bias_ns;
+        m_state[ClockDrift] = drift_ns_per_s;
+        reset_block(m_covariance, ClockBias, StateSize, 0.);
+        m_covariance(ClockBias, ClockBias) = bias_variance;
+        m_covariance(ClockDrift, ClockDrift) = drift_variance;
+        m_clock_updates = 1;
+        return;
+    }
+
+    Matrix<2, StateSize> H {};
+    H(0, ClockBias) = H(1, ClockDrift) = 1.;
+    const Matrix<2, 1> z { bias_ns, drift_ns_per_s };
+    const Matrix<2, 2> R { Matrix<2, 2>::diagonal({ bias_variance, drift_variance }) };
+    update(H, z, R);
+    m_clock_updates++;
+}
+
+void KalmanGnssFilter::process_quantization_error(double quantization_error_ns)
+{
+    // the quantisation error is a zero mean sawtooth, its variance is the noise floor of the time base
+    m_quantization_weight = std::min(m_quantization_weight + 1., c_quantization_window);
+    m_quantization_variance += (quantization_error_ns * quantization_error_ns - m_quantization_variance) / m_quantization_weight;
+}
+
+auto KalmanGnssFilter::time_correction(std::chrono::steady_clock::time_point time) const -> TimeCorrection
+{
+    if (!clock_valid() || time - m_raw_clock_timestamp > c_max_clock_age) {
+        return TimeCorrection {};
+    }
+    // the arrival times of the messages serve as common time base. Their latency only enters
+    // multiplied with the small difference of the raw and filtered drift.
+    const double dt { seconds(time - m_timestamp) };
+    const double filtered_bias { m_state[ClockBias] + m_state[ClockDrift] * dt };
+    const double raw_bias { m_raw_bias + m_raw_drift * seconds(time - m_raw_clock_timestamp) };
+    const double variance {
+        m_covariance(ClockBias, ClockBias)
+        + 2. * dt * m_covariance(ClockBias, ClockDrift)
+        + dt * dt * m_covariance(ClockDrift, ClockDrift)
+        + m_quantization_variance
+    };
+    return TimeCorrection { raw_bias - filtered_bias, std::sqrt(std::max(variance, 0.)), true };
+}
+
+auto KalmanGnssFilter::get_latitude() const -> double
+{
+    return m_ref_lat + m_state[North] / degree_to_surface_meters;
+}
+
+auto KalmanGnssFilter::get_longitude() const -> double
+{
+    return m_ref_lng + m_state[East] / (degree_to_surface_meters * std::cos(m_ref_lat * pi / 180.));
 }
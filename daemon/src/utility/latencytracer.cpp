@@ -0,0 +1,175 @@
+#include "utility/latencytracer.h"
+#include <algorithm>
+
+auto LatencyTracer::instance() -> LatencyTracer&
+{
+    static LatencyTracer tracer {};
+    return tracer;
+}
+
+auto LatencyTracer::ThreadBuffer::push(const Entry& entry) noexcept -> bool
+{
+    const std::size_t head { m_head.load(std::memory_order_relaxed) };
+    if (head - m_tail.load(std::memory_order_acquire) >= c_buffer_size) {
+        return false;
+    }
+    m_ring[head & (c_buffer_size - 1)] = entry;
+    m_head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename F>
+void LatencyTracer::ThreadBuffer::drain(F&& consumer)
+{
+    const std::size_t tail { m_tail.load(std::memory_order_relaxed) };
+    const std::size_t head { m_head.load(std::memory_order_acquire) };
+    for (std::size_t i = tail; i != head; i++) {
+        consumer(m_ring[i & (c_buffer_size - 1)]);
+    }
+    m_tail.store(head, std::memory_order_release);
+}
+
+auto LatencyTracer::threadBuffer() -> ThreadBuffer&
+{
+    // the registry keeps the buffer alive, even if the owning thread terminates
+    thread_local std::shared_ptr<ThreadBuffer> buffer {};
+    if (!buffer) {
+        buffer = std::make_shared<ThreadBuffer>();
+        std::lock_guard<std::mutex> lock { m_registry_mutex };
+        m_buffers.push_back(buffer);
+    }
+    return *buffer;
+}
+
+void LatencyTracer::trace(Stage stage) noexcept
+{
+    LatencyTracer& tracer { instance() };
+    if (!tracer.isEnabled()) {
+        return;
+    }
+    const std::uint64_t t_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    if (!tracer.threadBuffer().push(Entry { t_ns, stage })) {
+        tracer.m_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void LatencyTracer::collect()
+{
+    // entries younger than the cutoff are kept for the next round, since the entries
+    // of their predecessor stage might not have been visible while draining
+    const std::uint64_t cutoff = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+    std::vector<Entry> entries {};
+    entries.swap(m_carry);
+    {
+        std::lock_guard<std::mutex> lock { m_registry_mutex };
+        for (auto& buffer : m_buffers) {
+            buffer->drain([&entries](const Entry& entry) { entries.push_back(entry); });
+        }
+    }
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.t_ns < b.t_ns; });
+
+    for (const auto& entry : entries) {
+        if (entry.t_ns > cutoff) {
+            m_carry.push_back(entry);
+            continue;
+        }
+        process(entry);
+    }
+}
+
+void LatencyTracer::process(const Entry& entry)
+{
+    const auto index { static_cast<std::size_t>(entry.stage) };
+    if (index >= stage_count) {
+        return;
+    }
+    std::uint64_t origin_ns { entry.t_ns };
+    if (predecessor(entry.stage) != Stage::Count) {
+        auto& pending { m_pending[index] };
+        if (!pending.empty()) {
+            const Item item { pending.front() };
+            pending.pop_front();
+            origin_ns = item.origin_ns;
+            if (m_hop_samples[index].size() < c_max_samples) {
+                m_hop_samples[index].push_back(entry.t_ns - item.t_ns);
+                m_total_samples[index].push_back(entry.t_ns - item.origin_ns);
+            }
+        }
+    }
+    m_counts[index]++;
+
+    // hand the item over to all stages following this one
+    for (std::size_t i = 0; i < stage_count; i++) {
+        if (predecessor(static_cast<Stage>(i)) != entry.stage) {
+            continue;
+        }
+        auto& pending { m_pending[i] };
+        pending.push_back(Item { entry.t_ns, origin_ns });
+        // a stage which is not active (e.g. local file storage disabled) never consumes its items
+        while (pending.size() > c_max_pending) {
+            pending.pop_front();
+        }
+    }
+}
+
+auto LatencyTracer::quantiles(std::vector<std::uint64_t>& samples) -> Quantiles
+{
+    Quantiles result {};
+    if (samples.empty()) {
+        return result;
+    }
+    const auto nth = [&samples](double q) {
+        auto it = samples.begin() + static_cast<std::ptrdiff_t>(q * (samples.size() - 1));
+        std::nth_element(samples.begin(), it, samples.end());
+        return std::chrono::nanoseconds { *it };
+    };
+    result.p50 = nth(0.5);
+    result.p99 = nth(0.99);
+    result.max = std::chrono::nanoseconds { *std::max_element(samples.begin(), samples.end()) };
+    return result;
+}
+
+auto LatencyTracer::statistics(bool reset) -> std::vector<StageStatistics>
+{
+    std::vector<StageStatistics> stats {};
+    for (std::size_t i = 0; i < stage_count; i++) {
+        if (m_counts[i] == 0) {
+            continue;
+        }
+        StageStatistics stage_stats {};
+        stage_stats.stage = static_cast<Stage>(i);
+        stage_stats.count = m_counts[i];
+        stage_stats.hop = quantiles(m_hop_samples[i]);
+        stage_stats.total = quantiles(m_total_samples[i]);
+        stats.push_back(stage_stats);
+        if (reset) {
+            m_counts[i] = 0;
+            m_hop_samples[i].clear();
+            m_total_samples[i].clear();
+        }
+    }
+    return stats;
+}
+
+auto LatencyTracer::name(Stage stage) -> std::string
+{
+    switch (stage) {
+    case Stage::GpioCallback:
+        return "GpioCallback";
+    case Stage::GpioDaemon:
+        return "GpioDaemon";
+    case Stage::UbxTimeMark:
+        return "UbxTimeMark";
+    case Stage::TimeMarkDaemon:
+        return "TimeMarkDaemon";
+    case Stage::EventMessage:
+        return "EventMessage";
+    case Stage::MqttPublish:
+        return "MqttPublish";
+    case Stage::FileWrite:
+        return "FileWrite";
+    default:
+        return "Unknown";
+    }
+}
@@ -80,10 +80,6 @@ void EventRateBuffer::onEvent(uint8_t gpio)
     }
 
     auto last_event_time = m_eventbuffer.back();
-    if (event_time - last_event_time < m_current_deadtime) {
-        // m_buffer[gpio].eventbuffer.push(event_time);
-        return;
-    }
 
     while (!m_eventbuffer.empty()
         && (event_time - m_eventbuffer.front() > m_buffer_time)) {
@@ -92,24 +88,6 @@ void EventRateBuffer::onEvent(uint8_t gpio)
 
     if (!m_eventbuffer.empty()) {
         m_last_interval = std::chrono::duration_cast<std::chrono::nanoseconds>(event_time - last_event_time);
-        if (event_time - last_event_time < MAX_DEADTIME) {
-            //			std::cout << "now-last:"<<(now-last_event_time)/1us<<" dt="<<buffermap[gpio].current_deadtime.count()<<std::endl;
-            if (m_current_deadtime < MAX_DEADTIME) {
-                m_current_deadtime += DEADTIME_INCREMENT;
-                // std::cout << std::dec << "adjusting deadtime for gpio " << gpio << " to " << m_buffer.current_deadtime/1us << "us" << std::endl;
-            }
-            if (event_time - last_event_time < m_current_deadtime) {
-                m_eventbuffer.push(event_time);
-                return;
-            }
-        } else {
-            auto deadtime = m_current_deadtime;
-            if (deadtime > DEADTIME_INCREMENT) {
-                m_current_deadtime -= DEADTIME_INCREMENT;
-            } else if (deadtime > 0s) {
-                m_current_deadtime -= std::chrono::microseconds(1);
-            }
-        }
     }
     m_eventbuffer.push(event_time);
     emit filteredEvent(gpio, event_time);
@@ -132,11 +110,6 @@ auto EventRateBuffer::avgRate() const -> double
     return (m_eventbuffer.size() / span);
 }
 
-auto EventRateBuffer::currentDeadtime() const -> std::chrono::microseconds
-{
-    return m_current_deadtime;
-}
-
 auto EventRateBuffer::lastInterval() const -> std::chrono::nanoseconds
 {
     if (m_eventbuffer.size() < 2)
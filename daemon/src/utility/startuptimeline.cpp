@@ -0,0 +1,86 @@
+#include "utility/startuptimeline.h"
+
+#include <algorithm>
+
+StartupTimeline::StartupTimeline()
+    : m_start { std::chrono::steady_clock::now() }
+{
+}
+
+auto StartupTimeline::elapsed() const -> std::chrono::milliseconds
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_start);
+}
+
+void StartupTimeline::begin(const std::string& name)
+{
+    const auto now { elapsed() };
+    if (auto* phase { find(name) }; phase != nullptr) {
+        *phase = Phase { name, now, now, State::Running };
+        return;
+    }
+    m_phases.push_back(Phase { name, now, now, State::Running });
+}
+
+void StartupTimeline::finish(const std::string& name, bool success)
+{
+    auto* phase { find(name) };
+    if (phase == nullptr) {
+        return;
+    }
+    if (phase->state == State::Running) {
+        phase->state = success ? State::Finished : State::Failed;
+        phase->end = elapsed();
+    } else if (phase->state == State::TimedOut) {
+        phase->end = elapsed();
+    }
+}
+
+auto StartupTimeline::timeout(const std::string& name) -> bool
+{
+    auto* phase { find(name) };
+    if (phase == nullptr || phase->state != State::Running) {
+        return false;
+    }
+    phase->state = State::TimedOut;
+    phase->end = elapsed();
+    return true;
+}
+
+auto StartupTimeline::running(const std::string& name) const -> bool
+{
+    const auto* phase { find(name) };
+    return phase != nullptr && phase->state == State::Running;
+}
+
+auto StartupTimeline::complete() const -> bool
+{
+    return std::none_of(m_phases.begin(), m_phases.end(), [](const Phase& phase) { return phase.state == State::Running; });
+}
+
+auto StartupTimeline::state_string(State state) -> std::string
+{
+    switch (state) {
+    case State::Running:
+        return "running";
+    case State::Finished:
+        return "ok";
+    case State::Failed:
+        return "failed";
+    case State::TimedOut:
+        return "timed out";
+    }
+    return "";
+}
+
+auto StartupTimeline::find(const std::string& name) -> Phase*
+{
+    auto it { std::find_if(m_phases.begin(), m_phases.end(), [&name](const Phase& phase) { return phase.name == name; }) };
+    return (it != m_phases.end()) ? &(*it) : nullptr;
+}
+
+auto StartupTimeline::find(const std::string& name) const -> const Phase*
+{
+    auto it { std::find_if(m_phases.begin(), m_phases.end(), [&name](const Phase& phase) { return phase.name == name; }) };
+    return (it != m_phases.end()) ? &(*it) : nullptr;
+}
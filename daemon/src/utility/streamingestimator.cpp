@@ -0,0 +1,214 @@
+#include "utility/streamingestimator.h"
+
+#include <algorithm>
+#include <cmath>
+
+P2Quantile::P2Quantile(double quantile, double forgetting)
+    : m_p { quantile }
+    , m_forgetting { forgetting }
+    , m_dn { 0., quantile / 2., quantile, (1. + quantile) / 2., 1. }
+{
+}
+
+void P2Quantile::reset()
+{
+    m_count = 0;
+}
+
+void P2Quantile::add(double x)
+{
+    if (m_count < m_q.size()) {
+        m_q[m_count++] = x;
+        if (m_count == m_q.size()) {
+            std::sort(m_q.begin(), m_q.end());
+            m_n = { 1., 2., 3., 4., 5. };
+            m_np = { 1., 1. + 2. * m_p, 1. + 4. * m_p, 3. + 2. * m_p, 5. };
+        }
+        return;
+    }
+    m_count++;
+
+    std::size_t k { 0 };
+    if (x < m_q[0]) {
+        m_q[0] = x;
+    } else if (x >= m_q[4]) {
+        m_q[4] = x;
+        k = 3;
+    } else {
+        while (k < 3 && x >= m_q[k + 1]) {
+            k++;
+        }
+    }
+    for (std::size_t i = 0; i < m_n.size(); i++) {
+        if (i > k) {
+            m_n[i] += 1.;
+        }
+        m_np[i] += m_dn[i];
+        // decay all positions towards the first marker, which stays at position 1
+        m_n[i] = 1. + m_forgetting * (m_n[i] - 1.);
+        m_np[i] = 1. + m_forgetting * (m_np[i] - 1.);
+    }
+
+    for (std::size_t i = 1; i < 4; i++) {
+        const double d { m_np[i] - m_n[i] };
+        if ((d >= 1. && m_n[i + 1] - m_n[i] > 1.) || (d <= -1. && m_n[i - 1] - m_n[i] < -1.)) {
+            const double ds { (d > 0.) ? 1. : -1. };
+            const double q { parabolic(i, ds) };
+            if (m_q[i - 1] < q && q < m_q[i + 1]) {
+                m_q[i] = q;
+            } else {
+                m_q[i] = linear(i, ds);
+            }
+            m_n[i] += ds;
+        }
+    }
+}
+
+auto P2Quantile::parabolic(std::size_t i, double d) const -> double
+{
+    return m_q[i] + d / (m_n[i + 1] - m_n[i - 1]) * ((m_n[i] - m_n[i - 1] + d) * (m_q[i + 1] - m_q[i]) / (m_n[i + 1] - m_n[i]) + (m_n[i + 1] - m_n[i] - d) * (m_q[i] - m_q[i - 1]) / (m_n[i] - m_n[i - 1]));
+}
+
+auto P2Quantile::linear(std::size_t i, double d) const -> double
+{
+    const std::size_t j { (d > 0.) ? i + 1 : i - 1 };
+    return m_q[i] + d * (m_q[j] - m_q[i]) / (m_n[j] - m_n[i]);
+}
+
+auto P2Quantile::value() const -> double
+{
+    if (m_count == 0) {
+        return 0.;
+    }
+    if (m_count < m_q.size()) {
+        // too few samples for the markers, take the quantile of the samples directly
+        std::array<double, 5> sorted { m_q };
+        std::sort(sorted.begin(), sorted.begin() + m_count);
+        return sorted[static_cast<std::size_t>(m_p * (m_count - 1) + 0.5)];
+    }
+    return m_q[2];
+}
+
+auto P2Quantile::lower() const -> double
+{
+    return (m_count < m_q.size()) ? value() : m_q[1];
+}
+
+auto P2Quantile::upper() const -> double
+{
+    return (m_count < m_q.size()) ? value() : m_q[3];
+}
+
+RobustMean::RobustMean(double forgetting, double clip)
+    : m_forgetting { forgetting }
+    , m_clip { clip }
+{
+}
+
+void RobustMean::reset()
+{
+    m_mean = 0.;
+    m_variance = 0.;
+    m_weight = 0.;
+}
+
+void RobustMean::add(double x)
+{
+    m_weight = m_forgetting * m_weight + 1.;
+    if (m_weight <= 1.) {
+        m_mean = x;
+        m_variance = 0.;
+        return;
+    }
+    double residual { x - m_mean };
+    const double limit { m_clip * stddev() };
+    if (limit > 0.) {
+        residual = std::clamp(residual, -limit, limit);
+    }
+    const double alpha { 1. / m_weight };
+    m_mean += alpha * residual;
+    m_variance = (1. - alpha) * (m_variance + alpha * residual * residual);
+}
+
+auto RobustMean::stddev() const -> double
+{
+    return std::sqrt(m_variance);
+}
+
+StreamingEstimator::StreamingEstimator(Location location, double window, double drift_window)
+    : m_location { location }
+    , m_forgetting { (window > 1.) ? 1. - 1. / window : 1. }
+    , m_drift_window { std::max(drift_window, 1.) }
+    , m_median { 0.5, m_forgetting }
+    , m_mean { m_forgetting }
+{
+}
+
+void StreamingEstimator::reset()
+{
+    m_median.reset();
+    m_mean.reset();
+    m_last_value = 0.;
+    m_velocity = 0.;
+}
+
+void StreamingEstimator::set_location(Location location)
+{
+    if (location == m_location) {
+        return;
+    }
+    m_location = location;
+    m_last_value = value();
+    m_velocity = 0.;
+}
+
+void StreamingEstimator::add(double x)
+{
+    // single far outliers would drag the extreme markers and with them the quartiles.
+    // Winsorizing them far outside the quartiles does not change the quantiles themselves.
+    constexpr std::size_t min_winsorize_count { 20 };
+    constexpr double winsorize_limit { 5. };
+    double sample { x };
+    if (m_median.count() >= min_winsorize_count) {
+        const double limit { winsorize_limit * spread() };
+        if (limit > 0.) {
+            sample = std::clamp(x, m_median.value() - limit, m_median.value() + limit);
+        }
+    }
+    m_median.add(sample);
+    m_mean.add(x);
+    const double current { value() };
+    if (m_mean.weight() > 1.) {
+        const double alpha { 1. / std::min(m_mean.weight(), m_drift_window) };
+        m_velocity += alpha * ((current - m_last_value) - m_velocity);
+    }
+    m_last_value = current;
+}
+
+auto StreamingEstimator::value() const -> double
+{
+    switch (m_location) {
+    case Location::Mean:
+        return m_mean.value();
+    case Location::Median:
+        return m_median.value();
+    case Location::Mpv:
+        return 3. * m_median.value() - 2. * m_mean.value();
+    }
+    return m_median.value();
+}
+
+auto StreamingEstimator::spread() const -> double
+{
+    if (m_median.count() < 5) {
+        return m_mean.stddev();
+    }
+    // interquartile range of a normal distribution in units of its standard deviation
+    constexpr double iqr_sigma { 1.349 };
+    return (m_median.upper() - m_median.lower()) / iqr_sigma;
+}
+
+auto StreamingEstimator::drift() const -> double
+{
+    return std::abs(m_velocity) * std::min(m_mean.weight(), m_drift_window);
+}
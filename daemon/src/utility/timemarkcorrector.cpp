@@ -0,0 +1,202 @@
+#include "utility/timemarkcorrector.h"
+#include "utility/unixtime_from_gps.h"
+
+#include <cmath>
+
+namespace {
+constexpr std::int64_t half_week_ms { GpsTime::seconds_per_week * 500 };
+
+auto to_ns(const timespec& ts) -> std::int64_t
+{
+    return static_cast<std::int64_t>(ts.tv_sec) * GpsTime::ns_per_second + ts.tv_nsec;
+}
+
+void shift(timespec& ts, std::int64_t offset_ns)
+{
+    ts = GpsTime::to_timespec(to_ns(ts) + offset_ns);
+}
+
+template <typename T>
+void append(std::deque<T>& history, const T& entry, std::size_t max_size)
+{
+    // epochs are expected in ascending order, a repeated epoch replaces the previous entry
+    while (!history.empty() && history.back().time_ns >= entry.time_ns) {
+        history.pop_back();
+    }
+    history.push_back(entry);
+    while (history.size() > max_size) {
+        history.pop_front();
+    }
+}
+}
+
+TimeMarkCorrector::TimeMarkCorrector(std::chrono::milliseconds max_delay)
+    : m_max_delay { max_delay }
+{
+}
+
+void TimeMarkCorrector::reset()
+{
+    m_pulses.clear();
+    m_clocks.clear();
+    m_pending.clear();
+    m_week_valid = false;
+    m_last_pulse_arrival = {};
+    m_last_clock_arrival = {};
+}
+
+void TimeMarkCorrector::add_time_pulse(std::uint16_t week, std::uint32_t tow_ms, std::uint32_t tow_sub_ms, std::int32_t quantization_error_ps, bool utc)
+{
+    // the sub millisecond part is scaled with 2^-32 ms
+    const auto sub_ms_ns { static_cast<std::int64_t>(std::ldexp(static_cast<double>(tow_sub_ms) * 1e6, -32) + 0.5) };
+    PulseEpoch epoch {};
+    epoch.time_ns = GpsTime::to_unix_ns(week, tow_ms / 1000, static_cast<std::int64_t>(tow_ms % 1000) * 1000000 + sub_ms_ns);
+    epoch.quantization_ns = 1e-3 * quantization_error_ps;
+    epoch.utc = utc;
+    append(m_pulses, epoch, c_history);
+
+    m_week = week;
+    m_week_tow_ms = tow_ms;
+    m_week_valid = true;
+    m_last_pulse_arrival = std::chrono::steady_clock::now();
+}
+
+void TimeMarkCorrector::add_clock(std::uint32_t tow_ms, std::int32_t bias_ns, std::int32_t drift_ns_per_s, std::uint32_t time_accuracy_ns)
+{
+    m_last_clock_arrival = std::chrono::steady_clock::now();
+    if (!m_week_valid) {
+        // NAV-CLOCK carries no week number, it is taken from the time pulses
+        return;
+    }
+    ClockSolution solution {};
+    solution.time_ns = gnss_time(tow_ms);
+    solution.bias_ns = bias_ns;
+    solution.drift_ns_per_s = drift_ns_per_s;
+    solution.accuracy_ns = time_accuracy_ns;
+    append(m_clocks, solution, c_history);
+}
+
+void TimeMarkCorrector::add_time_mark(const UbxTimeMarkStruct& tm)
+{
+    m_pending.push_back(PendingMark { tm, std::chrono::steady_clock::now() });
+}
+
+void TimeMarkCorrector::take_ready(std::vector<Result>& results, bool flush)
+{
+    const auto now { std::chrono::steady_clock::now() };
+    // the marks are released in order, a mark waiting for its data holds back the later ones
+    while (!m_pending.empty() && (flush || m_pending.size() > c_max_pending || ready(m_pending.front(), now))) {
+        results.push_back(correct(m_pending.front().tm));
+        m_pending.pop_front();
+    }
+}
+
+auto TimeMarkCorrector::gnss_time(std::uint32_t tow_ms) const -> std::int64_t
+{
+    std::int64_t week { m_week };
+    if (static_cast<std::int64_t>(tow_ms) + half_week_ms < m_week_tow_ms) {
+        week++;
+    } else if (static_cast<std::int64_t>(tow_ms) > m_week_tow_ms + half_week_ms) {
+        week--;
+    }
+    return GpsTime::to_unix_ns(week, tow_ms / 1000, static_cast<std::int64_t>(tow_ms % 1000) * 1000000);
+}
+
+auto TimeMarkCorrector::ready(const PendingMark& mark, std::chrono::steady_clock::time_point now) const -> bool
+{
+    if (now - mark.arrival >= m_max_delay) {
+        return true;
+    }
+    const std::int64_t time { to_ns(mark.tm.rising) };
+    // a stream which is not received at all does not hold back the time marks
+    const bool pulses_alive { now - m_last_pulse_arrival < m_max_delay };
+    const bool clocks_alive { now - m_last_clock_arrival < m_max_delay };
+    const bool pulse_known { !pulses_alive || (!m_pulses.empty() && m_pulses.back().time_ns > time) };
+    const bool clock_known { !clocks_alive
+        || mark.tm.timeBase != UbxTimeMarkStruct::TIMEBASE_GNSS
+        || (!m_clocks.empty() && m_clocks.back().time_ns > time) };
+    return pulse_known && clock_known;
+}
+
+template <typename T>
+auto TimeMarkCorrector::bracket(const std::deque<T>& history, std::int64_t time) -> std::pair<const T*, const T*>
+{
+    const T* before { nullptr };
+    const T* after { nullptr };
+    for (const auto& entry : history) {
+        if (entry.time_ns <= time) {
+            before = &entry;
+        } else {
+            after = &entry;
+            break;
+        }
+    }
+    if (before != nullptr && time - before->time_ns > c_max_bracket_ns) {
+        before = nullptr;
+    }
+    if (after != nullptr && after->time_ns - time > c_max_bracket_ns) {
+        after = nullptr;
+    }
+    return { before, after };
+}
+
+auto TimeMarkCorrector::correct(const UbxTimeMarkStruct& tm) const -> Result
+{
+    Result result {};
+    result.tm = tm;
+    const std::int64_t time { to_ns(tm.rising) };
+    double quantization_uncertainty { 0. };
+    double clock_uncertainty { static_cast<double>(tm.accuracy_ns) };
+
+    if (tm.timeBase == UbxTimeMarkStruct::TIMEBASE_GNSS || tm.timeBase == UbxTimeMarkStruct::TIMEBASE_UTC) {
+        const bool utc { tm.timeBase == UbxTimeMarkStruct::TIMEBASE_UTC };
+        auto [before, after] = bracket(m_pulses, time);
+        if (before != nullptr && before->utc != utc) {
+            before = nullptr;
+        }
+        if (after != nullptr && after->utc != utc) {
+            after = nullptr;
+        }
+        if (before != nullptr && after != nullptr
+            && std::abs(after->quantization_ns - before->quantization_ns) <= c_max_quantization_step) {
+            const double fraction { static_cast<double>(time - before->time_ns) / static_cast<double>(after->time_ns - before->time_ns) };
+            result.quantization_ns = before->quantization_ns + fraction * (after->quantization_ns - before->quantization_ns);
+            quantization_uncertainty = 0.5 * std::abs(after->quantization_ns - before->quantization_ns);
+            result.quantization_corrected = true;
+        } else if (before != nullptr || after != nullptr) {
+            // the sawtooth wrapped between the pulses or only one side is known, take the nearest pulse
+            const PulseEpoch* nearest { before };
+            if (nearest == nullptr || (after != nullptr && after->time_ns - time < time - before->time_ns)) {
+                nearest = after;
+            }
+            result.quantization_ns = nearest->quantization_ns;
+            quantization_uncertainty = 0.5 * c_max_quantization_step;
+            result.quantization_corrected = true;
+        }
+    }
+
+    if (tm.timeBase == UbxTimeMarkStruct::TIMEBASE_GNSS) {
+        const auto [before, after] = bracket(m_clocks, time);
+        if (before != nullptr && after != nullptr) {
+            const double interval { 1e-9 * static_cast<double>(after->time_ns - before->time_ns) };
+            const double elapsed { 1e-9 * static_cast<double>(time - before->time_ns) };
+            const double predicted_end { before->bias_ns + before->drift_ns_per_s * interval };
+            if (std::abs(after->bias_ns - predicted_end) <= c_clock_jump) {
+                // the receiver converted the capture time with the bias extrapolated from the preceding solution
+                const double fraction { elapsed / interval };
+                const double interpolated { before->bias_ns + fraction * (after->bias_ns - before->bias_ns) };
+                const double extrapolated { before->bias_ns + before->drift_ns_per_s * elapsed };
+                result.clock_ns = interpolated - extrapolated;
+                clock_uncertainty = std::hypot((1. - fraction) * before->accuracy_ns, fraction * after->accuracy_ns);
+                result.clock_corrected = true;
+            }
+        }
+    }
+
+    result.uncertainty_ns = std::hypot(clock_uncertainty, quantization_uncertainty);
+    const auto offset { static_cast<std::int64_t>(std::llround(-(result.quantization_ns + result.clock_ns))) };
+    shift(result.tm.rising, offset);
+    shift(result.tm.falling, offset);
+    result.tm.accuracy_ns = static_cast<std::uint32_t>(std::ceil(result.uncertainty_ns));
+    return result;
+}
@@ -0,0 +1,146 @@
+#include "utility/ubxratescheduler.h"
+
+#include <config.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+constexpr std::size_t ubx_frame_overhead { 8 }; //!< sync chars, class, id, length and checksum
+constexpr double uart_bits_per_byte { 10. }; //!< 8N1
+}
+
+void UbxRateScheduler::set_link(double nav_rate, std::uint32_t baud_rate)
+{
+    m_nav_rate = nav_rate;
+    m_uart_capacity = baud_rate / uart_bits_per_byte;
+}
+
+void UbxRateScheduler::add_message(std::uint16_t msg_id, Priority priority, std::size_t payload_size, bool event_driven)
+{
+    auto& message { m_messages[msg_id] };
+    message.priority = priority;
+    message.payload_size = payload_size;
+    message.event_driven = event_driven;
+}
+
+void UbxRateScheduler::set_supported(std::uint16_t msg_id, bool supported)
+{
+    m_messages[msg_id].supported = supported;
+}
+
+void UbxRateScheduler::declare(const std::string& consumer, std::uint16_t msg_id, std::uint8_t rate)
+{
+    auto& demand { m_messages[msg_id].demand };
+    if (rate == 0) {
+        demand.erase(consumer);
+        return;
+    }
+    demand[consumer] = rate;
+}
+
+void UbxRateScheduler::withdraw(const std::string& consumer)
+{
+    for (auto& [msg_id, message] : m_messages) {
+        message.demand.erase(consumer);
+    }
+}
+
+void UbxRateScheduler::force(std::uint16_t msg_id, std::uint8_t rate)
+{
+    m_messages[msg_id].forced = rate;
+}
+
+void UbxRateScheduler::set_load(double tx_usage, double event_rate)
+{
+    m_tx_usage = tx_usage;
+    m_event_rate = event_rate;
+    // one step per measurement, the next TX buffer report shows the effect of the new rates
+    if ((m_tx_usage > MuonPi::Config::Hardware::GNSS::RateScheduler::tx_usage_high
+            || uart_load(m_throttle) > MuonPi::Config::Hardware::GNSS::RateScheduler::uart_load_max)
+        && m_throttle < MuonPi::Config::Hardware::GNSS::RateScheduler::max_throttle) {
+        m_throttle *= 2;
+    } else if (m_tx_usage < MuonPi::Config::Hardware::GNSS::RateScheduler::tx_usage_low
+        && m_throttle > 1
+        && uart_load(m_throttle / 2) < MuonPi::Config::Hardware::GNSS::RateScheduler::uart_load_max) {
+        m_throttle /= 2;
+    }
+}
+
+auto UbxRateScheduler::rate(const Message& message, unsigned int throttle) const -> std::uint8_t
+{
+    if (!message.supported) {
+        return 0;
+    }
+    if (message.forced) {
+        return *message.forced;
+    }
+    if (message.demand.empty()) {
+        return 0;
+    }
+    const auto fastest { std::min_element(message.demand.begin(), message.demand.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.second < rhs.second;
+    }) };
+    unsigned int factor { 1 };
+    if (message.priority == Priority::Normal) {
+        factor = throttle;
+    } else if (message.priority == Priority::Bulk) {
+        factor = throttle * throttle;
+    }
+    return static_cast<std::uint8_t>(std::min<unsigned int>(fastest->second * factor, std::numeric_limits<std::uint8_t>::max()));
+}
+
+auto UbxRateScheduler::rates() const -> std::map<std::uint16_t, std::uint8_t>
+{
+    std::map<std::uint16_t, std::uint8_t> result {};
+    for (const auto& [msg_id, message] : m_messages) {
+        result.emplace(msg_id, rate(message, m_throttle));
+    }
+    return result;
+}
+
+auto UbxRateScheduler::take_rates() -> std::map<std::uint16_t, std::uint8_t>
+{
+    m_applied = rates();
+    return m_applied;
+}
+
+auto UbxRateScheduler::take_changes() -> std::map<std::uint16_t, std::uint8_t>
+{
+    std::map<std::uint16_t, std::uint8_t> changes {};
+    for (const auto& [msg_id, value] : rates()) {
+        const auto applied { m_applied.find(msg_id) };
+        if (applied == m_applied.end() || applied->second != value) {
+            changes.emplace(msg_id, value);
+            m_applied[msg_id] = value;
+        }
+    }
+    return changes;
+}
+
+auto UbxRateScheduler::throttle() const -> unsigned int
+{
+    return m_throttle;
+}
+
+auto UbxRateScheduler::uart_load() const -> double
+{
+    return uart_load(m_throttle);
+}
+
+auto UbxRateScheduler::uart_load(unsigned int throttle) const -> double
+{
+    double bytes_per_second { 0. };
+    for (const auto& [msg_id, message] : m_messages) {
+        const auto value { rate(message, throttle) };
+        if (value == 0) {
+            continue;
+        }
+        double frequency { m_nav_rate / value };
+        if (message.event_driven) {
+            frequency = std::min(frequency, m_event_rate);
+        }
+        bytes_per_second += frequency * (message.payload_size + ubx_frame_overhead);
+    }
+    return bytes_per_second / m_uart_capacity;
+}
@@ -0,0 +1,180 @@
+#include "utility/ubxvalconfig.h"
+
+#include <ublox_messages.h>
+
+#include <algorithm>
+#include <map>
+
+namespace {
+// output rate keys of the messages on UART1 (CFG-MSGOUT-UBX_<msg>_UART1)
+const std::map<std::uint16_t, std::uint32_t> msg_rate_keys {
+    { UBX_MSG::TIM_TM2, 0x20910179 },
+    { UBX_MSG::TIM_TP, 0x2091017e },
+    { UBX_MSG::NAV_CLOCK, 0x20910066 },
+    { UBX_MSG::NAV_DOP, 0x20910039 },
+    { UBX_MSG::NAV_EOE, 0x20910160 },
+    { UBX_MSG::NAV_GEOFENCE, 0x209100a2 },
+    { UBX_MSG::NAV_ODO, 0x2091007f },
+    { UBX_MSG::NAV_ORB, 0x20910011 },
+    { UBX_MSG::NAV_POSECEF, 0x20910025 },
+    { UBX_MSG::NAV_POSLLH, 0x2091002a },
+    { UBX_MSG::NAV_PVT, 0x20910007 },
+    { UBX_MSG::NAV_SAT, 0x20910016 },
+    { UBX_MSG::NAV_SBAS, 0x2091006b },
+    { UBX_MSG::NAV_STATUS, 0x2091001b },
+    { UBX_MSG::NAV_TIMEBDS, 0x20910052 },
+    { UBX_MSG::NAV_TIMEGAL, 0x20910057 },
+    { UBX_MSG::NAV_TIMEGLO, 0x2091004d },
+    { UBX_MSG::NAV_TIMEGPS, 0x20910048 },
+    { UBX_MSG::NAV_TIMELS, 0x20910061 },
+    { UBX_MSG::NAV_TIMEUTC, 0x2091005c },
+    { UBX_MSG::NAV_VELECEF, 0x2091003e },
+    { UBX_MSG::NAV_VELNED, 0x20910043 },
+    { UBX_MSG::MON_HW, 0x209101b5 },
+    { UBX_MSG::MON_HW2, 0x209101ba },
+    { UBX_MSG::MON_IO, 0x209101a6 },
+    { UBX_MSG::MON_MSGPP, 0x20910197 },
+    { UBX_MSG::MON_RXBUF, 0x209101a1 },
+    { UBX_MSG::MON_RXR, 0x20910188 },
+    { UBX_MSG::MON_TXBUF, 0x2091019c }
+};
+
+void append_le(std::string& data, std::uint64_t value, std::size_t size)
+{
+    for (std::size_t i { 0 }; i < size; i++) {
+        data.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+    }
+}
+
+auto read_le(const std::string& data, std::size_t pos, std::size_t size) -> std::uint64_t
+{
+    std::uint64_t value { 0 };
+    for (std::size_t i { 0 }; i < size; i++) {
+        value |= static_cast<std::uint64_t>(static_cast<std::uint8_t>(data[pos + i])) << (8 * i);
+    }
+    return value;
+}
+}
+
+void UbxValConfig::set(std::uint32_t key, std::uint64_t value)
+{
+    auto it { std::find_if(m_items.begin(), m_items.end(), [key](const Item& item) { return item.key == key; }) };
+    if (it != m_items.end()) {
+        it->value = value;
+        return;
+    }
+    m_items.push_back(Item { key, value });
+}
+
+auto UbxValConfig::set_msg_rate(std::uint16_t msg_id, std::uint8_t rate) -> bool
+{
+    const auto key { msg_rate_key(msg_id) };
+    if (key == 0) {
+        return false;
+    }
+    set(key, rate);
+    return true;
+}
+
+auto UbxValConfig::items() const -> const std::vector<Item>&
+{
+    return m_items;
+}
+
+auto UbxValConfig::empty() const -> bool
+{
+    return m_items.empty();
+}
+
+auto UbxValConfig::valset_payloads(std::uint8_t layers) const -> std::vector<std::string>
+{
+    std::vector<std::string> payloads {};
+    const std::size_t nr_messages { (m_items.size() + max_keys_per_message - 1) / max_keys_per_message };
+    for (std::size_t n { 0 }; n < nr_messages; n++) {
+        // header: version, layers, transaction, reserved
+        // a single message needs no transaction (version 0), otherwise the first message starts the transaction
+        // and the receiver applies all items when the last one arrives
+        std::string payload {};
+        payload.push_back(static_cast<char>((nr_messages > 1) ? 1 : 0));
+        payload.push_back(static_cast<char>(layers));
+        if (nr_messages == 1) {
+            payload.push_back(0);
+        } else if (n == 0) {
+            payload.push_back(1);
+        } else if (n + 1 < nr_messages) {
+            payload.push_back(2);
+        } else {
+            payload.push_back(3);
+        }
+        payload.push_back(0);
+        const auto first { m_items.begin() + n * max_keys_per_message };
+        const auto last { m_items.begin() + std::min(m_items.size(), (n + 1) * max_keys_per_message) };
+        for (auto it { first }; it != last; ++it) {
+            append_le(payload, it->key, sizeof(it->key));
+            append_le(payload, it->value, value_size(it->key));
+        }
+        payloads.push_back(std::move(payload));
+    }
+    return payloads;
+}
+
+auto UbxValConfig::valget_payloads() const -> std::vector<std::string>
+{
+    std::vector<std::string> payloads {};
+    for (std::size_t n { 0 }; n < m_items.size(); n += max_keys_per_message) {
+        // header: version, layer (0 = RAM), position
+        std::string payload { 0, 0, 0, 0 };
+        const auto last { std::min(m_items.size(), n + max_keys_per_message) };
+        for (std::size_t i { n }; i < last; i++) {
+            append_le(payload, m_items[i].key, sizeof(m_items[i].key));
+        }
+        payloads.push_back(std::move(payload));
+    }
+    return payloads;
+}
+
+auto UbxValConfig::parse_valget(const std::string& payload) -> std::vector<Item>
+{
+    std::vector<Item> items {};
+    std::size_t pos { 4 };
+    while (pos + sizeof(std::uint32_t) <= payload.size()) {
+        const auto key { static_cast<std::uint32_t>(read_le(payload, pos, sizeof(std::uint32_t))) };
+        pos += sizeof(std::uint32_t);
+        const auto size { value_size(key) };
+        if (size == 0 || pos + size > payload.size()) {
+            break;
+        }
+        items.push_back(Item { key, read_le(payload, pos, size) });
+        pos += size;
+    }
+    return items;
+}
+
+auto UbxValConfig::value_size(std::uint32_t key) -> std::size_t
+{
+    switch ((key >> 28) & 0x07) {
+    case 1: // single bit, stored in one byte
+    case 2:
+        return 1;
+    case 3:
+        return 2;
+    case 4:
+        return 4;
+    case 5:
+        return 8;
+    default:
+        return 0;
+    }
+}
+
+auto UbxValConfig::msg_rate_key(std::uint16_t msg_id) -> std::uint32_t
+{
+    const auto it { msg_rate_keys.find(msg_id) };
+    return (it == msg_rate_keys.end()) ? 0 : it->second;
+}
+
+auto UbxValConfig::msg_id_from_key(std::uint32_t key) -> std::uint16_t
+{
+    const auto it { std::find_if(msg_rate_keys.begin(), msg_rate_keys.end(), [key](const auto& entry) { return entry.second == key; }) };
+    return (it == msg_rate_keys.end()) ? 0 : it->first;
+}
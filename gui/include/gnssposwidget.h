@@ -7,25 +7,32 @@
 #include <QMap>
 #include <QPainterPath>
 #include <QPixmap>
+#include <QSet>
+#include <QTransform>
 #include <QVector>
 #include <QWidget>
 
 class GnssSatellite;
+class QPainter;
 
 constexpr int DEFAULT_CONTROL_POINTS = 5;
+constexpr int MAX_SAT_TRACK_ENTRIES { 1000 };
 
 namespace Ui {
 class GnssPosWidget;
 }
 
-struct SatHistoryPoint {
-    QPointF posCart;
+/**
+ * @brief Decimated track history of one satellite within one (azimuth, elevation) cell of the sky
+ * All samples falling into the same cell are merged into a running mean of the cnr.
+ */
+struct SatTrackCell {
     QPoint posPolar;
     quint8 satId;
     quint8 gnssId;
-    quint8 cnr;
-    QColor color;
-    QDateTime time;
+    double cnrSum; //!< sum of the cnr over the last 'entries' samples
+    int entries; //!< number of merged samples, limited to MAX_SAT_TRACK_ENTRIES
+    QDateTime time; //!< entrance time into the cell
 };
 
 class GnssPosWidget : public QWidget {
@@ -49,14 +56,31 @@ private slots:
 
 private:
     Ui::GnssPosWidget* ui;
-    QMap<int, QHash<QPoint, QVector<SatHistoryPoint>>> satTracks;
+    QHash<QPoint, QMap<int, SatTrackCell>> satTracks; //!< track cells by sky position and satellite
     QVector<GnssSatellite> fCurrentSatlist;
 
+    // the plot is composed of three layers: the static grid, the tracks and the current sat markers
+    // the grid and the tracks are cached, the tracks are only redrawn for the cells which changed
+    QPixmap fGridLayer {};
+    QPixmap fTrackLayer {};
+    QSize fLayerSize {};
+    bool fLayerPolar { true };
+    bool fGridValid { false };
+    bool fTracksValid { false };
+    QSet<QPoint> fDirtyTrackCells {};
+
     QPointF polar2cartUnity(const QPointF& pol);
     QPolygonF getPolarUnitPolygon(const QPointF& pos, int controlPoints = DEFAULT_CONTROL_POINTS);
     QPolygonF getCartPolygonUnity(const QPointF& polarPos);
-    void drawPolarPixMap(QPixmap& pm);
-    void drawCartesianPixMap(QPixmap& pm);
+    QTransform layerTransform(const QSize& size, bool polar) const;
+    QPolygonF trackCellPolygon(const QPoint& posPolar, const QSize& size, bool polar);
+    void recordTracks();
+    void clearTracks();
+    void drawGrid(QPixmap& pm, bool polar);
+    void drawTrackCells(QPainter& painter, const QPoint& posPolar, const QSize& size, bool polar);
+    void drawTracks(QPixmap& pm, bool polar);
+    void updateTrackLayer();
+    void drawMarkers(QPainter& painter, const QSize& size, bool polar);
     static int alphaFromCnr(int cnr, int range);
 };
 
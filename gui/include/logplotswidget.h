@@ -1,11 +1,13 @@
 #ifndef LOGPLOTSWIDGET_H
 #define LOGPLOTSWIDGET_H
 
-#include <QMap>
+#include <QModelIndex>
 #include <QPointF>
 #include <QString>
+#include <QTimer>
 #include <QVector>
 #include <QWidget>
+#include <logseriesmodel.h>
 
 namespace Ui {
 class LogPlotsWidget;
@@ -13,28 +15,6 @@ class LogPlotsWidget;
 
 struct LogInfoStruct;
 
-class LogBuffer {
-public:
-    LogBuffer(const QString& a_name) { name = a_name; }
-    LogBuffer() = default;
-    ~LogBuffer() { }
-    void clear() { buffer.clear(); }
-    void setName(const QString& a_name) { name = a_name; }
-    void setUnit(const QString& a_unit) { unit = a_unit; }
-    void push_back(const QPointF& p) { buffer.push_back(p); }
-    QPointF& at(int i) { return buffer[i]; }
-    const QPointF& operator()(int i) const { return buffer[i]; }
-    const QPointF& operator[](int i) const { return buffer[i]; }
-    QVector<QPointF>& data() { return buffer; }
-    const QString& getName() const { return name; }
-    const QString& getUnit() const { return unit; }
-
-private:
-    QVector<QPointF> buffer;
-    QString name = "";
-    QString unit = "";
-};
-
 class LogPlotsWidget : public QWidget {
     Q_OBJECT
 
@@ -52,17 +32,22 @@ public slots:
     void onLogInfoReceived(const LogInfoStruct& lis);
 
 private slots:
-    void updateLogTable();
-
-    void on_tableWidget_cellClicked(int row, int column);
+    void onLogTableClicked(const QModelIndex& index);
+    void selectLog(const QString& name);
+    void scheduleReplot();
     void onScalingChanged();
     void on_linesCheckBox_clicked();
     void on_pointSizeSpinBox_valueChanged(int arg1);
 
 private:
+    void appendLogPoint(const QString& name, const QString& unit, double value);
+    void updateCurveResolution();
+    void resizeEvent(QResizeEvent* event) override;
+
     Ui::LogPlotsWidget* ui;
-    QMap<QString, LogBuffer> fLogMap;
+    LogSeriesModel fLogModel;
     QString fCurrentLog = "";
+    QTimer fReplotTimer; //!< coalesces the replots of incoming points to the display refresh rate
 };
 
 #endif // LOGPLOTSWIDGET_H
@@ -0,0 +1,52 @@
+#ifndef LOGSERIESMODEL_H
+#define LOGSERIESMODEL_H
+
+#include <QAbstractTableModel>
+#include <QMap>
+#include <QPointF>
+#include <QString>
+#include <memory>
+#include <timeseries.h>
+
+struct LogBuffer {
+    QString name {};
+    QString unit {};
+    std::shared_ptr<TimeSeries> series { std::make_shared<TimeSeries>() };
+};
+
+/**
+ * @brief Table model over the log series, one row per log parameter
+ * Appending to an existing series only signals the change of its entry counter cell.
+ */
+class LogSeriesModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    enum Column {
+        NameColumn = 0,
+        EntriesColumn,
+        ColumnCount
+    };
+
+    explicit LogSeriesModel(QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    /**
+     * @brief append a point to the named series, the series is created if it does not exist yet
+     */
+    void append(const QString& name, const QString& unit, const QPointF& point);
+    void clear();
+
+    [[nodiscard]] auto find(const QString& name) const -> const LogBuffer*;
+    [[nodiscard]] auto nameAt(int row) const -> QString;
+    [[nodiscard]] auto rowOf(const QString& name) const -> int;
+
+private:
+    QMap<QString, LogBuffer> m_logs {};
+};
+
+#endif // LOGSERIESMODEL_H
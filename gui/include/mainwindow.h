@@ -13,6 +13,7 @@
 #include <gpio_pin_definitions.h>
 #include <mqtthandler.h>
 #include <tcpconnection.h>
+#include <tcpmessagedispatcher.h>
 
 struct I2cDeviceEntry;
 struct CalibStruct;
@@ -154,6 +155,7 @@ private:
     void sendGainSwitch(bool status);
 
     void updateUiProperties();
+    void setupTcpDispatcher();
     int verbose = 0;
     float biasDacVoltage = 0.;
     bool biasON, uiValuesUpToDate = false;
@@ -179,6 +181,7 @@ private:
     double minBiasVoltage = 0.;
     double maxBiasVoltage = 3.3;
     QTimer m_connection_timeout {};
+    TcpMessageDispatcher m_tcp_dispatcher {};
 };
 
 #endif // MAINWINDOW_H
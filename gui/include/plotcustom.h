@@ -1,6 +1,7 @@
 #ifndef PLOTCUSTOM_H
 #define PLOTCUSTOM_H
 #include <QPointer>
+#include <timeseries.h>
 #include <qwt_plot.h>
 #include <qwt_plot_curve.h>
 #include <qwt_plot_grid.h>
@@ -20,8 +21,8 @@ public:
     }
 
     // for other plots: subclass "PlotCustom" and put all specific functions (like below) to the new class
-    void plotXorSamples(QVector<QPointF>& xorSamples);
-    void plotAndSamples(QVector<QPointF>& andSamples);
+    void plotXorSamples(const TimeSeries& xorSamples);
+    void plotAndSamples(const TimeSeries& andSamples);
 
     const QString title = "Rate Statistics";
 public slots:
@@ -32,7 +33,7 @@ public slots:
 private:
     void initialize();
     QString xAxisPreset = "seconds";
-    void plotSamples(QVector<QPointF>& samples, QwtPlotCurve& curve);
+    void plotSamples(const TimeSeries& samples, QwtPlotCurve& curve);
     QwtPlotGrid grid;
     QwtPlotCurve xorCurve;
     QwtPlotCurve andCurve;
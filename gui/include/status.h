@@ -9,6 +9,7 @@
 #include <QWidget>
 #include <gpio_pin_definitions.h>
 #include <mqtthandler.h>
+#include <timeseries.h>
 
 namespace Ui {
 class Status;
@@ -56,8 +57,8 @@ private slots:
 
 private:
     Ui::Status* statusUi;
-    QVector<QPointF> xorSamples;
-    QVector<QPointF> andSamples;
+    TimeSeries xorSamples;
+    TimeSeries andSamples;
     QTimer timepulseTimer;
     static constexpr quint64 rateSecondsBufferedDefault { 60 * 120 }; // 120 min
     quint64 rateSecondsBuffered { rateSecondsBufferedDefault };
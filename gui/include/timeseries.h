@@ -0,0 +1,64 @@
+#ifndef TIMESERIES_H
+#define TIMESERIES_H
+
+#include <QPointF>
+#include <QRectF>
+#include <QVector>
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+/**
+ * @brief Multi-resolution store for time series plots
+ * Besides the raw points, a pyramid of min/max buckets is maintained incrementally. Level l
+ * holds the y-extrema of fan_out^(l+1) consecutive raw points. samples() serves a range of the
+ * series with a bounded number of points by reading the level matching the requested resolution,
+ * which preserves peaks and dips of the data. The x values are expected in ascending order.
+ */
+class TimeSeries {
+public:
+    static constexpr std::size_t fan_out { 4 };
+
+    void append(const QPointF& point);
+    void clear();
+    /**
+     * @brief drop all points with an x value lower than x
+     */
+    void removeBefore(double x);
+
+    [[nodiscard]] auto size() const -> std::size_t { return m_points.size(); }
+    [[nodiscard]] auto isEmpty() const -> bool { return m_points.empty(); }
+    [[nodiscard]] auto first() const -> const QPointF& { return m_points.front(); }
+    [[nodiscard]] auto last() const -> const QPointF& { return m_points.back(); }
+    [[nodiscard]] auto at(std::size_t i) const -> const QPointF& { return m_points[i]; }
+    [[nodiscard]] auto revision() const -> std::size_t { return m_revision; } //!< changes with every modification
+    [[nodiscard]] auto boundingRect() const -> QRectF;
+
+    /**
+     * @brief the points in the x range [x_min, x_max], reduced to at most ~max_points points
+     * One point on either side of the range is included so that lines extend to the plot border.
+     */
+    [[nodiscard]] auto samples(double x_min, double x_max, std::size_t max_points) const -> QVector<QPointF>;
+    [[nodiscard]] auto samples(std::size_t max_points) const -> QVector<QPointF>;
+
+private:
+    struct Bucket {
+        QPointF min;
+        QPointF max;
+    };
+    struct Level {
+        std::size_t front { 0 }; //!< absolute index of the first bucket
+        std::deque<Bucket> buckets {};
+    };
+
+    static void extend(Bucket& bucket, const QPointF& point);
+    void addLevel();
+    void appendExtrema(QVector<QPointF>& out, std::size_t first, std::size_t last) const;
+
+    std::deque<QPointF> m_points {};
+    std::size_t m_front { 0 }; //!< absolute index of the first raw point
+    std::size_t m_revision { 0 };
+    std::vector<Level> m_levels {};
+};
+
+#endif // TIMESERIES_H
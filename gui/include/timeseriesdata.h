@@ -0,0 +1,37 @@
+#ifndef TIMESERIESDATA_H
+#define TIMESERIESDATA_H
+
+#include <QVector>
+#include <memory>
+#include <qwt_series_data.h>
+#include <timeseries.h>
+
+/**
+ * @brief Qwt series adapter which references a shared TimeSeries instead of copying it
+ * The curve sees the decimated points of its current rect of interest. These are only
+ * recalculated when the series was modified or the visible area or resolution changed.
+ */
+class TimeSeriesData : public QwtSeriesData<QPointF> {
+public:
+    explicit TimeSeriesData(std::shared_ptr<const TimeSeries> series, std::size_t max_points = 2000);
+
+    void setMaxPoints(std::size_t max_points);
+
+    size_t size() const override;
+    QPointF sample(size_t i) const override;
+    QRectF boundingRect() const override;
+    void setRectOfInterest(const QRectF& rect) override;
+
+private:
+    void update() const;
+
+    std::shared_ptr<const TimeSeries> m_series {};
+    std::size_t m_max_points { 2000 };
+    QRectF m_rect_of_interest {};
+
+    mutable QVector<QPointF> m_samples {};
+    mutable std::size_t m_revision { 0 };
+    mutable bool m_valid { false };
+};
+
+#endif // TIMESERIESDATA_H
@@ -11,7 +11,7 @@
 #include <QTransform>
 #include <algorithm>
 #include <cmath>
-#include <numeric>
+#include <limits>
 #include <ublox_structs.h>
 #define _USE_MATH_DEFINES
 
@@ -32,8 +32,6 @@ double constexpr sqrt(double x)
 constexpr double pi() { return M_PI; }
 constexpr double sqrt2() { return Detail::sqrt(2.); }
 
-constexpr int MAX_SAT_TRACK_ENTRIES { 1000 };
-
 static const QVector<QColor> GNSS_COLORS = { Qt::darkGreen, Qt::darkYellow, Qt::blue, Qt::magenta, Qt::gray, Qt::cyan, Qt::red, Qt::black };
 
 int GnssPosWidget::alphaFromCnr(int cnr, int range)
@@ -56,7 +54,10 @@ GnssPosWidget::GnssPosWidget(QWidget* parent)
     this->setContextMenuPolicy(Qt::CustomContextMenu);
     connect(this, SIGNAL(customContextMenuRequested(const QPoint&)), this, SLOT(popUpMenu(const QPoint&)));
     connect(ui->cartPolarCheckBox, &QCheckBox::toggled, this, [this](bool /*checked*/) { resizeEvent(nullptr); });
-    connect(ui->cnrRangeSpinBox, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this, [this](int) { replot(); });
+    connect(ui->cnrRangeSpinBox, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this, [this](int) {
+        fTracksValid = false;
+        replot();
+    });
 }
 
 GnssPosWidget::~GnssPosWidget()
@@ -68,6 +69,7 @@ void GnssPosWidget::changeEvent(QEvent* e)
 {
     if (e->type() == QEvent::PaletteChange) {
         // update canvas background to appropriate theme
+        fGridValid = false;
         replot();
     }
     QWidget::changeEvent(e);
@@ -147,127 +149,94 @@ QPointF GnssPosWidget::polar2cartUnity(const QPointF& pol)
     return QPointF(xpos, ypos);
 }
 
-void GnssPosWidget::drawPolarPixMap(QPixmap& pm)
+QTransform GnssPosWidget::layerTransform(const QSize& size, bool polar) const
 {
-    QVector<GnssSatellite> newlist {};
-
-    const int satPosPixmapSize { pm.width() };
-    const QPointF originOffset(satPosPixmapSize / 2., satPosPixmapSize / 2.);
-
-    pm.fill(QApplication::palette().color(QPalette::Base));
-    QPainter satPosPainter(&pm);
-    satPosPainter.setPen(QPen(QApplication::palette().color(QPalette::WindowText)));
-    satPosPainter.drawEllipse(QPoint(satPosPixmapSize / 2, satPosPixmapSize / 2), satPosPixmapSize / 6, satPosPixmapSize / 6);
-    satPosPainter.drawEllipse(QPoint(satPosPixmapSize / 2, satPosPixmapSize / 2), satPosPixmapSize / 3, satPosPixmapSize / 3);
-    satPosPainter.drawEllipse(QPoint(satPosPixmapSize / 2, satPosPixmapSize / 2), satPosPixmapSize / 2, satPosPixmapSize / 2);
-    satPosPainter.drawLine(QPoint(satPosPixmapSize / 2, 0), QPoint(satPosPixmapSize / 2, satPosPixmapSize));
-    satPosPainter.drawLine(QPoint(0, satPosPixmapSize / 2), QPoint(satPosPixmapSize, satPosPixmapSize / 2));
-    satPosPainter.drawText(satPosPixmapSize / 2 + 2, 3, 18, 18, Qt::AlignHCenter, "N");
-    satPosPainter.drawText(satPosPixmapSize / 2 + 2, satPosPixmapSize - 19, 18, 18, Qt::AlignHCenter, "S");
-    satPosPainter.drawText(4, satPosPixmapSize / 2 - 19, 18, 18, Qt::AlignHCenter, "W");
-    satPosPainter.drawText(satPosPixmapSize - 19, satPosPixmapSize / 2 - 19, 18, 18, Qt::AlignHCenter, "E");
-
-    QFont font = satPosPainter.font();
-    font.setPointSize(font.pointSize() - 2);
-    satPosPainter.setFont(font);
-    satPosPainter.drawText(satPosPixmapSize / 2 - 14, satPosPixmapSize - 12, 18, 18, Qt::AlignHCenter, "0°");
-    satPosPainter.drawText(satPosPixmapSize / 2 - 16, satPosPixmapSize * 5 / 6 - 12, 18, 18, Qt::AlignHCenter, "30°");
-    satPosPainter.drawText(satPosPixmapSize / 2 - 16, satPosPixmapSize * 2 / 3 - 12, 18, 18, Qt::AlignHCenter, "60°");
-
-    // set up coordinate transformation
     QTransform trafo {};
-    trafo.translate(originOffset.x(), originOffset.y());
-    trafo.scale(satPosPixmapSize, satPosPixmapSize);
-    satPosPainter.setTransform(trafo);
+    if (polar) {
+        // maps the cartesian unity coordinates of polar2cartUnity onto the pixmap
+        trafo.translate(size.width() / 2., size.width() / 2.);
+        trafo.scale(size.width(), size.width());
+    } else {
+        // maps (azimuth, elevation) in degrees onto the pixmap
+        trafo.translate(0., 9 * size.height() / 10.);
+        trafo.scale(size.width() / 360., -9. * size.height() / 900.);
+    }
+    return trafo;
+}
 
-    // draw the sat tracks first
-    if (ui->tracksCheckBox->isChecked()) {
-        for (const auto& pointMap : satTracks) {
-            for (const auto& pointVector : pointMap) {
-                if (pointVector.isEmpty())
-                    continue;
-                const double mean_cnr {
-                    std::accumulate(pointVector.constBegin(), pointVector.constEnd(), 0, [](int sum, const SatHistoryPoint& satpoint) {
-                        return sum + satpoint.cnr;
-                    })
-                    / static_cast<double>(pointVector.size())
-                };
-                const auto satPoint { pointVector.front() };
-                QColor satColor { GNSS_COLORS.at(std::clamp(static_cast<int>(satPoint.gnssId), 0, GNSS_COLORS.size() - 1)) };
-                satColor.setAlpha(alphaFromCnr(mean_cnr, ui->cnrRangeSpinBox->value()));
-                satPosPainter.setPen(QColor("transparent"));
-                satPosPainter.setBrush(satColor);
-                QPainterPath path;
-                path.addPolygon(getCartPolygonUnity(satPoint.posPolar));
-                satPosPainter.drawPolygon(path.toFillPolygon(QTransform()));
-            }
-        }
+QPolygonF GnssPosWidget::trackCellPolygon(const QPoint& posPolar, const QSize& size, bool polar)
+{
+    if (polar) {
+        return layerTransform(size, polar).map(getCartPolygonUnity(posPolar));
     }
+    return layerTransform(size, polar).map(getPolarUnitPolygon(posPolar));
+}
 
-    // draw the current sat positions now
+void GnssPosWidget::recordTracks()
+{
+    const int cnrRange { ui->cnrRangeSpinBox->value() };
+    const QDateTime now { QDateTime::currentDateTimeUtc() };
     for (const auto& currentSat : fCurrentSatlist) {
-        if (ui->receivedSatsCheckBox->isChecked()) {
-            if (currentSat.Cnr > 0)
-                newlist.push_back(currentSat);
+        if (currentSat.Cnr == 0 || currentSat.Elev > 90 || currentSat.Elev < -90)
+            continue;
+        const QPoint posPolar(currentSat.Azim, currentSat.Elev);
+        const int satId { currentSat.GnssId * 1000 + currentSat.SatId };
+        auto& cells { satTracks[posPolar] };
+        auto it { cells.find(satId) };
+        if (it == cells.end()) {
+            cells.insert(satId, SatTrackCell { posPolar, currentSat.SatId, currentSat.GnssId, static_cast<double>(currentSat.Cnr), 1, now });
+            fDirtyTrackCells.insert(posPolar);
+            continue;
+        }
+        const int alpha { alphaFromCnr(it->cnrSum / it->entries, cnrRange) };
+        // keep a running mean over the last MAX_SAT_TRACK_ENTRIES samples instead of the samples themselves
+        if (it->entries >= MAX_SAT_TRACK_ENTRIES) {
+            it->cnrSum -= it->cnrSum / it->entries;
         } else {
-            newlist.push_back(currentSat);
+            it->entries++;
         }
-        if (currentSat.Elev <= 90. && currentSat.Elev >= -90.) {
-            if (ui->receivedSatsCheckBox->isChecked() && currentSat.Cnr == 0)
-                continue;
-            QPointF currPos(currentSat.Azim, currentSat.Elev);
-            QPointF currPoint { polar2cartUnity(currPos) };
-            QColor satColor { GNSS_COLORS.at(std::clamp(static_cast<int>(currentSat.GnssId), 0, GNSS_COLORS.size() - 1)) };
-            satPosPainter.setPen(satColor);
-            QColor fillColor { satColor };
-            int alpha = alphaFromCnr(currentSat.Cnr, ui->cnrRangeSpinBox->value());
-            fillColor.setAlpha(alpha);
-            int satId { currentSat.GnssId * 1000 + currentSat.SatId };
-            if (currentSat.Cnr > 0) {
-                SatHistoryPoint p {};
-                p.posCart = currPoint;
-                p.color = fillColor;
-                p.posPolar = QPoint(currPos.x(), currPos.y());
-                p.gnssId = currentSat.GnssId;
-                p.satId = currentSat.SatId;
-                p.cnr = currentSat.Cnr;
-                p.time = QDateTime::currentDateTimeUtc();
-                satTracks[satId][p.posPolar].push_back(p);
-                if (satTracks[satId][p.posPolar].size() > MAX_SAT_TRACK_ENTRIES)
-                    satTracks[satId][p.posPolar].pop_front();
-            }
-            satPosPainter.setPen(satColor);
-            satPosPainter.setBrush(fillColor);
-
-            // somehow, drawEllipse doesn't work with a painter when a transform is set before (bug?)
-            // so reset the transform of the painter and do the scaling and shifting manually
-            satPosPainter.setTransform(QTransform());
-            currPoint *= satPosPixmapSize;
-            currPoint += originOffset;
-
-            int satsize { ui->satSizeSpinBox->value() };
-            satPosPainter.drawEllipse(currPoint, satsize / 2., satsize / 2.);
-            if (currentSat.Used) {
-                satPosPainter.setPen(QApplication::palette().color(QPalette::WindowText));
-                satPosPainter.drawEllipse(currPoint, 1.2 * satsize / 2., 1.2 * satsize / 2.);
-                satPosPainter.setPen(satColor);
-            }
-            currPoint.rx() += satsize / 2 + 4;
-            if (ui->satLabelsCheckBox->isChecked())
-                satPosPainter.drawText(currPoint, QString::number(currentSat.SatId));
+        it->cnrSum += currentSat.Cnr;
+        if (alphaFromCnr(it->cnrSum / it->entries, cnrRange) != alpha) {
+            fDirtyTrackCells.insert(posPolar);
         }
     }
 }
 
-void GnssPosWidget::drawCartesianPixMap(QPixmap& pm)
+void GnssPosWidget::clearTracks()
 {
-    QVector<GnssSatellite> newlist {};
-
-    const QPointF originOffset(0., pm.height() * 0.9);
+    satTracks.clear();
+    fDirtyTrackCells.clear();
+    fTracksValid = false;
+}
 
+void GnssPosWidget::drawGrid(QPixmap& pm, bool polar)
+{
     pm.fill(QApplication::palette().color(QPalette::Base));
     QPainter satPosPainter(&pm);
     satPosPainter.setPen(QPen(QApplication::palette().color(QPalette::WindowText)));
+
+    if (polar) {
+        const int satPosPixmapSize { pm.width() };
+        satPosPainter.drawEllipse(QPoint(satPosPixmapSize / 2, satPosPixmapSize / 2), satPosPixmapSize / 6, satPosPixmapSize / 6);
+        satPosPainter.drawEllipse(QPoint(satPosPixmapSize / 2, satPosPixmapSize / 2), satPosPixmapSize / 3, satPosPixmapSize / 3);
+        satPosPainter.drawEllipse(QPoint(satPosPixmapSize / 2, satPosPixmapSize / 2), satPosPixmapSize / 2, satPosPixmapSize / 2);
+        satPosPainter.drawLine(QPoint(satPosPixmapSize / 2, 0), QPoint(satPosPixmapSize / 2, satPosPixmapSize));
+        satPosPainter.drawLine(QPoint(0, satPosPixmapSize / 2), QPoint(satPosPixmapSize, satPosPixmapSize / 2));
+        satPosPainter.drawText(satPosPixmapSize / 2 + 2, 3, 18, 18, Qt::AlignHCenter, "N");
+        satPosPainter.drawText(satPosPixmapSize / 2 + 2, satPosPixmapSize - 19, 18, 18, Qt::AlignHCenter, "S");
+        satPosPainter.drawText(4, satPosPixmapSize / 2 - 19, 18, 18, Qt::AlignHCenter, "W");
+        satPosPainter.drawText(satPosPixmapSize - 19, satPosPixmapSize / 2 - 19, 18, 18, Qt::AlignHCenter, "E");
+
+        QFont font = satPosPainter.font();
+        font.setPointSize(font.pointSize() - 2);
+        satPosPainter.setFont(font);
+        satPosPainter.drawText(satPosPixmapSize / 2 - 14, satPosPixmapSize - 12, 18, 18, Qt::AlignHCenter, "0°");
+        satPosPainter.drawText(satPosPixmapSize / 2 - 16, satPosPixmapSize * 5 / 6 - 12, 18, 18, Qt::AlignHCenter, "30°");
+        satPosPainter.drawText(satPosPixmapSize / 2 - 16, satPosPixmapSize * 2 / 3 - 12, 18, 18, Qt::AlignHCenter, "60°");
+        return;
+    }
+
+    const QPointF originOffset(0., pm.height() * 0.9);
     satPosPainter.drawLine(originOffset, originOffset + QPointF(pm.width(), 0));
     satPosPainter.drawLine(0.33 * originOffset, 0.33 * originOffset + QPointF(pm.width(), 0));
     satPosPainter.drawLine(0.67 * originOffset, 0.67 * originOffset + QPointF(pm.width(), 0));
@@ -285,99 +254,109 @@ void GnssPosWidget::drawCartesianPixMap(QPixmap& pm)
     satPosPainter.drawText(pm.width() / 2, originOffset.y() - 10, 18, 18, Qt::AlignHCenter, "0°");
     satPosPainter.drawText(pm.width() / 2, 0.33 * originOffset.y() + 3, 18, 18, Qt::AlignHCenter, "60°");
     satPosPainter.drawText(pm.width() / 2, 0.67 * originOffset.y() + 3, 18, 18, Qt::AlignHCenter, "30°");
+}
 
-    // draw the sat tracks first
-    if (ui->tracksCheckBox->isChecked()) {
-        for (const auto& pointMap : satTracks) {
-            for (const auto& pointVector : pointMap) {
-                if (pointVector.isEmpty())
-                    continue;
-                const double mean_cnr {
-                    std::accumulate(pointVector.constBegin(), pointVector.constEnd(), 0, [](int sum, const SatHistoryPoint& satpoint) {
-                        return sum + satpoint.cnr;
-                    })
-                    / static_cast<double>(pointVector.size())
-                };
-                const auto satPoint { pointVector.front() };
-                QColor satColor { GNSS_COLORS.at(std::clamp(static_cast<int>(satPoint.gnssId), 0, GNSS_COLORS.size() - 1)) };
-                satColor.setAlpha(alphaFromCnr(mean_cnr, ui->cnrRangeSpinBox->value()));
-                satPosPainter.setPen(QColor("transparent"));
-                satPosPainter.setBrush(satColor);
-
-                QPainterPath path;
-                path.addPolygon(getPolarUnitPolygon(satPoint.posPolar));
-
-                QTransform trafo;
-                trafo.translate(0., 9 * pm.height() / 10.);
-                trafo.scale(pm.width() / 360., -9. * pm.height() / 900.);
-                satPosPainter.drawPolygon(path.toFillPolygon(trafo));
-            }
-        }
+void GnssPosWidget::drawTrackCells(QPainter& painter, const QPoint& posPolar, const QSize& size, bool polar)
+{
+    const auto it { satTracks.constFind(posPolar) };
+    if (it == satTracks.cend() || it->isEmpty())
+        return;
+    const QPolygonF polygon { trackCellPolygon(posPolar, size, polar) };
+    painter.setPen(Qt::NoPen);
+    for (const auto& cell : *it) {
+        QColor satColor { GNSS_COLORS.at(std::clamp(static_cast<int>(cell.gnssId), 0, GNSS_COLORS.size() - 1)) };
+        satColor.setAlpha(alphaFromCnr(cell.cnrSum / cell.entries, ui->cnrRangeSpinBox->value()));
+        painter.setBrush(satColor);
+        painter.drawPolygon(polygon);
     }
+}
 
-    // draw the current sat positions now
-    for (const auto& currentSat : fCurrentSatlist) {
-        if (ui->receivedSatsCheckBox->isChecked()) {
-            if (currentSat.Cnr > 0)
-                newlist.push_back(currentSat);
-        } else {
-            newlist.push_back(currentSat);
-        }
-        if (currentSat.Elev <= 90. && currentSat.Elev >= -90.) {
-            if (ui->receivedSatsCheckBox->isChecked() && currentSat.Cnr == 0)
-                continue;
-            QPointF currPos(currentSat.Azim, currentSat.Elev);
-            QPointF currPoint = polar2cartUnity(currPos);
-            QColor satColor { GNSS_COLORS.at(std::clamp(static_cast<int>(currentSat.GnssId), 0, GNSS_COLORS.size() - 1)) };
-            satPosPainter.setPen(satColor);
-            QColor fillColor { satColor };
-            int alpha { alphaFromCnr(currentSat.Cnr, ui->cnrRangeSpinBox->value()) };
-            fillColor.setAlpha(alpha);
-            int satId { currentSat.GnssId * 1000 + currentSat.SatId };
-
-            if (currentSat.Cnr > 0) {
-                SatHistoryPoint p {};
-                p.posCart = currPoint;
-                p.color = fillColor;
-                p.posPolar = QPoint(currPos.x(), currPos.y());
-                p.gnssId = currentSat.GnssId;
-                p.satId = currentSat.SatId;
-                p.cnr = currentSat.Cnr;
-                p.time = QDateTime::currentDateTimeUtc();
-                satTracks[satId][p.posPolar].push_back(p);
-                if (satTracks[satId][p.posPolar].size() > MAX_SAT_TRACK_ENTRIES)
-                    satTracks[satId][p.posPolar].pop_front();
-            }
-            satPosPainter.setPen(satColor);
-            satPosPainter.setBrush(fillColor);
+void GnssPosWidget::drawTracks(QPixmap& pm, bool polar)
+{
+    QPainter painter(&pm);
+    for (auto it = satTracks.cbegin(); it != satTracks.cend(); ++it) {
+        drawTrackCells(painter, it.key(), pm.size(), polar);
+    }
+}
 
-            currPos = QPointF(currPos.x() / 360. * pm.width(), -currPos.y() / 90. * pm.height() * 0.9 + pm.height() * 0.9);
+void GnssPosWidget::updateTrackLayer()
+{
+    if (!fTracksValid) {
+        fTrackLayer = QPixmap(fLayerSize);
+        fTrackLayer.fill(Qt::transparent);
+        drawTracks(fTrackLayer, fLayerPolar);
+        fDirtyTrackCells.clear();
+        fTracksValid = true;
+        return;
+    }
+    if (fDirtyTrackCells.isEmpty())
+        return;
+    // only the changed cells are erased and redrawn, together with the tracks of other sats sharing the cell
+    QPainter painter(&fTrackLayer);
+    for (const auto& posPolar : fDirtyTrackCells) {
+        painter.setCompositionMode(QPainter::CompositionMode_Clear);
+        painter.setPen(Qt::NoPen);
+        painter.setBrush(Qt::black);
+        painter.drawPolygon(trackCellPolygon(posPolar, fLayerSize, fLayerPolar));
+        painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+        drawTrackCells(painter, posPolar, fLayerSize, fLayerPolar);
+    }
+    fDirtyTrackCells.clear();
+}
 
-            int satsize { ui->satSizeSpinBox->value() };
-            satPosPainter.drawEllipse(currPos, satsize / 2., satsize / 2.);
-            if (currentSat.Used) {
-                satPosPainter.setPen(QApplication::palette().color(QPalette::WindowText));
-                satPosPainter.drawEllipse(currPos, 1.2 * satsize / 2., 1.2 * satsize / 2.);
-                satPosPainter.setPen(satColor);
-            }
-            currPos.rx() += satsize / 2 + 4;
-            if (ui->satLabelsCheckBox->isChecked())
-                satPosPainter.drawText(currPos, QString::number(currentSat.SatId));
+void GnssPosWidget::drawMarkers(QPainter& painter, const QSize& size, bool polar)
+{
+    const QTransform trafo { layerTransform(size, polar) };
+    const int satsize { ui->satSizeSpinBox->value() };
+    for (const auto& currentSat : fCurrentSatlist) {
+        if (currentSat.Elev > 90 || currentSat.Elev < -90)
+            continue;
+        if (ui->receivedSatsCheckBox->isChecked() && currentSat.Cnr == 0)
+            continue;
+        const QPointF currPos(currentSat.Azim, currentSat.Elev);
+        QPointF currPoint { trafo.map(polar ? polar2cartUnity(currPos) : currPos) };
+        QColor satColor { GNSS_COLORS.at(std::clamp(static_cast<int>(currentSat.GnssId), 0, GNSS_COLORS.size() - 1)) };
+        QColor fillColor { satColor };
+        fillColor.setAlpha(alphaFromCnr(currentSat.Cnr, ui->cnrRangeSpinBox->value()));
+        painter.setPen(satColor);
+        painter.setBrush(fillColor);
+
+        painter.drawEllipse(currPoint, satsize / 2., satsize / 2.);
+        if (currentSat.Used) {
+            painter.setPen(QApplication::palette().color(QPalette::WindowText));
+            painter.drawEllipse(currPoint, 1.2 * satsize / 2., 1.2 * satsize / 2.);
+            painter.setPen(satColor);
         }
+        currPoint.rx() += satsize / 2 + 4;
+        if (ui->satLabelsCheckBox->isChecked())
+            painter.drawText(currPoint, QString::number(currentSat.SatId));
     }
 }
 
 void GnssPosWidget::replot()
 {
-    const int w { ui->satLabel->width() };
-    const int h { ui->satLabel->height() };
+    const QSize size { ui->satLabel->size() };
+    const bool polar { ui->cartPolarCheckBox->isChecked() };
+    if (size != fLayerSize || polar != fLayerPolar) {
+        fLayerSize = size;
+        fLayerPolar = polar;
+        fGridValid = false;
+        fTracksValid = false;
+    }
+    if (!fGridValid) {
+        fGridLayer = QPixmap(fLayerSize);
+        drawGrid(fGridLayer, fLayerPolar);
+        fGridValid = true;
+    }
 
-    QPixmap satPosPixmap(w, h);
-    if (ui->cartPolarCheckBox->isChecked()) {
-        drawPolarPixMap(satPosPixmap);
-    } else {
-        drawCartesianPixMap(satPosPixmap);
+    QPixmap satPosPixmap { fGridLayer };
+    QPainter painter(&satPosPixmap);
+    if (ui->tracksCheckBox->isChecked()) {
+        updateTrackLayer();
+        painter.drawPixmap(0, 0, fTrackLayer);
     }
+    drawMarkers(painter, fLayerSize, fLayerPolar);
+    painter.end();
 
     ui->satLabel->setPixmap(satPosPixmap);
 }
@@ -385,6 +364,7 @@ void GnssPosWidget::replot()
 void GnssPosWidget::onSatsReceived(const QVector<GnssSatellite>& satlist)
 {
     fCurrentSatlist = satlist;
+    recordTracks();
     replot();
 }
 
@@ -406,7 +386,7 @@ void GnssPosWidget::popUpMenu(const QPoint& pos)
     QMenu contextMenu(tr("Context menu"), this);
 
     QAction action2("&Clear Tracks", this);
-    connect(&action2, &QAction::triggered, this, [this](bool /*checked*/) { satTracks.clear() ; this->replot(); });
+    connect(&action2, &QAction::triggered, this, [this](bool /*checked*/) { clearTracks(); this->replot(); });
     contextMenu.addAction(&action2);
 
     contextMenu.addSeparator();
@@ -422,12 +402,20 @@ void GnssPosWidget::exportToFile()
 {
     constexpr int pixmapSize { 512 };
     QPixmap satPosPixmap {};
-    if (ui->cartPolarCheckBox->isChecked()) {
+    const bool polar { ui->cartPolarCheckBox->isChecked() };
+    if (polar) {
         satPosPixmap = QPixmap(pixmapSize, pixmapSize);
-        drawPolarPixMap(satPosPixmap);
     } else {
         satPosPixmap = QPixmap(sqrt2() * pixmapSize, pixmapSize);
-        drawCartesianPixMap(satPosPixmap);
+    }
+    // rendered without the layer caches, which belong to the on-screen size
+    drawGrid(satPosPixmap, polar);
+    if (ui->tracksCheckBox->isChecked()) {
+        drawTracks(satPosPixmap, polar);
+    }
+    {
+        QPainter painter(&satPosPixmap);
+        drawMarkers(painter, satPosPixmap.size(), polar);
     }
 
     QString types("JPEG file (*.jpeg);;" // Set up the possible graphics formats
@@ -472,18 +460,9 @@ void GnssPosWidget::exportToFile()
             out << "# datetime marks the entrance time into space point (az,el)\n";
             out << "# <ISO8601-datetime> <gnss-id> <gnss-id-string> <sat-id> <azimuth> <elevation> <cnr>\n";
 
-            for (const auto& pointMap : satTracks) {
-                for (const auto& pointVector : pointMap) {
-                    if (pointVector.isEmpty())
-                        continue;
-                    const double mean_cnr {
-                        std::accumulate(pointVector.constBegin(), pointVector.constEnd(), 0, [](int sum, const SatHistoryPoint& satpoint) {
-                            return sum + satpoint.cnr;
-                        })
-                        / static_cast<double>(pointVector.size())
-                    };
-
-                    SatHistoryPoint p { pointVector.front() };
+            for (const auto& cells : satTracks) {
+                for (const auto& p : cells) {
+                    const double mean_cnr { p.cnrSum / p.entries };
                     out << p.time.toString(Qt::ISODate) << " "
                         << p.gnssId << " "
                         << QString::fromLocal8Bit(Gnss::Id::name[std::clamp(static_cast<int>(p.gnssId), static_cast<int>(Gnss::Id::first), static_cast<int>(Gnss::Id::last))]) << p.satId << " "
@@ -1,10 +1,14 @@
 #include "logplotswidget.h"
 #include "ui_logplotswidget.h"
 #include <QDateTime>
+#include <QGuiApplication>
+#include <QScreen>
+#include <algorithm>
 #include <muondetector_structs.h>
 #include <qwt_date_scale_draw.h>
 #include <qwt_date_scale_engine.h>
 #include <qwt_symbol.h>
+#include <timeseriesdata.h>
 
 LogPlotsWidget::LogPlotsWidget(QWidget* parent)
     : QWidget(parent)
@@ -24,6 +28,24 @@ LogPlotsWidget::LogPlotsWidget(QWidget* parent)
 
     ui->logPlot->setMinimumHeight(100);
 
+    ui->tableView->setModel(&fLogModel);
+    connect(ui->tableView, &QTableView::clicked, this, &LogPlotsWidget::onLogTableClicked);
+    connect(&fLogModel, &QAbstractItemModel::rowsInserted, this, [this]() {
+        ui->nrLogsLabel->setText(QString::number(fLogModel.rowCount()));
+    });
+    connect(&fLogModel, &QAbstractItemModel::modelReset, this, [this]() {
+        ui->nrLogsLabel->setText(QString::number(fLogModel.rowCount()));
+    });
+
+    const QScreen* screen { QGuiApplication::primaryScreen() };
+    const qreal refreshRate { (screen != nullptr && screen->refreshRate() > 0.) ? screen->refreshRate() : 60. };
+    fReplotTimer.setSingleShot(true);
+    fReplotTimer.setInterval(static_cast<int>(1000. / refreshRate));
+    connect(&fReplotTimer, &QTimer::timeout, this, [this]() {
+        ui->logPlot->replot();
+        onScalingChanged();
+    });
+
     ui->logPlot->replot();
 }
 
@@ -34,111 +56,92 @@ LogPlotsWidget::~LogPlotsWidget()
 
 void LogPlotsWidget::onTemperatureReceived(float temp)
 {
-    auto it = fLogMap.find("Temperature");
-    if (it == fLogMap.end()) {
-        fLogMap["Temperature"].setName("Temperature");
-        fLogMap["Temperature"].setUnit("°C");
-    }
-    QPointF p;
-    p.setX(QDateTime::currentMSecsSinceEpoch());
-    p.setY(temp);
-    fLogMap["Temperature"].push_back(p);
-    updateLogTable();
+    appendLogPoint("Temperature", "°C", temp);
 }
 
 void LogPlotsWidget::onTimeAccReceived(quint32 acc)
 {
-    auto it = fLogMap.find("Time Accuracy");
-    if (it == fLogMap.end()) {
-        fLogMap["Time Accuracy"].setName("Time Accuracy");
-        fLogMap["Time Accuracy"].setUnit("ns");
-    }
-    QPointF p;
-    p.setX(QDateTime::currentMSecsSinceEpoch());
-    p.setY(acc);
-    fLogMap["Time Accuracy"].push_back(p);
-    updateLogTable();
+    appendLogPoint("Time Accuracy", "ns", acc);
 }
 
 void LogPlotsWidget::onBiasVoltageCalculated(float ubias)
 {
-    const QString name = "SiPM Bias Voltage";
-    auto it = fLogMap.find(name);
-    if (it == fLogMap.end()) {
-        fLogMap[name].setName(name);
-        fLogMap[name].setUnit("V");
-    }
-    QPointF p;
-    p.setX(QDateTime::currentMSecsSinceEpoch());
-    p.setY(ubias);
-    fLogMap[name].push_back(p);
-    updateLogTable();
+    appendLogPoint("SiPM Bias Voltage", "V", ubias);
 }
 
 void LogPlotsWidget::onBiasCurrentCalculated(float ibias)
 {
-    const QString name = "SiPM Bias Current";
-    auto it = fLogMap.find(name);
-    if (it == fLogMap.end()) {
-        fLogMap[name].setName(name);
-        fLogMap[name].setUnit("uA");
+    appendLogPoint("SiPM Bias Current", "uA", ibias);
+}
+
+void LogPlotsWidget::appendLogPoint(const QString& name, const QString& unit, double value)
+{
+    fLogModel.append(name, unit, QPointF(QDateTime::currentMSecsSinceEpoch(), value));
+    if (name == fCurrentLog) {
+        // the curve references the series, it only has to be redrawn
+        scheduleReplot();
     }
-    QPointF p;
-    p.setX(QDateTime::currentMSecsSinceEpoch());
-    p.setY(ibias);
-    fLogMap[name].push_back(p);
-    updateLogTable();
-}
-
-void LogPlotsWidget::updateLogTable()
-{
-    ui->nrLogsLabel->setText(QString::number(fLogMap.size()));
-    ui->tableWidget->setRowCount(fLogMap.size());
-    int i = 0;
-    for (auto it = fLogMap.begin(); it != fLogMap.end(); it++) {
-        QTableWidgetItem* newItem1 = new QTableWidgetItem(it.key());
-        newItem1->setSizeHint(QSize(120, 24));
-        ui->tableWidget->setItem(i, 0, newItem1);
-        QTableWidgetItem* newItem2 = new QTableWidgetItem(QString::number(it.value().data().size()));
-        newItem2->setSizeHint(QSize(100, 24));
-        ui->tableWidget->setItem(i, 1, newItem2);
-        i++;
+}
+
+void LogPlotsWidget::scheduleReplot()
+{
+    if (!fReplotTimer.isActive()) {
+        fReplotTimer.start();
     }
+}
 
-    if (!fCurrentLog.isEmpty()) {
-        for (int j = 0; j < ui->tableWidget->rowCount(); j++) {
-            if (ui->tableWidget->item(j, 0)->text() == fCurrentLog) {
-                on_tableWidget_cellClicked(j, 0);
-            }
-        }
+void LogPlotsWidget::updateCurveResolution()
+{
+    auto data { dynamic_cast<TimeSeriesData*>(ui->logPlot->curve("curve1").data()) };
+    if (data == nullptr) {
+        return;
     }
+    // about two points (min and max) per pixel column
+    data->setMaxPoints(2 * static_cast<std::size_t>(std::max(ui->logPlot->canvas()->width(), 100)));
 }
 
-void LogPlotsWidget::on_tableWidget_cellClicked(int row, int /*column*/)
-{
-    QString name = ui->tableWidget->item(row, 0)->text();
-    auto it = fLogMap.find(name);
-    if (it != fLogMap.end()) {
-        ui->logPlot->setTitle(name);
-        ui->logPlot->curve("curve1").setSamples(it->data());
-        ui->logPlot->setAxisTitle(QwtPlot::xBottom, "time");
-        ui->logPlot->setAxisTitle(QwtPlot::yLeft, it->getUnit());
-        ui->logNameLabel->setText(it->getName());
-        if (fCurrentLog == name) {
-            ui->logPlot->setAxisAutoScale(QwtPlot::xBottom);
-            ui->logPlot->setAxisAutoScale(QwtPlot::yLeft);
-        }
-        fCurrentLog = name;
-        ui->logPlot->replot();
-        onScalingChanged();
+void LogPlotsWidget::resizeEvent(QResizeEvent* event)
+{
+    QWidget::resizeEvent(event);
+    updateCurveResolution();
+}
+
+void LogPlotsWidget::onLogTableClicked(const QModelIndex& index)
+{
+    if (!index.isValid()) {
+        return;
     }
+    selectLog(fLogModel.nameAt(index.row()));
+}
+
+void LogPlotsWidget::selectLog(const QString& name)
+{
+    const LogBuffer* log { fLogModel.find(name) };
+    if (log == nullptr) {
+        return;
+    }
+    ui->logPlot->setTitle(name);
+    ui->logPlot->setAxisTitle(QwtPlot::xBottom, "time");
+    ui->logPlot->setAxisTitle(QwtPlot::yLeft, log->unit);
+    ui->logNameLabel->setText(log->name);
+    if (fCurrentLog == name) {
+        ui->logPlot->setAxisAutoScale(QwtPlot::xBottom);
+        ui->logPlot->setAxisAutoScale(QwtPlot::yLeft);
+    } else {
+        ui->logPlot->curve("curve1").setData(new TimeSeriesData(log->series));
+        updateCurveResolution();
+    }
+    fCurrentLog = name;
+    ui->logPlot->replot();
+    onScalingChanged();
 }
 
 void LogPlotsWidget::onUiEnabledStateChange(bool connected)
 {
     if (!connected) {
-        ui->tableWidget->setRowCount(0);
+        ui->logPlot->curve("curve1").setSamples(QVector<QPointF> {});
         ui->logPlot->curve("curve1").hide();
+        fLogModel.clear();
         ui->logNameLabel->setText("N/A");
         ui->nrLogsLabel->setText(QString::number(0));
         ui->dataFileNameLineEdit->setText("N/A");
@@ -151,8 +154,8 @@ void LogPlotsWidget::onUiEnabledStateChange(bool connected)
         ui->logRotationSpinBox->setEnabled(false);
         ui->logEnableCheckBox->setChecked(false);
         ui->logEnableCheckBox->setEnabled(false);
-        fLogMap.clear();
         fCurrentLog = "";
+        fReplotTimer.stop();
         ui->logPlot->replot();
     } else {
         ui->logPlot->curve("curve1").show();
@@ -198,18 +201,7 @@ void LogPlotsWidget::onGpioRatesReceived(quint8 whichrate, QVector<QPointF> rate
     } else
         return;
 
-    auto it = fLogMap.find(name);
-    if (it == fLogMap.end()) {
-        fLogMap[name].setName(name);
-        fLogMap[name].setUnit("1/s");
-    }
-
-    QPointF p;
-    p.setX(QDateTime::currentMSecsSinceEpoch());
-    p.setY(rates.last().y());
-    fLogMap[name].push_back(p);
-
-    updateLogTable();
+    appendLogPoint(name, "1/s", rates.last().y());
 }
 
 void LogPlotsWidget::onLogInfoReceived(const LogInfoStruct& lis)
@@ -0,0 +1,95 @@
+#include "logseriesmodel.h"
+
+#include <QSize>
+#include <iterator>
+
+LogSeriesModel::LogSeriesModel(QObject* parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+int LogSeriesModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_logs.size();
+}
+
+int LogSeriesModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant LogSeriesModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_logs.size()) {
+        return QVariant();
+    }
+    const auto it { std::next(m_logs.cbegin(), index.row()) };
+    if (role == Qt::DisplayRole) {
+        if (index.column() == NameColumn) {
+            return it.key();
+        }
+        if (index.column() == EntriesColumn) {
+            return QString::number(it->series->size());
+        }
+    } else if (role == Qt::SizeHintRole) {
+        return QSize((index.column() == NameColumn) ? 120 : 100, 24);
+    }
+    return QVariant();
+}
+
+QVariant LogSeriesModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole || orientation != Qt::Horizontal) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+    if (section == NameColumn) {
+        return QString("Parameter");
+    }
+    if (section == EntriesColumn) {
+        return QString("Entries");
+    }
+    return QVariant();
+}
+
+void LogSeriesModel::append(const QString& name, const QString& unit, const QPointF& point)
+{
+    auto it { m_logs.find(name) };
+    if (it == m_logs.end()) {
+        const int row { static_cast<int>(std::distance(m_logs.begin(), m_logs.lowerBound(name))) };
+        beginInsertRows(QModelIndex(), row, row);
+        it = m_logs.insert(name, LogBuffer { name, unit });
+        it->series->append(point);
+        endInsertRows();
+        return;
+    }
+    it->series->append(point);
+    const QModelIndex cell { index(static_cast<int>(std::distance(m_logs.begin(), it)), EntriesColumn) };
+    emit dataChanged(cell, cell, { Qt::DisplayRole });
+}
+
+void LogSeriesModel::clear()
+{
+    beginResetModel();
+    m_logs.clear();
+    endResetModel();
+}
+
+auto LogSeriesModel::find(const QString& name) const -> const LogBuffer*
+{
+    const auto it { m_logs.constFind(name) };
+    return (it == m_logs.cend()) ? nullptr : &it.value();
+}
+
+auto LogSeriesModel::nameAt(int row) const -> QString
+{
+    if (row < 0 || row >= m_logs.size()) {
+        return QString();
+    }
+    return std::next(m_logs.cbegin(), row).key();
+}
+
+auto LogSeriesModel::rowOf(const QString& name) const -> int
+{
+    const auto it { m_logs.constFind(name) };
+    return (it == m_logs.cend()) ? -1 : static_cast<int>(std::distance(m_logs.cbegin(), it));
+}
@@ -63,6 +63,8 @@ MainWindow::MainWindow(QWidget* parent)
     qRegisterMetaType<ADC_SAMPLING_MODE>("ADC_SAMPLING_MODE");
     qRegisterMetaType<PositionModeConfig>("PositionModeConfig");
 
+    setupTcpDispatcher();
+
     ui->setupUi(this);
     this->setWindowTitle(QString("muondetector-gui  " + QString::fromStdString(MuonPi::Version::software.string())));
 
@@ -411,21 +413,20 @@ bool MainWindow::eventFilter(QObject* object, QEvent* event)
 void MainWindow::receivedTcpMessage(TcpMessage tcpMessage)
 {
     m_connection_timeout.start();
-    TCP_MSG_KEY msgID = static_cast<TCP_MSG_KEY>(tcpMessage.getMsgID());
-    if (msgID == TCP_MSG_KEY::MSG_GPIO_EVENT) {
-        unsigned int gpioPin;
-        *(tcpMessage.dStream) >> gpioPin;
+    if (!m_tcp_dispatcher.dispatch(tcpMessage)) {
+        qWarning() << "received unknown TCP message, msgID =" << QString::number(tcpMessage.getMsgID());
+    }
+}
+
+void MainWindow::setupTcpDispatcher()
+{
+    m_tcp_dispatcher.on<unsigned int>(TCP_MSG_KEY::MSG_GPIO_EVENT, [this](unsigned int gpioPin) {
         receivedGpioRisingEdge((GPIO_SIGNAL)gpioPin);
-        return;
-    } else if (msgID == TCP_MSG_KEY::MSG_UBX_MSG_RATE) {
-        QMap<uint16_t, int> msgRateCfgs {};
-        *(tcpMessage.dStream) >> msgRateCfgs;
+    });
+    m_tcp_dispatcher.on<QMap<uint16_t, int>>(TCP_MSG_KEY::MSG_UBX_MSG_RATE, [this](QMap<uint16_t, int> msgRateCfgs) {
         emit addUbxMsgRates(msgRateCfgs);
-        return;
-    } else if (msgID == TCP_MSG_KEY::MSG_THRESHOLD) {
-        quint8 channel;
-        float threshold;
-        *(tcpMessage.dStream) >> channel >> threshold;
+    });
+    m_tcp_dispatcher.on<quint8, float>(TCP_MSG_KEY::MSG_THRESHOLD, [this](quint8 channel, float threshold) {
         if (threshold > maxThreshVoltage) {
             sendSetThresh(channel, maxThreshVoltage);
             return;
@@ -434,33 +435,37 @@ void MainWindow::receivedTcpMessage(TcpMessage tcpMessage)
             sliderValuesDirty = true;
         }
         sliderValues.at(channel) = 1e3 * threshold;
-    } else if (msgID == TCP_MSG_KEY::MSG_BIAS_VOLTAGE) {
-        *(tcpMessage.dStream) >> biasDacVoltage;
-    } else if (msgID == TCP_MSG_KEY::MSG_BIAS_SWITCH) {
-        *(tcpMessage.dStream) >> biasON;
+        updateUiProperties();
+    });
+    m_tcp_dispatcher.on<float>(TCP_MSG_KEY::MSG_BIAS_VOLTAGE, [this](float voltage) {
+        biasDacVoltage = voltage;
+        updateUiProperties();
+    });
+    m_tcp_dispatcher.on<bool>(TCP_MSG_KEY::MSG_BIAS_SWITCH, [this](bool status) {
+        biasON = status;
         emit biasSwitchReceived(biasON);
-    } else if (msgID == TCP_MSG_KEY::MSG_PREAMP_SWITCH) {
-        quint8 channel;
-        bool state;
-        *(tcpMessage.dStream) >> channel >> state;
+        updateUiProperties();
+    });
+    m_tcp_dispatcher.on<quint8, bool>(TCP_MSG_KEY::MSG_PREAMP_SWITCH, [this](quint8 channel, bool state) {
         emit preampSwitchReceived(channel, state);
-    } else if (msgID == TCP_MSG_KEY::MSG_GAIN_SWITCH) {
-        bool gainSwitch { false };
-        *(tcpMessage.dStream) >> gainSwitch;
+        updateUiProperties();
+    });
+    m_tcp_dispatcher.on<bool>(TCP_MSG_KEY::MSG_GAIN_SWITCH, [this](bool gainSwitch) {
         emit gainSwitchReceived(gainSwitch);
-    } else if (msgID == TCP_MSG_KEY::MSG_PCA_SWITCH) {
-        *(tcpMessage.dStream) >> pcaPortMask;
+        updateUiProperties();
+    });
+    m_tcp_dispatcher.on<quint8>(TCP_MSG_KEY::MSG_PCA_SWITCH, [this](quint8 portMask) {
+        pcaPortMask = portMask;
         if (pcaPortMask != static_cast<int>(TIMING_MUX_SELECTION::UNDEFINED)) {
             emit inputSwitchReceived(static_cast<TIMING_MUX_SELECTION>(pcaPortMask));
         }
-    } else if (msgID == TCP_MSG_KEY::MSG_EVENTTRIGGER) {
-        unsigned int signal;
-        *(tcpMessage.dStream) >> signal;
+        updateUiProperties();
+    });
+    m_tcp_dispatcher.on<unsigned int>(TCP_MSG_KEY::MSG_EVENTTRIGGER, [this](unsigned int signal) {
         emit triggerSelectionReceived((GPIO_SIGNAL)signal);
-    } else if (msgID == TCP_MSG_KEY::MSG_GPIO_RATE) {
-        quint8 whichRate;
-        QVector<QPointF> rate;
-        *(tcpMessage.dStream) >> whichRate >> rate;
+        updateUiProperties();
+    });
+    m_tcp_dispatcher.on<quint8, QVector<QPointF>>(TCP_MSG_KEY::MSG_GPIO_RATE, [this](quint8 whichRate, QVector<QPointF> rate) {
         float rateYValue;
         if (!rate.empty()) {
             rateYValue = rate.at(rate.size() - 1).y();
@@ -474,42 +479,39 @@ void MainWindow::receivedTcpMessage(TcpMessage tcpMessage)
             ui->rate2->setText(QString::number(rateYValue, 'g', 3) + "/s");
         }
         emit gpioRates(whichRate, rate);
-    } else if (msgID == TCP_MSG_KEY::MSG_QUIT_CONNECTION) {
-        connectedToDemon = false;
-        return;
-    } else if (msgID == TCP_MSG_KEY::MSG_GEO_POS) {
+        updateUiProperties();
+    });
+    m_tcp_dispatcher.on(TCP_MSG_KEY::MSG_QUIT_CONNECTION, [this]() { connectedToDemon = false; });
+    m_tcp_dispatcher.handle(TCP_MSG_KEY::MSG_GEO_POS, [this](TcpMessage& tcpMessage) {
         GnssPosStruct pos {};
         *(tcpMessage.dStream) >> pos.iTOW >> pos.lon >> pos.lat
             >> pos.height >> pos.hMSL >> pos.hAcc >> pos.vAcc;
         emit geodeticPos(pos);
-        return;
-    } else if (msgID == TCP_MSG_KEY::MSG_ADC_SAMPLE) {
-        quint8 channel;
-        float value;
-        *(tcpMessage.dStream) >> channel >> value;
+    });
+    m_tcp_dispatcher.on<quint8, float>(TCP_MSG_KEY::MSG_ADC_SAMPLE, [this](quint8 channel, float value) {
         emit adcSampleReceived(channel, value);
-        return;
-    } else if (msgID == TCP_MSG_KEY::MSG_ADC_TRACE) {
+    });
+    m_tcp_dispatcher.handle(TCP_MSG_KEY::MSG_ADC_TRACE, [this](TcpMessage& tcpMessage) {
         quint16 size;
         QVector<float> sampleBuffer;
         *(tcpMessage.dStream) >> size;
+        sampleBuffer.reserve(size);
         for (int i = 0; i < size; i++) {
             float value;
             *(tcpMessage.dStream) >> value;
             sampleBuffer.push_back(value);
         }
         emit adcTraceReceived(sampleBuffer);
-        return;
-    } else if (msgID == TCP_MSG_KEY::MSG_DAC_READBACK) {
-        quint8 channel;
-        float value;
-        *(tcpMessage.dStream) >> channel >> value;
+    });
+    m_tcp_dispatcher.on<quint8, float>(TCP_MSG_KEY::MSG_DAC_READBACK, [this](quint8 channel, float value) {
         emit dacReadbackReceived(channel, value);
-    } else if (msgID == TCP_MSG_KEY::MSG_TEMPERATURE) {
-        float value;
-        *(tcpMessage.dStream) >> value;
+        updateUiProperties();
+    });
+    m_tcp_dispatcher.on<float>(TCP_MSG_KEY::MSG_TEMPERATURE, [this](float value) {
         emit temperatureReceived(value);
-    } else if (msgID == TCP_MSG_KEY::MSG_I2C_STATS) {
+        updateUiProperties();
+    });
+    m_tcp_dispatcher.handle(TCP_MSG_KEY::MSG_I2C_STATS, [this](TcpMessage& tcpMessage) {
         quint8 nrDevices = 0;
         quint32 bytesRead = 0;
         quint32 bytesWritten = 0;
@@ -528,13 +530,9 @@ void MainWindow::receivedTcpMessage(TcpMessage tcpMessage)
             deviceList.push_back(entry);
         }
         emit i2cStatsReceived(bytesRead, bytesWritten, deviceList);
-        return;
-    } else if (msgID == TCP_MSG_KEY::MSG_SPI_STATS) {
-        bool spiPresent;
-        *(tcpMessage.dStream) >> spiPresent;
-        emit spiStatsReceived(spiPresent);
-        return;
-    } else if (msgID == TCP_MSG_KEY::MSG_CALIB_SET) {
+    });
+    m_tcp_dispatcher.on<bool>(TCP_MSG_KEY::MSG_SPI_STATS, [this](bool spiPresent) { emit spiStatsReceived(spiPresent); });
+    m_tcp_dispatcher.handle(TCP_MSG_KEY::MSG_CALIB_SET, [this](TcpMessage& tcpMessage) {
         quint16 nrPars = 0;
         quint64 id = 0;
         bool valid = false;
@@ -548,8 +546,8 @@ void MainWindow::receivedTcpMessage(TcpMessage tcpMessage)
             calibList.push_back(item);
         }
         emit calibReceived(valid, eepromValid, id, calibList);
-        return;
-    } else if (msgID == TCP_MSG_KEY::MSG_GNSS_SATS) {
+    });
+    m_tcp_dispatcher.handle(TCP_MSG_KEY::MSG_GNSS_SATS, [this](TcpMessage& tcpMessage) {
         int nrSats = 0;
         *(tcpMessage.dStream) >> nrSats;
 
@@ -560,8 +558,8 @@ void MainWindow::receivedTcpMessage(TcpMessage tcpMessage)
             satList.push_back(sat);
         }
         emit satsReceived(satList);
-        return;
-    } else if (msgID == TCP_MSG_KEY::MSG_UBX_GNSS_CONFIG) {
+    });
+    m_tcp_dispatcher.handle(TCP_MSG_KEY::MSG_UBX_GNSS_CONFIG, [this](TcpMessage& tcpMessage) {
         int numTrkCh = 0;
         int nrConfigs = 0;
 
@@ -574,29 +572,15 @@ void MainWindow::receivedTcpMessage(TcpMessage tcpMessage)
             configList.push_back(config);
         }
         emit gnssConfigsReceived(numTrkCh, configList);
-        return;
-    } else if (msgID == TCP_MSG_KEY::MSG_UBX_TIME_ACCURACY) {
-        quint32 acc = 0;
-        *(tcpMessage.dStream) >> acc;
-        emit timeAccReceived(acc);
-        return;
-    } else if (msgID == TCP_MSG_KEY::MSG_UBX_FREQ_ACCURACY) {
-        quint32 acc = 0;
-        *(tcpMessage.dStream) >> acc;
-        emit freqAccReceived(acc);
-        return;
-    } else if (msgID == TCP_MSG_KEY::MSG_UBX_EVENTCOUNTER) {
-        quint32 cnt = 0;
-        *(tcpMessage.dStream) >> cnt;
+    });
+    m_tcp_dispatcher.on<quint32>(TCP_MSG_KEY::MSG_UBX_TIME_ACCURACY, [this](quint32 acc) { emit timeAccReceived(acc); });
+    m_tcp_dispatcher.on<quint32>(TCP_MSG_KEY::MSG_UBX_FREQ_ACCURACY, [this](quint32 acc) { emit freqAccReceived(acc); });
+    m_tcp_dispatcher.on<quint32>(TCP_MSG_KEY::MSG_UBX_EVENTCOUNTER, [this](quint32 cnt) {
         emit intCounterReceived(cnt);
         ui->eventCounter->setText(QString::number(cnt));
-        return;
-    } else if (msgID == TCP_MSG_KEY::MSG_UBX_UPTIME) {
-        quint32 val = 0;
-        *(tcpMessage.dStream) >> val;
-        emit ubxUptimeReceived(val);
-        return;
-    } else if (msgID == TCP_MSG_KEY::MSG_UBX_TXBUF) {
+    });
+    m_tcp_dispatcher.on<quint32>(TCP_MSG_KEY::MSG_UBX_UPTIME, [this](quint32 val) { emit ubxUptimeReceived(val); });
+    m_tcp_dispatcher.handle(TCP_MSG_KEY::MSG_UBX_TXBUF, [this](TcpMessage& tcpMessage) {
         quint8 val = 0;
         *(tcpMessage.dStream) >> val;
         emit txBufReceived(val);
@@ -604,8 +588,8 @@ void MainWindow::receivedTcpMessage(TcpMessage tcpMessage)
             *(tcpMessage.dStream) >> val;
             emit txBufPeakReceived(val);
         }
-        return;
-    } else if (msgID == TCP_MSG_KEY::MSG_UBX_RXBUF) {
+    });
+    m_tcp_dispatcher.handle(TCP_MSG_KEY::MSG_UBX_RXBUF, [this](TcpMessage& tcpMessage) {
         quint8 val = 0;
         *(tcpMessage.dStream) >> val;
         emit rxBufReceived(val);
@@ -613,65 +597,21 @@ void MainWindow::receivedTcpMessage(TcpMessage tcpMessage)
             *(tcpMessage.dStream) >> val;
             emit rxBufPeakReceived(val);
         }
-        return;
-    } else if (msgID == TCP_MSG_KEY::MSG_UBX_TXBUF_PEAK) {
-        quint8 val = 0;
-        *(tcpMessage.dStream) >> val;
-        emit txBufPeakReceived(val);
-        return;
-    } else if (msgID == TCP_MSG_KEY::MSG_UBX_RXBUF_PEAK) {
-        quint8 val = 0;
-        *(tcpMessage.dStream) >> val;
-        emit rxBufPeakReceived(val);
-        return;
-    } else if (msgID == TCP_MSG_KEY::MSG_UBX_MONHW) {
-        GnssMonHwStruct hw;
-        *(tcpMessage.dStream) >> hw;
-        emit gpsMonHWReceived(hw);
-        return;
-    } else if (msgID == TCP_MSG_KEY::MSG_UBX_MONHW2) {
-        GnssMonHw2Struct hw2;
-        *(tcpMessage.dStream) >> hw2;
-        emit gpsMonHW2Received(hw2);
-        return;
-    } else if (msgID == TCP_MSG_KEY::MSG_UBX_VERSION) {
-        QString sw = "";
-        QString hw = "";
-        QString pv = "";
-        *(tcpMessage.dStream) >> sw >> hw >> pv;
+    });
+    m_tcp_dispatcher.on<quint8>(TCP_MSG_KEY::MSG_UBX_TXBUF_PEAK, [this](quint8 val) { emit txBufPeakReceived(val); });
+    m_tcp_dispatcher.on<quint8>(TCP_MSG_KEY::MSG_UBX_RXBUF_PEAK, [this](quint8 val) { emit rxBufPeakReceived(val); });
+    m_tcp_dispatcher.on<GnssMonHwStruct>(TCP_MSG_KEY::MSG_UBX_MONHW, [this](GnssMonHwStruct hw) { emit gpsMonHWReceived(hw); });
+    m_tcp_dispatcher.on<GnssMonHw2Struct>(TCP_MSG_KEY::MSG_UBX_MONHW2, [this](GnssMonHw2Struct hw2) { emit gpsMonHW2Received(hw2); });
+    m_tcp_dispatcher.on<QString, QString, QString>(TCP_MSG_KEY::MSG_UBX_VERSION, [this](QString sw, QString hw, QString pv) {
         emit gpsVersionReceived(sw, hw, pv);
-        return;
-    } else if (msgID == TCP_MSG_KEY::MSG_UBX_FIXSTATUS) {
-        quint8 val = 0;
-        *(tcpMessage.dStream) >> val;
-        emit gpsFixReceived(val);
-        return;
-    } else if (msgID == TCP_MSG_KEY::MSG_UBX_CFG_TP5) {
-        UbxTimePulseStruct tp {};
-        *(tcpMessage.dStream) >> tp;
-        emit gpsTP5Received(tp);
-        return;
-    } else if (msgID == TCP_MSG_KEY::MSG_HISTOGRAM) {
-        Histogram h {};
-        *(tcpMessage.dStream) >> h;
-        emit histogramReceived(h);
-        return;
-    } else if (msgID == TCP_MSG_KEY::MSG_ADC_MODE) {
-        quint8 mode;
-        *(tcpMessage.dStream) >> mode;
-        emit adcModeReceived(mode);
-        return;
-    } else if (msgID == TCP_MSG_KEY::MSG_LOG_INFO) {
-        LogInfoStruct lis;
-        *(tcpMessage.dStream) >> lis;
-        emit logInfoReceived(lis);
-        return;
-    } else if (msgID == TCP_MSG_KEY::MSG_UBX_TIMEMARK) {
-        UbxTimeMarkStruct tm;
-        *(tcpMessage.dStream) >> tm;
-        emit timeMarkReceived(tm);
-        return;
-    } else if (msgID == TCP_MSG_KEY::MSG_MQTT_STATUS) {
+    });
+    m_tcp_dispatcher.on<quint8>(TCP_MSG_KEY::MSG_UBX_FIXSTATUS, [this](quint8 val) { emit gpsFixReceived(val); });
+    m_tcp_dispatcher.on<UbxTimePulseStruct>(TCP_MSG_KEY::MSG_UBX_CFG_TP5, [this](UbxTimePulseStruct tp) { emit gpsTP5Received(tp); });
+    m_tcp_dispatcher.on<Histogram>(TCP_MSG_KEY::MSG_HISTOGRAM, [this](Histogram h) { emit histogramReceived(h); });
+    m_tcp_dispatcher.on<quint8>(TCP_MSG_KEY::MSG_ADC_MODE, [this](quint8 mode) { emit adcModeReceived(mode); });
+    m_tcp_dispatcher.on<LogInfoStruct>(TCP_MSG_KEY::MSG_LOG_INFO, [this](LogInfoStruct lis) { emit logInfoReceived(lis); });
+    m_tcp_dispatcher.on<UbxTimeMarkStruct>(TCP_MSG_KEY::MSG_UBX_TIMEMARK, [this](UbxTimeMarkStruct tm) { emit timeMarkReceived(tm); });
+    m_tcp_dispatcher.handle(TCP_MSG_KEY::MSG_MQTT_STATUS, [this](TcpMessage& tcpMessage) {
         bool connected = false;
         *(tcpMessage.dStream) >> connected;
         if (tcpMessage.dStream->atEnd()) {
@@ -682,38 +622,19 @@ void MainWindow::receivedTcpMessage(TcpMessage tcpMessage)
             MuonPi::MqttHandler::Status status { extStatus };
             emit mqttStatusChanged(status);
         }
-        return;
-    } else if (msgID == TCP_MSG_KEY::MSG_POLARITY_SWITCH) {
-        bool pol1;
-        bool pol2;
-        *(tcpMessage.dStream) >> pol1 >> pol2;
+    });
+    m_tcp_dispatcher.on<bool, bool>(TCP_MSG_KEY::MSG_POLARITY_SWITCH, [this](bool pol1, bool pol2) {
         emit polaritySwitchReceived(pol1, pol2);
-        return;
-    } else if (msgID == TCP_MSG_KEY::MSG_GPIO_INHIBIT) {
-        bool inhibit;
-        *(tcpMessage.dStream) >> inhibit;
-        emit gpioInhibitReceived(inhibit);
-        return;
-    } else if (msgID == TCP_MSG_KEY::MSG_MQTT_INHIBIT) {
-        bool inhibit;
-        *(tcpMessage.dStream) >> inhibit;
-        emit mqttInhibitReceived(inhibit);
-        return;
-    } else if (msgID == TCP_MSG_KEY::MSG_VERSION) {
-        MuonPi::Version::Version hw_ver, sw_ver;
-        *(tcpMessage.dStream) >> hw_ver >> sw_ver;
-        emit daemonVersionReceived(hw_ver, sw_ver);
-        return;
-    } else if (msgID == TCP_MSG_KEY::MSG_POSITION_MODEL) {
-        PositionModeConfig posconfig {};
-        *(tcpMessage.dStream) >> posconfig;
+    });
+    m_tcp_dispatcher.on<bool>(TCP_MSG_KEY::MSG_GPIO_INHIBIT, [this](bool inhibit) { emit gpioInhibitReceived(inhibit); });
+    m_tcp_dispatcher.on<bool>(TCP_MSG_KEY::MSG_MQTT_INHIBIT, [this](bool inhibit) { emit mqttInhibitReceived(inhibit); });
+    m_tcp_dispatcher.on<MuonPi::Version::Version, MuonPi::Version::Version>(TCP_MSG_KEY::MSG_VERSION,
+        [this](MuonPi::Version::Version hw_ver, MuonPi::Version::Version sw_ver) {
+            emit daemonVersionReceived(hw_ver, sw_ver);
+        });
+    m_tcp_dispatcher.on<PositionModeConfig>(TCP_MSG_KEY::MSG_POSITION_MODEL, [this](PositionModeConfig posconfig) {
         emit positionModeConfigReceived(posconfig);
-        return;
-    } else {
-        qWarning() << "received unknown TCP message, msgID =" << QString::number(static_cast<int>(msgID));
-        return;
-    }
-    updateUiProperties();
+    });
 }
 
 void MainWindow::sendRequest(quint16 requestSig)
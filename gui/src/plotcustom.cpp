@@ -1,6 +1,7 @@
 #include <QApplication>
 #include <QEvent>
 #include <QTime>
+#include <algorithm>
 #include <plotcustom.h>
 #include <qpen.h>
 #include <qwt.h>
@@ -111,14 +112,18 @@ void PlotCustom::changeEvent(QEvent* e)
     QwtPlot::changeEvent(e);
 }
 
-void PlotCustom::plotSamples(QVector<QPointF>& samples, QwtPlotCurve& curve)
+void PlotCustom::plotSamples(const TimeSeries& samples, QwtPlotCurve& curve)
 {
     if (!isEnabled())
         return;
-    QVector<QPointF> someSamples;
-    for (auto sample : samples) {
-        someSamples.push_back(sample);
-        someSamples.last().setX(sample.x() - samples.at(samples.size() - 1).x());
+    // about two points (min and max) per pixel column are sufficient
+    const std::size_t maxPoints { 2 * static_cast<std::size_t>(std::max(canvas()->width(), 100)) };
+    QVector<QPointF> someSamples { samples.samples(maxPoints) };
+    if (!someSamples.isEmpty()) {
+        const qreal xLast { samples.last().x() };
+        for (auto& sample : someSamples) {
+            sample.setX(sample.x() - xLast);
+        }
     }
 
     qreal xMin = 0.0;
@@ -136,13 +141,13 @@ void PlotCustom::plotSamples(QVector<QPointF>& samples, QwtPlotCurve& curve)
     replot();
 }
 
-void PlotCustom::plotXorSamples(QVector<QPointF>& xorSamples)
+void PlotCustom::plotXorSamples(const TimeSeries& xorSamples)
 {
     setPreset("");
     plotSamples(xorSamples, xorCurve);
 }
 
-void PlotCustom::plotAndSamples(QVector<QPointF>& andSamples)
+void PlotCustom::plotAndSamples(const TimeSeries& andSamples)
 {
     setPreset("");
     plotSamples(andSamples, andCurve);
@@ -66,71 +66,24 @@ void Status::onGpioRatesReceived(quint8 whichrate, QVector<QPointF> rates)
 {
     if (rates.isEmpty())
         return;
+    TimeSeries* samples { nullptr };
     if (whichrate == 0) {
-        if (xorSamples.size() > 0) {
-            for (int k = rates.size() - 1; k >= 0; k--) {
-                bool foundK { false }; // if foundK it has found an index k where the x values of the input points
-                // are smaller or equal to the x values of the already existing points -> overlap
-                for (int i = xorSamples.size() - 1; i >= xorSamples.size() - 1 - rates.size(); i--) {
-                    if (i < 0) {
-                        break;
-                    }
-                    if (rates.at(k).x() <= xorSamples.at(i).x()) {
-                        foundK = true;
-                    }
-                }
-                if (foundK && k < rates.size()) {
-                    // if there is an overlap, remove all points from input rate points that are already existing
-                    rates.remove(0, k + 1);
-                    break;
-                }
-            }
-        }
-
-        for (auto rate : rates) {
-            xorSamples.append(rate);
-        }
-        while (!xorSamples.isEmpty() && !rates.isEmpty()) {
-            if (xorSamples.first().x() < (rates.last().x() - rateSecondsBuffered)) {
-                xorSamples.pop_front();
-            } else {
-                break;
-            }
-        }
-        statusUi->ratePlot->plotXorSamples(xorSamples);
+        samples = &xorSamples;
+    } else if (whichrate == 1) {
+        samples = &andSamples;
+    } else {
+        return;
     }
-    if (whichrate == 1) {
-        if (andSamples.size() > 0) {
-            for (int k = rates.size() - 1; k >= 0; k--) {
-                bool foundK = false; // if foundK it has found an index k where the x values of the input points
-                // are smaller or equal to the x values of the already existing points -> overlap
-                for (int i = andSamples.size() - 1; i >= andSamples.size() - 1 - rates.size(); i--) {
-                    if (i < 0) {
-                        break;
-                    }
-                    if (rates.at(k).x() <= andSamples.at(i).x()) {
-                        foundK = true;
-                    }
-                }
-                if (foundK && k < rates.size()) {
-                    // if there is an overlap, remove all points from input rate points that are already existing
-                    rates.remove(0, k + 1);
-                    break;
-                }
-            }
-        }
-
-        for (auto rate : rates) {
-            andSamples.append(rate);
-        }
-
-        while (!andSamples.isEmpty() && !rates.isEmpty()) {
-            if (andSamples.first().x() < (rates.last().x() - rateSecondsBuffered)) {
-                andSamples.pop_front();
-            } else {
-                break;
-            }
+    // the received rate points overlap with the already existing ones, append only the new points
+    for (const auto& rate : rates) {
+        if (samples->isEmpty() || rate.x() > samples->last().x()) {
+            samples->append(rate);
         }
+    }
+    samples->removeBefore(rates.last().x() - rateSecondsBuffered);
+    if (whichrate == 0) {
+        statusUi->ratePlot->plotXorSamples(xorSamples);
+    } else {
         statusUi->ratePlot->plotAndSamples(andSamples);
     }
 }
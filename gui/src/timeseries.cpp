@@ -0,0 +1,217 @@
+#include "timeseries.h"
+
+#include <algorithm>
+#include <limits>
+
+void TimeSeries::extend(Bucket& bucket, const QPointF& point)
+{
+    if (point.y() < bucket.min.y()) {
+        bucket.min = point;
+    }
+    if (point.y() > bucket.max.y()) {
+        bucket.max = point;
+    }
+}
+
+void TimeSeries::append(const QPointF& point)
+{
+    const std::size_t index { m_front + m_points.size() };
+    m_points.push_back(point);
+    m_revision++;
+
+    std::size_t bucket_size { fan_out };
+    for (auto& level : m_levels) {
+        const std::size_t bucket { index / bucket_size };
+        if (level.buckets.empty() || level.front + level.buckets.size() <= bucket) {
+            level.buckets.push_back(Bucket { point, point });
+        } else {
+            extend(level.buckets.back(), point);
+        }
+        bucket_size *= fan_out;
+    }
+
+    // add a coarser level as soon as the coarsest one is worth reducing
+    const std::size_t top_count { m_levels.empty() ? m_points.size() : m_levels.back().buckets.size() };
+    if (top_count >= 2 * fan_out) {
+        addLevel();
+    }
+}
+
+void TimeSeries::addLevel()
+{
+    Level level {};
+    if (m_levels.empty()) {
+        level.front = m_front / fan_out;
+        for (std::size_t i = 0; i < m_points.size(); i++) {
+            const std::size_t bucket { (m_front + i) / fan_out };
+            if (level.buckets.empty() || level.front + level.buckets.size() <= bucket) {
+                level.buckets.push_back(Bucket { m_points[i], m_points[i] });
+            } else {
+                extend(level.buckets.back(), m_points[i]);
+            }
+        }
+    } else {
+        const Level& source { m_levels.back() };
+        level.front = source.front / fan_out;
+        for (std::size_t i = 0; i < source.buckets.size(); i++) {
+            const std::size_t bucket { (source.front + i) / fan_out };
+            if (level.buckets.empty() || level.front + level.buckets.size() <= bucket) {
+                level.buckets.push_back(source.buckets[i]);
+            } else {
+                extend(level.buckets.back(), source.buckets[i].min);
+                extend(level.buckets.back(), source.buckets[i].max);
+            }
+        }
+    }
+    m_levels.push_back(std::move(level));
+}
+
+void TimeSeries::clear()
+{
+    m_points.clear();
+    m_levels.clear();
+    m_front = 0;
+    m_revision++;
+}
+
+void TimeSeries::removeBefore(double x)
+{
+    while (!m_points.empty() && m_points.front().x() < x) {
+        m_points.pop_front();
+        m_front++;
+        m_revision++;
+    }
+    if (m_points.empty()) {
+        clear();
+        return;
+    }
+    // buckets which are only partially removed are kept, samples() never reads them
+    // since it takes the partially covered buckets at the range borders from the raw points
+    std::size_t bucket_size { fan_out };
+    for (auto& level : m_levels) {
+        while (!level.buckets.empty() && (level.front + 1) * bucket_size <= m_front) {
+            level.buckets.pop_front();
+            level.front++;
+        }
+        bucket_size *= fan_out;
+    }
+}
+
+void TimeSeries::appendExtrema(QVector<QPointF>& out, std::size_t first, std::size_t last) const
+{
+    if (first >= last) {
+        return;
+    }
+    Bucket bucket { m_points[first - m_front], m_points[first - m_front] };
+    for (std::size_t i = first + 1; i < last; i++) {
+        extend(bucket, m_points[i - m_front]);
+    }
+    const bool min_first { bucket.min.x() <= bucket.max.x() };
+    out.push_back(min_first ? bucket.min : bucket.max);
+    if (bucket.min != bucket.max) {
+        out.push_back(min_first ? bucket.max : bucket.min);
+    }
+}
+
+auto TimeSeries::samples(double x_min, double x_max, std::size_t max_points) const -> QVector<QPointF>
+{
+    QVector<QPointF> out {};
+    if (m_points.empty()) {
+        return out;
+    }
+    const auto by_x { [](const QPointF& point, double x) { return point.x() < x; } };
+    std::size_t i0 = std::lower_bound(m_points.begin(), m_points.end(), x_min, by_x) - m_points.begin();
+    std::size_t i1 = std::lower_bound(m_points.begin(), m_points.end(), x_max, by_x) - m_points.begin();
+    i0 = (i0 > 0) ? i0 - 1 : 0;
+    i1 = std::min(i1 + 1, m_points.size());
+    const std::size_t count { i1 - i0 };
+
+    if (count <= std::max<std::size_t>(max_points, 2)) {
+        out.reserve(static_cast<int>(count));
+        for (std::size_t i = i0; i < i1; i++) {
+            out.push_back(m_points[i]);
+        }
+        return out;
+    }
+
+    // the finest level which delivers at most max_points points (two per bucket)
+    std::size_t level_index { 0 };
+    std::size_t bucket_size { fan_out };
+    while (level_index + 1 < m_levels.size() && 2 * count / bucket_size > max_points) {
+        level_index++;
+        bucket_size *= fan_out;
+    }
+
+    const std::size_t first { m_front + i0 };
+    const std::size_t last { m_front + i1 };
+    out.reserve(static_cast<int>(2 * count / bucket_size + 6));
+    out.push_back(m_points[i0]);
+
+    if (m_levels.empty()) {
+        appendExtrema(out, first + 1, last - 1);
+        out.push_back(m_points[i1 - 1]);
+        return out;
+    }
+
+    const Level& level { m_levels[level_index] };
+    const std::size_t first_bucket { std::max((first + 1 + bucket_size - 1) / bucket_size, level.front) };
+    const std::size_t end_bucket { (last - 1) / bucket_size };
+    if (first_bucket >= end_bucket) {
+        appendExtrema(out, first + 1, last - 1);
+    } else {
+        appendExtrema(out, first + 1, first_bucket * bucket_size);
+        for (std::size_t b = first_bucket; b < end_bucket; b++) {
+            const Bucket& bucket { level.buckets[b - level.front] };
+            const bool min_first { bucket.min.x() <= bucket.max.x() };
+            out.push_back(min_first ? bucket.min : bucket.max);
+            if (bucket.min != bucket.max) {
+                out.push_back(min_first ? bucket.max : bucket.min);
+            }
+        }
+        appendExtrema(out, end_bucket * bucket_size, last - 1);
+    }
+    out.push_back(m_points[i1 - 1]);
+    return out;
+}
+
+auto TimeSeries::boundingRect() const -> QRectF
+{
+    if (m_points.empty()) {
+        return QRectF { 1.0, 1.0, -2.0, -2.0 }; // invalid
+    }
+    double y_min { m_points.front().y() };
+    double y_max { y_min };
+    const auto include { [&y_min, &y_max](double y) {
+        y_min = std::min(y_min, y);
+        y_max = std::max(y_max, y);
+    } };
+    if (m_levels.empty()) {
+        for (const auto& point : m_points) {
+            include(point.y());
+        }
+    } else {
+        // the coarsest level holds only a few buckets, the partially removed first bucket is taken from the raw points
+        const Level& level { m_levels.back() };
+        std::size_t bucket_size { fan_out };
+        for (std::size_t l = 1; l < m_levels.size(); l++) {
+            bucket_size *= fan_out;
+        }
+        std::size_t first_bucket { level.front };
+        if (level.front * bucket_size < m_front) {
+            first_bucket++;
+            for (std::size_t i = m_front; i < std::min(first_bucket * bucket_size, m_front + m_points.size()); i++) {
+                include(m_points[i - m_front].y());
+            }
+        }
+        for (std::size_t b = first_bucket; b < level.front + level.buckets.size(); b++) {
+            include(level.buckets[b - level.front].min.y());
+            include(level.buckets[b - level.front].max.y());
+        }
+    }
+    return QRectF { QPointF { m_points.front().x(), y_min }, QPointF { m_points.back().x(), y_max } };
+}
+
+auto TimeSeries::samples(std::size_t max_points) const -> QVector<QPointF>
+{
+    return samples(std::numeric_limits<double>::lowest(), std::numeric_limits<double>::max(), max_points);
+}
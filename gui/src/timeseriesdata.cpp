@@ -0,0 +1,62 @@
+#include "timeseriesdata.h"
+
+#include <limits>
+
+TimeSeriesData::TimeSeriesData(std::shared_ptr<const TimeSeries> series, std::size_t max_points)
+    : m_series { std::move(series) }
+    , m_max_points { max_points }
+{
+}
+
+void TimeSeriesData::setMaxPoints(std::size_t max_points)
+{
+    if (max_points != m_max_points) {
+        m_max_points = max_points;
+        m_valid = false;
+    }
+}
+
+void TimeSeriesData::setRectOfInterest(const QRectF& rect)
+{
+    if (rect != m_rect_of_interest) {
+        m_rect_of_interest = rect;
+        m_valid = false;
+    }
+}
+
+void TimeSeriesData::update() const
+{
+    if (m_valid && m_revision == m_series->revision()) {
+        return;
+    }
+    // only the x range is relevant, the y range of the rect may be degenerate
+    if (m_rect_of_interest.width() > 0.) {
+        m_samples = m_series->samples(m_rect_of_interest.left(), m_rect_of_interest.right(), m_max_points);
+    } else {
+        m_samples = m_series->samples(m_max_points);
+    }
+    m_revision = m_series->revision();
+    m_valid = true;
+}
+
+size_t TimeSeriesData::size() const
+{
+    if (!m_series) {
+        return 0;
+    }
+    update();
+    return static_cast<size_t>(m_samples.size());
+}
+
+QPointF TimeSeriesData::sample(size_t i) const
+{
+    return m_samples[static_cast<int>(i)];
+}
+
+QRectF TimeSeriesData::boundingRect() const
+{
+    if (!m_series) {
+        return QRectF { 1.0, 1.0, -2.0, -2.0 };
+    }
+    return m_series->boundingRect();
+}
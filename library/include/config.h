@@ -3,6 +3,7 @@
 
 #include "version.h"
 
+#include <array>
 #include <chrono>
 #include <cstdint>
 #include <string>
@@ -27,12 +28,11 @@ namespace MuonPi::Config {
 constexpr const char* file { "/etc/muondetector/muondetector.conf" };
 constexpr const char* data_path { "/var/muondetector/" };
 constexpr const char* persistant_settings_file { "settings.conf" };
-constexpr int event_count_deadtime_ticks { 1000 };
-constexpr int event_count_max_pileups { 50 };
 constexpr double max_lock_in_dop { 3. };
 constexpr double lock_in_target_precision_meters { 7. };
-constexpr std::size_t lock_in_min_histogram_entries { 1500 };
-constexpr std::size_t lock_in_max_histogram_entries { 8000 };
+constexpr std::size_t lock_in_min_entries { 1500 }; //!< effective number of position samples required for the lock-in
+constexpr std::size_t lock_in_window_entries { 8000 }; //!< older position samples are forgotten exponentially beyond this window
+constexpr double lock_in_max_drift_meters { 1. }; //!< max drift of the position estimate over lock_in_min_entries samples for the lock-in
 
 namespace MQTT {
     constexpr const char* host { "muonpi.sscc.uos.ac.kr" };
@@ -49,12 +49,45 @@ namespace Log {
     constexpr int max_geohash_length_default { 6 };
     constexpr std::chrono::hours rotate_period_default { 7 * 24 };
 }
+namespace EventFilter {
+    constexpr std::chrono::microseconds burst_interval { 1000 }; //!< edges closer than this are counted as pileup
+    constexpr unsigned int burst_threshold { 50 }; //!< number of pileups after which a channel is muted
+    constexpr std::chrono::microseconds min_deadtime { 0 };
+    constexpr std::chrono::microseconds max_deadtime { 10000 };
+    constexpr std::chrono::microseconds deadtime_step { 50 };
+    constexpr double rate_high { 100. }; //!< in Hz
+    constexpr double rate_low { 50. }; //!< in Hz
+}
+namespace Latency {
+    constexpr std::chrono::milliseconds collect_interval { 1000 };
+}
+namespace Startup {
+    constexpr std::chrono::milliseconds pigpiod_timeout { 5000 };
+    constexpr std::chrono::milliseconds gnss_timeout { 15000 }; //!< until the first reply of the gnss module
+}
 namespace Hardware {
     namespace GNSS {
         constexpr size_t uart_timeout { 5000 };
+        constexpr std::size_t send_window { 4 }; //!< ubx messages which may await their ACK/NAK at the same time
+        constexpr double valset_min_protocol { 27.0 }; //!< first protocol version with the key-value configuration interface
+        constexpr int version_timeout { 3000 }; //!< ms to wait for the receiver version before configuring it the legacy way
+        constexpr std::array<int, 6> baud_rates { 9600, 19200, 38400, 57600, 115200, 230400 }; //!< candidates of the baud rate detection, ascending
+        constexpr int baud_probe_timeout { 300 }; //!< ms to wait for the first valid ubx message at a probed baud rate
+        constexpr int baud_probe_response_timeout { 1500 }; //!< ms to wait for the port configuration once the baud rate matched
+        constexpr int baud_switch_settle { 100 }; //!< ms the receiver needs to apply a new baud rate
+        constexpr int reset_settle { 1000 }; //!< ms after a receiver reset until its baud rate is detected again
+        constexpr std::chrono::milliseconds utilization_interval { 10000 };
+        constexpr std::chrono::milliseconds link_timeout { 3000 }; //!< without a valid ubx message for this long the link is probed, if the poll stays unanswered as well the baud rate is detected again
+        namespace RateScheduler {
+            constexpr double tx_usage_high { 50. }; //!< in %, above this the status messages are throttled further
+            constexpr double tx_usage_low { 10. }; //!< in %, below this the throttling is relaxed
+            constexpr double uart_load_max { 0.5 }; //!< fraction of the uart capacity the periodic messages may use
+            constexpr unsigned int max_throttle { 8 };
+        }
     }
     namespace OLED {
         constexpr int update_interval { 2000 };
+        constexpr std::size_t transfer_chunk_size { 0 }; //!< data bytes per i2c transaction, 0 transfers each changed page segment at once
     }
     namespace ADC {
         namespace Channel {
@@ -0,0 +1,44 @@
+#ifndef EVENTFORMATTER_H
+#define EVENTFORMATTER_H
+
+#include "muondetector_shared_global.h"
+
+#include <array>
+#include <cstdint>
+#include <ctime>
+#include <string_view>
+
+struct UbxTimeMarkStruct;
+
+/**
+ * @brief Compact record of a detected event (time mark), passed by value to the event sinks
+ */
+struct EventRecord {
+    timespec rising { 0, 0 };
+    timespec falling { 0, 0 };
+    std::uint32_t accuracy_ns { 0 };
+    std::uint16_t counter { 0 };
+    std::uint8_t valid { 0 };
+    std::uint8_t time_base { 0 };
+    std::uint8_t utc_available { 0 };
+
+    [[nodiscard]] static auto fromTimeMark(const UbxTimeMarkStruct& tm) -> EventRecord;
+};
+
+/**
+ * @brief Allocation free text encoding of an EventRecord
+ * The format is the one of the event data files and the mqtt data topic:
+ * "rising_s.rising_ns falling_s.falling_ns accuracy_ns counter valid timebase utc"
+ * Every sink owns its formatter, the returned string_view is valid until the next call to format().
+ */
+class MUONDETECTORSHARED EventFormatter {
+public:
+    static constexpr std::size_t max_length { 128 };
+
+    [[nodiscard]] auto format(const EventRecord& record) -> std::string_view;
+
+private:
+    std::array<char, max_length> m_buffer {};
+};
+
+#endif // EVENTFORMATTER_H
@@ -3,11 +3,13 @@
 
 #include "muondetector_shared_global.h"
 #include "config.h"
+#include "eventformatter.h"
 
 #include <QObject>
 #include <QTimer>
 #include <QPointer>
 #include <string>
+#include <string_view>
 #include <mosquitto.h>
 
 namespace MuonPi
@@ -45,6 +47,7 @@ namespace MuonPi
         void subscribe(const QString &topic);
         void unsubscribe(const QString &topic);
         void publish(const QString &topic, const QString &content);
+        void publish(const QString &topic, const EventRecord &record);
         void requestConnectionStatus();
         void setInhibited(bool inhibited = true);
 
@@ -55,7 +58,8 @@ namespace MuonPi
 
     private:
         [[nodiscard]] auto connected() -> bool;
-        [[nodiscard]] auto publish(const std::string &topic, const std::string &content) -> bool;
+        [[nodiscard]] auto publish(const std::string &topic, std::string_view content) -> bool;
+        void report_publish_result(bool success, const QString &topic);
 
         void initialise(const std::string &client_id);
 
@@ -98,6 +102,10 @@ namespace MuonPi
 
         int m_verbose{0};
 
+        EventFormatter m_event_formatter{};
+        QString m_event_topic{};
+        std::string m_event_usertopic{};
+
         std::size_t m_publish_error_count{0};
         static constexpr std::size_t s_max_publish_errors{3};
 
@@ -4,10 +4,12 @@
 #include "muondetector_shared_global.h"
 #include "tcpmessage.h"
 
+#include <QElapsedTimer>
 #include <QFile>
 #include <QPointer>
 #include <QTcpSocket>
 #include <QTimer>
+#include <deque>
 #include <time.h>
 #include <vector>
 
@@ -27,6 +29,12 @@ public:
     uint32_t getNrBytesRead() const { return bytesRead; }
     uint32_t getNrBytesWritten() const { return bytesWritten; }
     time_t firstConnectionTime() const { return firstConnection; }
+    qint64 queuedBytes() const; //!< bytes not yet handed to the network, including the socket buffer
+    /**
+     * @brief read the next complete frame (size prefix, message id and payload) from device
+     * @return false if no complete frame is available yet
+     */
+    static bool readFrame(QIODevice* device, QByteArray& frame);
 
 signals:
     void madeConnection(QString remotePeerAddress, quint16 remotePeerPort, QString localAddress, quint16 localPort);
@@ -37,6 +45,11 @@ signals:
     void connected();
     void receivedTcpMessage(TcpMessage tcpMessage);
     void finished();
+    /**
+     * @brief statistics of the send path, emitted every c_statisticsInterval
+     * @param latencyMean_ms, latencyMax_ms time from sendTcpMessage until the message was written to the network
+     */
+    void sendStatistics(quint32 queuedBytes, quint32 droppedMessages, double latencyMean_ms, double latencyMax_ms);
 
 public slots:
     void makeConnection();
@@ -46,15 +59,31 @@ public slots:
     void onReadyRead();
     bool sendTcpMessage(TcpMessage tcpMessage);
 
+private slots:
+    void flush();
+    void onBytesWritten(qint64 bytes);
+    void onWriteTimeout();
+    void emitSendStatistics();
+
 private:
-    bool writeBlock(const QByteArray& block);
+    enum class SendClass {
+        Control, //!< never dropped
+        Status, //!< dropped only if the queue exceeds c_hardLimit
+        Stream //!< high rate data, dropped above c_highWaterMark
+    };
+    static SendClass sendClass(quint16 msgID);
+    static constexpr qint64 c_highWaterMark { 256 * 1024 };
+    static constexpr qint64 c_hardLimit { 4 * c_highWaterMark };
+    static constexpr qint64 c_socketChunk { 64 * 1024 }; //!< max bytes handed to the socket before waiting for bytesWritten
+    static constexpr int c_statisticsInterval { 10000 };
+
+    bool writeBlock(const QByteArray& block, SendClass sendClass);
+    void setupSendPath();
     int timeout;
     int verbose;
     int pingInterval;
     int m_socketDescriptor;
-    quint16 blockSize = 0;
     QString peerAddress, localAddress;
-    QDataStream* in = nullptr;
     QTcpSocket* tcpSocket = nullptr;
     QString hostName;
     quint16 port;
@@ -64,5 +93,19 @@ private:
     time_t lastConnection;
     time_t firstConnection;
     uint32_t bytesRead = 0, bytesWritten = 0;
+
+    // non-blocking send path: messages are collected in m_outBuffer and handed to the socket once per event loop turn
+    QByteArray m_outBuffer {};
+    bool m_flushScheduled { false };
+    QTimer m_writeTimer { this }; //!< fires if the socket made no progress within timeout
+    QTimer m_statisticsTimer { this };
+    QElapsedTimer m_clock {};
+    qint64 m_bytesEnqueued { 0 }; //!< total bytes accepted by sendTcpMessage
+    qint64 m_bytesSent { 0 }; //!< total bytes reported by bytesWritten
+    std::deque<std::pair<qint64, qint64>> m_pendingMessages {}; //!< end offset and enqueue time in ns of every message not yet written
+    quint32 m_droppedMessages { 0 };
+    double m_latencySum_ms { 0. };
+    double m_latencyMax_ms { 0. };
+    quint32 m_latencyCount { 0 };
 };
 #endif // TCPCONNECTION_H
@@ -6,6 +6,8 @@
 #include <QByteArray>
 #include <QDataStream>
 
+#include <memory>
+
 enum class TCP_MSG_KEY : quint16;
 
 // how is a message coded in TcpMessage?
@@ -15,10 +17,37 @@ enum class TCP_MSG_KEY : quint16;
 
 class MUONDETECTORSHARED TcpMessage {
 public:
+    /**
+     * @brief QDataStream on the payload, created on first use
+     * Copies of a message share the payload until one of them writes to it, each copy reads on its own
+     * starting right after the header.
+     */
+    class MUONDETECTORSHARED Stream {
+    public:
+        Stream(const Stream&) = delete;
+        Stream& operator=(const Stream&) = delete;
+        ~Stream();
+
+        QDataStream& operator*() const { return *get(); }
+        QDataStream* operator->() const { return get(); }
+
+    private:
+        friend class TcpMessage;
+        explicit Stream(QByteArray* data);
+        QDataStream* get() const;
+        void reset();
+
+        QByteArray* m_data { nullptr };
+        mutable std::unique_ptr<QDataStream> m_stream {};
+    };
+
+    static constexpr int headerSize { 2 * sizeof(quint16) };
+
     TcpMessage(quint16 tcpMsgID = 0);
     TcpMessage(TCP_MSG_KEY tcpMsgID);
-    TcpMessage(QByteArray& rawdata);
+    TcpMessage(const QByteArray& rawdata); //!< takes over a received frame including the header, without copying the payload
     TcpMessage(const TcpMessage& tcpMessage);
+    TcpMessage& operator=(const TcpMessage& tcpMessage);
     ~TcpMessage();
 
     void setMsgID(quint16 tcpMsgID);
@@ -27,10 +56,13 @@ public:
     quint16 getMsgID() const;
     quint16 getByteCount() const;
 
-    QDataStream* dStream = nullptr;
+private:
+    QByteArray m_data {}; //!< declared before dStream, which works on it
+
+public:
+    Stream dStream { &m_data };
 
 private:
-    QByteArray m_data {};
     quint16 m_msgID {};
     quint16 m_byteCount {};
 };
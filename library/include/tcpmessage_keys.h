@@ -82,7 +82,8 @@ enum class TCP_MSG_KEY : quint16 { MSG_PING = 2,
     MSG_DAC_SET = 383,
     MSG_POSITION_MODEL = 389,
     MSG_RESERVED2 = 397,
-    MSG_RESERVED3 = 401
+    MSG_RESERVED3 = 401,
+    MSG_LATENCY_STATS = 409
 };
 
 #endif // TCPMESSAGE_KEYS_H
@@ -0,0 +1,74 @@
+#ifndef TCPMESSAGEDISPATCHER_H
+#define TCPMESSAGEDISPATCHER_H
+
+#include "muondetector_shared_global.h"
+#include "tcpmessage.h"
+#include "tcpmessage_keys.h"
+
+#include <array>
+#include <chrono>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Dispatch of received TcpMessages to handlers registered per message key
+ * The handlers are stored in an array indexed by the key, so the lookup costs the same for every message.
+ * Typed handlers get the payload decoded into the given types, in the order they were streamed by the sender.
+ * The number of messages and the time spent in the handler are accounted for every key.
+ */
+class MUONDETECTORSHARED TcpMessageDispatcher {
+public:
+    using Handler = std::function<void(TcpMessage&)>;
+
+    struct Statistics {
+        TCP_MSG_KEY key {};
+        quint64 count { 0 };
+        std::chrono::nanoseconds mean {};
+        std::chrono::nanoseconds max {};
+    };
+
+    static constexpr std::size_t max_key { 512 };
+
+    /**
+     * @brief register a handler which decodes the message on its own
+     */
+    void handle(TCP_MSG_KEY key, Handler handler);
+
+    /**
+     * @brief register a handler which is called with the payload decoded as Payload...
+     * e.g. on<quint8, float>(TCP_MSG_KEY::MSG_THRESHOLD, [](quint8 channel, float threshold) { ... })
+     */
+    template <typename... Payload, typename F>
+    void on(TCP_MSG_KEY key, F handler)
+    {
+        handle(key, [handler = std::move(handler)](TcpMessage& message) mutable {
+            std::tuple<std::decay_t<Payload>...> payload {};
+            std::apply([&message](auto&... values) { (void)message; ((*message.dStream >> values), ...); }, payload);
+            std::apply(handler, std::move(payload));
+        });
+    }
+
+    /**
+     * @return false if no handler is registered for the key of the message
+     */
+    bool dispatch(TcpMessage& message);
+
+    [[nodiscard]] auto statistics() const -> std::vector<Statistics>; //!< only the keys which were received at least once
+    [[nodiscard]] auto unknownCount() const -> quint64 { return m_unknown; }
+    void resetStatistics();
+
+private:
+    struct Entry {
+        Handler handler {};
+        quint64 count { 0 };
+        std::chrono::nanoseconds total {};
+        std::chrono::nanoseconds max {};
+    };
+
+    std::array<Entry, max_key> m_entries {};
+    quint64 m_unknown { 0 };
+};
+
+#endif // TCPMESSAGEDISPATCHER_H
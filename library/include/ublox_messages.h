@@ -70,6 +70,9 @@ enum msg_id : std::uint16_t {
     CFG_TP5 = 0x0631,
     CFG_TXSLOT = 0x0653, // not supportet on U-Blox 7 (only with time & frequency sync products)
     CFG_USB = 0x061b,
+    CFG_VALSET = 0x068a, // only protocol version 27 and newer
+    CFG_VALGET = 0x068b, // only protocol version 27 and newer
+    CFG_VALDEL = 0x068c, // only protocol version 27 and newer
 
     TIM_TP = 0x0d01,
     TIM_TM2 = 0x0d03,
@@ -162,6 +165,9 @@ const static std::map<msg_id, std::string> msg_string {
     { CFG_SBAS, "CFG-SBAS" },
     { CFG_TP5, "CFG-TP5" },
     { CFG_USB, "CFG-USB" },
+    { CFG_VALSET, "CFG-VALSET" },
+    { CFG_VALGET, "CFG-VALGET" },
+    { CFG_VALDEL, "CFG-VALDEL" },
     // TIM
     { TIM_TP, "TIM-TP" },
     { TIM_TM2, "TIM-TM2" },
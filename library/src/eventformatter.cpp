@@ -0,0 +1,64 @@
+#include "eventformatter.h"
+#include "ublox_structs.h"
+
+#include <charconv>
+
+namespace {
+auto appendTimespec(char* first, char* last, timespec ts) -> char*
+{
+    if (ts.tv_nsec < 0 || ts.tv_nsec >= 1000000000L) {
+        ts.tv_sec += ts.tv_nsec / 1000000000L;
+        ts.tv_nsec %= 1000000000L;
+        if (ts.tv_nsec < 0) {
+            ts.tv_sec--;
+            ts.tv_nsec += 1000000000L;
+        }
+    }
+    first = std::to_chars(first, last, static_cast<std::int64_t>(ts.tv_sec)).ptr;
+    *first++ = '.';
+    // nanoseconds are zero padded to 9 digits
+    char digits[9];
+    const auto result { std::to_chars(digits, digits + sizeof(digits), static_cast<std::uint32_t>(ts.tv_nsec)) };
+    const auto n_digits { result.ptr - digits };
+    for (auto i = n_digits; i < 9; i++) {
+        *first++ = '0';
+    }
+    for (auto i = 0; i < n_digits; i++) {
+        *first++ = digits[i];
+    }
+    *first++ = ' ';
+    return first;
+}
+}
+
+auto EventRecord::fromTimeMark(const UbxTimeMarkStruct& tm) -> EventRecord
+{
+    EventRecord record {};
+    record.rising = tm.rising;
+    record.falling = tm.falling;
+    record.accuracy_ns = tm.accuracy_ns;
+    record.counter = tm.evtCounter;
+    record.valid = static_cast<std::uint8_t>(tm.valid);
+    record.time_base = tm.timeBase;
+    record.utc_available = static_cast<std::uint8_t>(tm.utcAvailable);
+    return record;
+}
+
+auto EventFormatter::format(const EventRecord& record) -> std::string_view
+{
+    char* const first { m_buffer.data() };
+    char* const last { m_buffer.data() + m_buffer.size() };
+    char* p { first };
+    p = appendTimespec(p, last, record.rising);
+    p = appendTimespec(p, last, record.falling);
+    p = std::to_chars(p, last, record.accuracy_ns).ptr;
+    *p++ = ' ';
+    p = std::to_chars(p, last, record.counter).ptr;
+    *p++ = ' ';
+    p = std::to_chars(p, last, record.valid).ptr;
+    *p++ = ' ';
+    p = std::to_chars(p, last, record.time_base).ptr;
+    *p++ = ' ';
+    p = std::to_chars(p, last, record.utc_available).ptr;
+    return std::string_view { first, static_cast<std::size_t>(p - first) };
+}
@@ -146,6 +146,7 @@ namespace MuonPi
     {
         m_username = username.toStdString();
         m_password = password.toStdString();
+        m_event_topic.clear();
 
         CryptoPP::SHA1 sha1;
         std::string source = username.toStdString() + m_station_id; // This will be randomly generated somehow
@@ -334,7 +335,27 @@ namespace MuonPi
         }
         std::string usertopic{topic.toStdString()};
         usertopic += m_username + "/" + m_station_id;
-        if (!publish(usertopic, content.toStdString()))
+        report_publish_result(publish(usertopic, content.toStdString()), topic);
+    }
+
+    void MqttHandler::publish(const QString &topic, const EventRecord &record)
+    {
+        if (!connected())
+        {
+            return;
+        }
+        // the user topic is only rebuilt when the topic changes
+        if (topic != m_event_topic)
+        {
+            m_event_topic = topic;
+            m_event_usertopic = topic.toStdString() + m_username + "/" + m_station_id;
+        }
+        report_publish_result(publish(m_event_usertopic, m_event_formatter.format(record)), topic);
+    }
+
+    void MqttHandler::report_publish_result(bool success, const QString &topic)
+    {
+        if (!success)
         {
             m_publish_error_count++;
             if (m_publish_error_count < s_max_publish_errors)
@@ -350,13 +371,13 @@ namespace MuonPi
         m_publish_error_count = 0;
     }
 
-    auto MqttHandler::publish(const std::string &topic, const std::string &content) -> bool
+    auto MqttHandler::publish(const std::string &topic, std::string_view content) -> bool
     {
         if (!connected())
         {
             return false;
         }
-        auto result{mosquitto_publish(m_mqtt, nullptr, topic.c_str(), static_cast<int>(content.size()), reinterpret_cast<const void *>(content.c_str()), 1, false)};
+        auto result{mosquitto_publish(m_mqtt, nullptr, topic.c_str(), static_cast<int>(content.size()), reinterpret_cast<const void *>(content.data()), 1, false)};
 
         if (result == MOSQ_ERR_SUCCESS)
         {
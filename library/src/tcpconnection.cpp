@@ -3,7 +3,9 @@
 
 #include <QDataStream>
 #include <QThread>
+#include <QtEndian>
 #include <QtNetwork>
+#include <algorithm>
 #include <iostream>
 #if defined(Q_OS_UNIX)
 #include <sys/syscall.h>
@@ -32,10 +34,6 @@ TcpConnection::TcpConnection(int socketDescriptor, int newVerbose, int newTimeou
 
 TcpConnection::~TcpConnection()
 {
-    if (in != nullptr) {
-        delete in;
-        in = nullptr;
-    }
     if (!t.isNull()) {
         t.clear();
     }
@@ -51,9 +49,6 @@ void TcpConnection::makeConnection()
     }
 #endif
     tcpSocket = new QTcpSocket(this);
-    in = new QDataStream();
-    in->setVersion(QDataStream::Qt_4_0);
-    in->setDevice(tcpSocket);
     connect(tcpSocket, &QTcpSocket::readyRead, this, &TcpConnection::onReadyRead);
     tcpSocket->connectToHost(hostName, port);
     firstConnection = time(NULL);
@@ -63,6 +58,7 @@ void TcpConnection::makeConnection()
         this->thread()->quit();
         return;
     }
+    setupSendPath();
     emit connected();
     peerAddress = tcpSocket->peerAddress().toString();
     emit toConsole(QString("makeConnection: peer1 ") + peerAddress);
@@ -105,10 +101,8 @@ void TcpConnection::receiveConnection()
     peerPort = tcpSocket->peerPort();
     localPort = tcpSocket->localPort();
     lastConnection = time(NULL);
-    in = new QDataStream();
-    in->setVersion(QDataStream::Qt_4_0);
-    in->setDevice(tcpSocket);
     connect(tcpSocket, &QTcpSocket::readyRead, this, &TcpConnection::onReadyRead);
+    setupSendPath();
     firstConnection = time(NULL);
     lastConnection = firstConnection;
     emit madeConnection(peerAddress, peerPort, localAddress, localPort);
@@ -129,6 +123,18 @@ void TcpConnection::closeThisConnection()
     TcpMessage quitMessage(TCP_MSG_KEY::MSG_QUIT_CONNECTION);
     *(quitMessage.dStream) << localAddress;
     sendTcpMessage(quitMessage);
+    // the thread quits after finished, so the queue has to be written out right now,
+    // one chunk after the other until everything is sent or the timeout expired
+    QElapsedTimer elapsed {};
+    elapsed.start();
+    while (tcpSocket && tcpSocket->state() == QTcpSocket::ConnectedState
+        && (!m_outBuffer.isEmpty() || tcpSocket->bytesToWrite() > 0)) {
+        flush();
+        const qint64 remaining { timeout - elapsed.elapsed() };
+        if (remaining <= 0 || !tcpSocket->waitForBytesWritten(static_cast<int>(remaining))) {
+            break;
+        }
+    }
     emit finished();
     return;
 }
@@ -136,82 +142,180 @@ void TcpConnection::closeThisConnection()
 void TcpConnection::onReadyRead()
 {
     // this function gets called when tcpSocket emits readyRead signal
-    if (!in) {
-        emit toConsole("input stream not yet initialized\n");
+    if (!tcpSocket) {
         return;
     }
-    while (tcpSocket->bytesAvailable() != 0) {
-        if (blockSize == 0) {
-            if (tcpSocket->bytesAvailable() < (int)(sizeof(quint16))) {
-                return;
-            }
-            *in >> blockSize;
-        }
-        if (tcpSocket->bytesAvailable() < blockSize) {
-            return;
-        }
-        QByteArray block;
-        char* data;
-        data = (char*)malloc(blockSize);
-        if (data == NULL) {
-            qDebug() << "critical error: memory allocation of " << blockSize << " bytes failed. Memory full?";
-            exit(1);
-        }
-        in->readRawData(data, blockSize);
-        QDataStream str(&block, QIODevice::ReadWrite);
-        str << blockSize;
-        str.writeRawData(data, blockSize);
-        bytesRead += blockSize;
-        blockSize = 0;
+    QByteArray block;
+    while (readFrame(tcpSocket, block)) {
+        bytesRead += block.size() - static_cast<int>(sizeof(quint16));
         if (verbose > 4) {
             qDebug() << block;
         }
+        emit receivedTcpMessage(TcpMessage { block });
+    }
+}
 
-        TcpMessage tcpMessage(block);
-        emit receivedTcpMessage(tcpMessage);
+bool TcpConnection::readFrame(QIODevice* device, QByteArray& frame)
+{
+    // the frame is read from the device buffer straight into the payload, which is then shared by all copies of the TcpMessage
+    char sizePrefix[sizeof(quint16)];
+    if (device->peek(sizePrefix, sizeof(sizePrefix)) < static_cast<qint64>(sizeof(sizePrefix))) {
+        return false;
+    }
+    const int frameSize { static_cast<int>(sizeof(quint16)) + qFromBigEndian<quint16>(sizePrefix) };
+    if (device->bytesAvailable() < frameSize) {
+        return false;
     }
+    frame = QByteArray(frameSize, Qt::Uninitialized);
+    device->read(frame.data(), frameSize);
+    return true;
 }
 
 bool TcpConnection::sendTcpMessage(TcpMessage tcpMessage)
 {
-    QByteArray block;
-    block = tcpMessage.getData();
-    QDataStream stream(&block, QIODevice::ReadWrite);
-    stream.device()->seek(0);
-    stream << (quint16)(block.size() - (int)sizeof(quint16)); // size of payload
+    QByteArray block { tcpMessage.getData() };
+    qToBigEndian<quint16>(static_cast<quint16>(block.size() - (int)sizeof(quint16)), block.data()); // size of payload
     if (verbose > 4) {
         qDebug() << block;
     }
-    return writeBlock(block);
+    return writeBlock(block, sendClass(tcpMessage.getMsgID()));
 }
 
-bool TcpConnection::writeBlock(const QByteArray& block)
+TcpConnection::SendClass TcpConnection::sendClass(quint16 msgID)
+{
+    switch (static_cast<TCP_MSG_KEY>(msgID)) {
+    case TCP_MSG_KEY::MSG_PING:
+    case TCP_MSG_KEY::MSG_QUIT_CONNECTION:
+    case TCP_MSG_KEY::MSG_TIMEOUT:
+    case TCP_MSG_KEY::MSG_VERSION:
+        return SendClass::Control;
+    case TCP_MSG_KEY::MSG_GPIO_EVENT:
+    case TCP_MSG_KEY::MSG_UBX_TIMEMARK:
+    case TCP_MSG_KEY::MSG_ADC_SAMPLE:
+    case TCP_MSG_KEY::MSG_ADC_TRACE:
+    case TCP_MSG_KEY::MSG_HISTOGRAM:
+    case TCP_MSG_KEY::MSG_GNSS_SATS:
+    case TCP_MSG_KEY::MSG_UBX_TXBUF:
+    case TCP_MSG_KEY::MSG_UBX_RXBUF:
+    case TCP_MSG_KEY::MSG_UBX_MONHW:
+    case TCP_MSG_KEY::MSG_UBX_MONHW2:
+    case TCP_MSG_KEY::MSG_UBX_EVENTCOUNTER:
+    case TCP_MSG_KEY::MSG_GPIO_RATE:
+        return SendClass::Stream;
+    default:
+        return SendClass::Status;
+    }
+}
+
+void TcpConnection::setupSendPath()
+{
+    connect(tcpSocket, &QTcpSocket::bytesWritten, this, &TcpConnection::onBytesWritten);
+    connect(tcpSocket, &QTcpSocket::connected, this, &TcpConnection::flush);
+    m_writeTimer.setSingleShot(true);
+    m_writeTimer.setInterval(timeout);
+    connect(&m_writeTimer, &QTimer::timeout, this, &TcpConnection::onWriteTimeout);
+    m_statisticsTimer.setInterval(c_statisticsInterval);
+    connect(&m_statisticsTimer, &QTimer::timeout, this, &TcpConnection::emitSendStatistics);
+    m_statisticsTimer.start();
+    m_clock.start();
+}
+
+qint64 TcpConnection::queuedBytes() const
+{
+    return m_outBuffer.size() + ((tcpSocket) ? tcpSocket->bytesToWrite() : 0);
+}
+
+bool TcpConnection::writeBlock(const QByteArray& block, SendClass sendClass)
 {
     if (!tcpSocket) {
         emit toConsole("in client => tcpConnection:\ntcpSocket not instantiated\n");
         return false;
     }
-    tcpSocket->write(block);
+    const qint64 queued { queuedBytes() };
+    if ((sendClass == SendClass::Stream && queued > c_highWaterMark)
+        || (sendClass == SendClass::Status && queued > c_hardLimit)) {
+        m_droppedMessages++;
+        return false;
+    }
+    m_outBuffer.append(block);
+    m_bytesEnqueued += block.size();
+    m_pendingMessages.emplace_back(m_bytesEnqueued, m_clock.nsecsElapsed());
     bytesWritten += block.size();
-    for (int i = 0; i < 3; i++) {
-        if (tcpSocket->state() != QTcpSocket::UnconnectedState) {
-            if (!tcpSocket->waitForBytesWritten(timeout)) {
-                quint32 connectionDuration = (quint32)(time(NULL) - firstConnection);
-                quint32 timeoutTime = (quint32)time(NULL);
-                emit connectionTimeout(peerAddress, peerPort, localAddress, localPort, timeoutTime, connectionDuration);
-                this->deleteLater();
-                return false;
-            }
-            return true;
-        } else {
-            delay(100);
+    // messages arriving within the same event loop turn go out in a single write
+    if (!m_flushScheduled) {
+        m_flushScheduled = true;
+        QTimer::singleShot(0, this, &TcpConnection::flush);
+    }
+    return true;
+}
+
+void TcpConnection::flush()
+{
+    m_flushScheduled = false;
+    if (!tcpSocket || m_outBuffer.isEmpty()) {
+        return;
+    }
+    if (tcpSocket->state() == QTcpSocket::UnconnectedState) {
+        if (verbose > 1) {
+            emit toConsole("tcp unconnected state before write, closing connection\n");
         }
+        this->thread()->quit();
+        return;
+    }
+    if (tcpSocket->state() != QTcpSocket::ConnectedState || tcpSocket->bytesToWrite() >= c_socketChunk) {
+        // continued on connected or bytesWritten
+        return;
+    }
+    // the socket buffer is topped up to one chunk, the rest follows on bytesWritten
+    const qint64 chunk { std::min<qint64>(m_outBuffer.size(), c_socketChunk - tcpSocket->bytesToWrite()) };
+    const qint64 written { tcpSocket->write(m_outBuffer.constData(), chunk) };
+    if (written < 0) {
+        emit error(tcpSocket->error(), tcpSocket->errorString());
+        return;
+    }
+    m_outBuffer.remove(0, static_cast<int>(written));
+    if (!m_writeTimer.isActive()) {
+        m_writeTimer.start();
+    }
+}
+
+void TcpConnection::onBytesWritten(qint64 bytes)
+{
+    m_bytesSent += bytes;
+    const qint64 now { m_clock.nsecsElapsed() };
+    while (!m_pendingMessages.empty() && m_pendingMessages.front().first <= m_bytesSent) {
+        const double latency_ms { 1e-6 * (now - m_pendingMessages.front().second) };
+        m_latencySum_ms += latency_ms;
+        m_latencyMax_ms = std::max(m_latencyMax_ms, latency_ms);
+        m_latencyCount++;
+        m_pendingMessages.pop_front();
+    }
+    if (tcpSocket->bytesToWrite() > 0) {
+        m_writeTimer.start();
+    } else {
+        m_writeTimer.stop();
     }
-    if (verbose > 1) {
-        emit toConsole("tcp unconnected state before wait for bytes written, closing connection\n");
+    if (!m_outBuffer.isEmpty()) {
+        flush();
     }
-    this->thread()->quit();
-    return false;
+}
+
+void TcpConnection::onWriteTimeout()
+{
+    quint32 connectionDuration = (quint32)(time(NULL) - firstConnection);
+    quint32 timeoutTime = (quint32)time(NULL);
+    emit connectionTimeout(peerAddress, peerPort, localAddress, localPort, timeoutTime, connectionDuration);
+    this->deleteLater();
+}
+
+void TcpConnection::emitSendStatistics()
+{
+    const double mean_ms { (m_latencyCount > 0) ? m_latencySum_ms / m_latencyCount : 0. };
+    emit sendStatistics(static_cast<quint32>(queuedBytes()), m_droppedMessages, mean_ms, m_latencyMax_ms);
+    m_droppedMessages = 0;
+    m_latencySum_ms = 0.;
+    m_latencyMax_ms = 0.;
+    m_latencyCount = 0;
 }
 
 void TcpConnection::delay(int millisecondsWait)
@@ -2,22 +2,47 @@
 #include "muondetector_structs.h"
 
 #include <QDebug>
+#include <QtEndian>
+
+TcpMessage::Stream::Stream(QByteArray* data)
+    : m_data { data }
+{
+}
+
+TcpMessage::Stream::~Stream() = default;
+
+QDataStream* TcpMessage::Stream::get() const
+{
+    if (!m_stream) {
+        m_stream = std::make_unique<QDataStream>(m_data, QIODevice::ReadWrite);
+        m_stream->device()->seek(headerSize);
+    }
+    return m_stream.get();
+}
+
+void TcpMessage::Stream::reset()
+{
+    m_stream.reset();
+}
 
 TcpMessage::TcpMessage(quint16 tcpMsgID)
 {
     m_msgID = tcpMsgID;
-    dStream = new QDataStream(&m_data, QIODevice::ReadWrite);
     m_byteCount = 0;
-    *dStream << static_cast<quint16>(0);
-    *dStream << tcpMsgID;
+    // the size is filled in by the connection on sending
+    m_data.resize(headerSize);
+    qToBigEndian<quint16>(0, m_data.data());
+    qToBigEndian<quint16>(tcpMsgID, m_data.data() + sizeof(quint16));
 }
 
-TcpMessage::TcpMessage(QByteArray& rawdata)
+TcpMessage::TcpMessage(const QByteArray& rawdata)
     : m_data { rawdata }
 {
-    dStream = new QDataStream(&m_data, QIODevice::ReadWrite);
-    *dStream >> m_byteCount;
-    *dStream >> m_msgID;
+    if (m_data.size() < headerSize) {
+        return;
+    }
+    m_byteCount = qFromBigEndian<quint16>(m_data.constData());
+    m_msgID = qFromBigEndian<quint16>(m_data.constData() + sizeof(quint16));
 }
 
 TcpMessage::TcpMessage(TCP_MSG_KEY tcpMsgID)
@@ -25,25 +50,29 @@ TcpMessage::TcpMessage(TCP_MSG_KEY tcpMsgID)
 {
 }
 
-TcpMessage::~TcpMessage()
+TcpMessage::~TcpMessage() = default;
+
+TcpMessage::TcpMessage(const TcpMessage& tcpMessage)
+    : m_data { tcpMessage.m_data }
+    , m_msgID { tcpMessage.m_msgID }
+    , m_byteCount { tcpMessage.m_byteCount }
 {
-    delete dStream;
-    dStream = nullptr;
 }
 
-TcpMessage::TcpMessage(const TcpMessage& tcpMessage)
+TcpMessage& TcpMessage::operator=(const TcpMessage& tcpMessage)
 {
-    m_msgID = tcpMessage.getMsgID();
-    m_data = tcpMessage.getData();
-    dStream = new QDataStream(&m_data, QIODevice::ReadWrite);
-    quint16 temp;
-    *dStream >> temp;
-    *dStream >> temp;
-    m_byteCount = tcpMessage.getByteCount();
+    if (this != &tcpMessage) {
+        dStream.reset();
+        m_data = tcpMessage.m_data;
+        m_msgID = tcpMessage.m_msgID;
+        m_byteCount = tcpMessage.m_byteCount;
+    }
+    return *this;
 }
 
 void TcpMessage::setData(QByteArray& rawData)
 {
+    dStream.reset();
     m_data = rawData;
 }
 
@@ -0,0 +1,55 @@
+#include "tcpmessagedispatcher.h"
+
+#include <QDebug>
+
+#include <algorithm>
+
+void TcpMessageDispatcher::handle(TCP_MSG_KEY key, Handler handler)
+{
+    const auto index { static_cast<std::size_t>(key) };
+    if (index >= max_key) {
+        qWarning() << "TcpMessageDispatcher: message key" << index << "exceeds the dispatch table";
+        return;
+    }
+    m_entries[index].handler = std::move(handler);
+}
+
+bool TcpMessageDispatcher::dispatch(TcpMessage& message)
+{
+    const std::size_t index { message.getMsgID() };
+    if (index >= max_key || !m_entries[index].handler) {
+        m_unknown++;
+        return false;
+    }
+    auto& entry { m_entries[index] };
+    const auto start { std::chrono::steady_clock::now() };
+    entry.handler(message);
+    const auto elapsed { std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start) };
+    entry.count++;
+    entry.total += elapsed;
+    entry.max = std::max(entry.max, elapsed);
+    return true;
+}
+
+auto TcpMessageDispatcher::statistics() const -> std::vector<Statistics>
+{
+    std::vector<Statistics> result {};
+    for (std::size_t index = 0; index < max_key; index++) {
+        const auto& entry { m_entries[index] };
+        if (entry.count == 0) {
+            continue;
+        }
+        result.push_back(Statistics { static_cast<TCP_MSG_KEY>(index), entry.count, entry.total / entry.count, entry.max });
+    }
+    return result;
+}
+
+void TcpMessageDispatcher::resetStatistics()
+{
+    for (auto& entry : m_entries) {
+        entry.count = 0;
+        entry.total = {};
+        entry.max = {};
+    }
+    m_unknown = 0;
+}
@@ -0,0 +1,556 @@
+/* Offline coincidence search in the event data files of several stations
+ *
+ * usage: event_coincidences [options] station_files...
+ * Every argument describes one station, either as a single file or as a comma separated list
+ * of files which are read in the given order, e.g. the daily files of a month. The station is
+ * named after the first file unless the argument is given as name=file1,file2,...
+ *
+ * Each station is parsed in its own thread into a bounded queue, the main thread merges the
+ * streams in time order and searches for coincidences. The memory usage does not depend on the
+ * amount of data, only on the number of stations, the event rate and the reorder span.
+ */
+
+#include "utility/unixtime_from_gps.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t block_size { 16384 }; //!< events per block handed from a reader to the merger
+constexpr std::size_t max_queued_blocks { 4 };
+constexpr std::size_t read_chunk_size { 1 << 20 };
+constexpr std::uint8_t timebase_gnss { 1 };
+constexpr std::uint8_t timebase_utc { 2 };
+
+struct Options {
+    double window_ns { 1000. }; //!< fixed part of the coincidence window
+    double sigma { 3. }; //!< the window is widened by sigma times the combined accuracy of both events
+    std::uint32_t max_accuracy_ns { 10000 }; //!< events with a larger accuracy estimate are ignored
+    std::int64_t reorder_span_ns { 1000000000 }; //!< max time by which the events of one station may be out of order
+    std::int64_t max_gap_ns { 600LL * 1000000000 }; //!< larger gaps between two events of a station are counted as dead time
+    const char* output { nullptr };
+};
+
+struct Event {
+    std::int64_t time_ns { 0 };
+    std::uint32_t accuracy_ns { 0 };
+    std::uint16_t station { 0 };
+};
+
+auto operator>(const Event& lhs, const Event& rhs) -> bool
+{
+    return lhs.time_ns > rhs.time_ns;
+}
+
+/**
+ * @brief single producer single consumer queue of event blocks with a bounded size
+ */
+class BlockQueue {
+public:
+    void push(std::vector<Event>&& block)
+    {
+        std::unique_lock<std::mutex> lock { m_mutex };
+        m_not_full.wait(lock, [this] { return m_blocks.size() < max_queued_blocks; });
+        m_blocks.push_back(std::move(block));
+        m_not_empty.notify_one();
+    }
+
+    void close()
+    {
+        std::lock_guard<std::mutex> lock { m_mutex };
+        m_closed = true;
+        m_not_empty.notify_one();
+    }
+
+    /**
+     * @return false if the queue is closed and empty
+     */
+    [[nodiscard]] auto pop(std::vector<Event>& block) -> bool
+    {
+        std::unique_lock<std::mutex> lock { m_mutex };
+        m_not_empty.wait(lock, [this] { return !m_blocks.empty() || m_closed; });
+        if (m_blocks.empty()) {
+            return false;
+        }
+        block = std::move(m_blocks.front());
+        m_blocks.pop_front();
+        m_not_full.notify_one();
+        return true;
+    }
+
+private:
+    std::mutex m_mutex {};
+    std::condition_variable m_not_full {};
+    std::condition_variable m_not_empty {};
+    std::deque<std::vector<Event>> m_blocks {};
+    bool m_closed { false };
+};
+
+struct StationStatistics {
+    std::size_t events { 0 };
+    std::size_t malformed { 0 };
+    std::size_t invalid { 0 }; //!< invalid time or a time base which can not be compared
+    std::size_t inaccurate { 0 };
+    std::size_t out_of_order { 0 };
+    double accuracy_sum { 0. };
+    std::vector<std::pair<std::int64_t, std::int64_t>> segments {}; //!< intervals of continuous data taking
+};
+
+/**
+ * @brief parses the files of one station in its own thread
+ * The lines are "rising_s.rising_ns falling_s.falling_ns accuracy_ns counter valid timebase utc",
+ * as written by the daemon. Time marks in UTC are moved to the GNSS time scale of the others.
+ */
+class StationReader {
+public:
+    StationReader(std::uint16_t index, std::string name, std::vector<std::string> files, const Options& options)
+        : m_index { index }
+        , m_name { std::move(name) }
+        , m_files { std::move(files) }
+        , m_options { options }
+    {
+    }
+
+    void start()
+    {
+        m_thread = std::thread { &StationReader::run, this };
+    }
+
+    void join()
+    {
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+    }
+
+    [[nodiscard]] auto queue() -> BlockQueue& { return m_queue; }
+    [[nodiscard]] auto name() const -> const std::string& { return m_name; }
+    [[nodiscard]] auto statistics() -> StationStatistics& { return m_statistics; } //!< only valid after join()
+
+private:
+    void run()
+    {
+        std::vector<char> buffer(read_chunk_size);
+        std::string carry {};
+        for (const auto& file_name : m_files) {
+            std::FILE* file { std::fopen(file_name.c_str(), "rb") };
+            if (file == nullptr) {
+                std::fprintf(stderr, "could not open %s: %s\n", file_name.c_str(), std::strerror(errno));
+                continue;
+            }
+            std::size_t n { 0 };
+            while ((n = std::fread(buffer.data(), 1, buffer.size(), file)) > 0) {
+                std::string_view chunk { buffer.data(), n };
+                std::size_t begin { 0 };
+                for (std::size_t end = chunk.find('\n'); end != std::string_view::npos; end = chunk.find('\n', begin)) {
+                    if (!carry.empty()) {
+                        carry.append(chunk.substr(begin, end - begin));
+                        parse(carry);
+                        carry.clear();
+                    } else {
+                        parse(chunk.substr(begin, end - begin));
+                    }
+                    begin = end + 1;
+                }
+                carry.append(chunk.substr(begin));
+            }
+            std::fclose(file);
+            if (!carry.empty()) {
+                parse(carry);
+                carry.clear();
+            }
+        }
+        while (!m_reorder.empty()) {
+            release();
+        }
+        if (!m_block.empty()) {
+            m_queue.push(std::move(m_block));
+        }
+        m_queue.close();
+    }
+
+    void parse(std::string_view line)
+    {
+        if (line.empty() || line.front() == '#') {
+            return;
+        }
+        std::int64_t seconds { 0 };
+        std::int64_t nanoseconds { 0 };
+        std::int64_t falling_seconds { 0 };
+        std::int64_t falling_nanoseconds { 0 };
+        std::uint32_t accuracy { 0 };
+        unsigned counter { 0 };
+        unsigned valid { 0 };
+        unsigned timebase { 0 };
+        const char* p { line.data() };
+        const char* const last { line.data() + line.size() };
+        const auto field = [&](auto& value, char separator) {
+            const auto result { std::from_chars(p, last, value) };
+            if (result.ec != std::errc {} || result.ptr == last || *result.ptr != separator) {
+                return false;
+            }
+            p = result.ptr + 1;
+            return true;
+        };
+        if (!field(seconds, '.') || !field(nanoseconds, ' ') || !field(falling_seconds, '.') || !field(falling_nanoseconds, ' ')
+            || !field(accuracy, ' ') || !field(counter, ' ') || !field(valid, ' ') || !field(timebase, ' ')) {
+            m_statistics.malformed++;
+            return;
+        }
+        if (valid == 0 || (timebase != timebase_gnss && timebase != timebase_utc)) {
+            m_statistics.invalid++;
+            return;
+        }
+        if (accuracy > m_options.max_accuracy_ns) {
+            m_statistics.inaccurate++;
+            return;
+        }
+        if (timebase == timebase_utc) {
+            const std::int64_t gps_seconds { seconds - GpsTime::epoch_unix_seconds + m_leap_seconds.latest() };
+            seconds += m_leap_seconds.offset(gps_seconds);
+        }
+        add(Event { seconds * GpsTime::ns_per_second + nanoseconds, accuracy, m_index });
+    }
+
+    void add(const Event& event)
+    {
+        if (m_released && event.time_ns < m_last_released_ns) {
+            m_statistics.out_of_order++;
+            return;
+        }
+        m_reorder.push(event);
+        while (!m_reorder.empty() && m_reorder.top().time_ns < event.time_ns - m_options.reorder_span_ns) {
+            release();
+        }
+    }
+
+    void release()
+    {
+        const Event event { m_reorder.top() };
+        m_reorder.pop();
+        m_released = true;
+        m_last_released_ns = event.time_ns;
+        m_block.push_back(event);
+        if (m_block.size() >= block_size) {
+            m_queue.push(std::move(m_block));
+            m_block = {};
+            m_block.reserve(block_size);
+        }
+    }
+
+    std::uint16_t m_index;
+    std::string m_name;
+    std::vector<std::string> m_files;
+    const Options& m_options;
+    BlockQueue m_queue {};
+    std::thread m_thread {};
+    std::priority_queue<Event, std::vector<Event>, std::greater<>> m_reorder {};
+    std::vector<Event> m_block {};
+    bool m_released { false };
+    std::int64_t m_last_released_ns { 0 };
+    GpsTime::LeapSecondTable m_leap_seconds {};
+    StationStatistics m_statistics {};
+};
+
+/**
+ * @brief coincidence search on the time ordered stream of events of all stations
+ */
+class CoincidenceMatcher {
+public:
+    CoincidenceMatcher(std::size_t stations, const Options& options, std::FILE* output)
+        : m_options { options }
+        , m_output { output }
+        , m_pairs(stations * stations, 0)
+        , m_stations { stations }
+        , m_max_window_ns { options.window_ns + options.sigma * std::sqrt(2.) * options.max_accuracy_ns }
+    {
+    }
+
+    void process(const Event& event)
+    {
+        while (!m_recent.empty() && static_cast<double>(event.time_ns - m_recent.front().time_ns) > m_max_window_ns) {
+            m_recent.pop_front();
+        }
+        for (const auto& other : m_recent) {
+            if (other.station != event.station && coincident(other, event)) {
+                m_pairs[std::min(other.station, event.station) * m_stations + std::max(other.station, event.station)]++;
+            }
+        }
+        m_recent.push_back(event);
+
+        const bool joins { !m_cluster.empty() && coincident(m_cluster.front(), event)
+            && std::none_of(m_cluster.begin(), m_cluster.end(), [&event](const Event& member) { return member.station == event.station; }) };
+        if (!joins) {
+            flush();
+        }
+        m_cluster.push_back(event);
+    }
+
+    void flush()
+    {
+        if (m_cluster.size() > 1) {
+            write_cluster();
+        }
+        m_cluster.clear();
+    }
+
+    [[nodiscard]] auto pair_count(std::size_t a, std::size_t b) const -> std::size_t { return m_pairs[std::min(a, b) * m_stations + std::max(a, b)]; }
+    [[nodiscard]] auto clusters() const -> const std::map<std::size_t, std::size_t>& { return m_multiplicity; }
+
+private:
+    [[nodiscard]] auto coincident(const Event& a, const Event& b) const -> bool
+    {
+        const double window { m_options.window_ns + m_options.sigma * std::hypot(static_cast<double>(a.accuracy_ns), static_cast<double>(b.accuracy_ns)) };
+        return static_cast<double>(std::abs(b.time_ns - a.time_ns)) <= window;
+    }
+
+    void write_cluster()
+    {
+        m_multiplicity[m_cluster.size()]++;
+        if (m_output == nullptr) {
+            return;
+        }
+        const Event& first { m_cluster.front() };
+        const timespec ts { GpsTime::to_timespec(first.time_ns) };
+        std::fprintf(m_output, "%lld.%09ld %zu", static_cast<long long>(ts.tv_sec), ts.tv_nsec, m_cluster.size());
+        for (const auto& member : m_cluster) {
+            std::fprintf(m_output, " %u:%lld:%u", member.station, static_cast<long long>(member.time_ns - first.time_ns), member.accuracy_ns);
+        }
+        std::fputc('\n', m_output);
+    }
+
+    const Options& m_options;
+    std::FILE* m_output;
+    std::vector<std::size_t> m_pairs;
+    std::size_t m_stations;
+    double m_max_window_ns;
+    std::deque<Event> m_recent {};
+    std::vector<Event> m_cluster {};
+    std::map<std::size_t, std::size_t> m_multiplicity {};
+};
+
+auto live_time(const StationStatistics& statistics) -> double
+{
+    double sum { 0. };
+    for (const auto& [begin, end] : statistics.segments) {
+        sum += 1e-9 * static_cast<double>(end - begin);
+    }
+    return sum;
+}
+
+auto overlap(const StationStatistics& a, const StationStatistics& b) -> double
+{
+    double sum { 0. };
+    auto i { a.segments.begin() };
+    auto j { b.segments.begin() };
+    while (i != a.segments.end() && j != b.segments.end()) {
+        const std::int64_t begin { std::max(i->first, j->first) };
+        const std::int64_t end { std::min(i->second, j->second) };
+        if (end > begin) {
+            sum += 1e-9 * static_cast<double>(end - begin);
+        }
+        if (i->second < j->second) {
+            ++i;
+        } else {
+            ++j;
+        }
+    }
+    return sum;
+}
+
+void usage(const char* program)
+{
+    std::fprintf(stderr, "usage: %s [options] [name=]file[,file...] [name=]file[,file...] ...\n", program);
+    std::fprintf(stderr, "  -w ns   fixed coincidence window (default 1000)\n");
+    std::fprintf(stderr, "  -s n    widen the window by n times the combined accuracy of both events (default 3)\n");
+    std::fprintf(stderr, "  -a ns   ignore events with a larger accuracy estimate (default 10000)\n");
+    std::fprintf(stderr, "  -r ms   max reordering of the events within one station (default 1000)\n");
+    std::fprintf(stderr, "  -g s    gaps longer than this are counted as dead time (default 600)\n");
+    std::fprintf(stderr, "  -o file write the coincidences to file instead of stdout, '-' to omit them\n");
+    std::fprintf(stderr, "A coincidence is written as \"time multiplicity station:dt_ns:accuracy_ns ...\",\n");
+    std::fprintf(stderr, "the per station and per pair statistics are written to stderr.\n");
+}
+
+auto split(const std::string& list, char separator) -> std::vector<std::string>
+{
+    std::vector<std::string> items {};
+    std::size_t begin { 0 };
+    for (std::size_t end = list.find(separator); end != std::string::npos; end = list.find(separator, begin)) {
+        items.push_back(list.substr(begin, end - begin));
+        begin = end + 1;
+    }
+    items.push_back(list.substr(begin));
+    return items;
+}
+
+auto station_name(const std::string& file) -> std::string
+{
+    std::string name { file.substr(file.find_last_of('/') + 1) };
+    return name.substr(0, name.find('.'));
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    Options options {};
+    int opt { 0 };
+    while ((opt = getopt(argc, argv, "w:s:a:r:g:o:h")) != -1) {
+        switch (opt) {
+        case 'w':
+            options.window_ns = std::strtod(optarg, nullptr);
+            break;
+        case 's':
+            options.sigma = std::strtod(optarg, nullptr);
+            break;
+        case 'a':
+            options.max_accuracy_ns = static_cast<std::uint32_t>(std::strtoul(optarg, nullptr, 10));
+            break;
+        case 'r':
+            options.reorder_span_ns = std::strtoll(optarg, nullptr, 10) * 1000000;
+            break;
+        case 'g':
+            options.max_gap_ns = std::strtoll(optarg, nullptr, 10) * GpsTime::ns_per_second;
+            break;
+        case 'o':
+            options.output = optarg;
+            break;
+        default:
+            usage(argv[0]);
+            return (opt == 'h') ? 0 : 1;
+        }
+    }
+    const int nr_stations { argc - optind };
+    if (nr_stations < 2 || nr_stations > 0xffff) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    std::FILE* output { stdout };
+    if (options.output != nullptr) {
+        output = (std::strcmp(options.output, "-") == 0) ? nullptr : std::fopen(options.output, "w");
+        if (output == nullptr && std::strcmp(options.output, "-") != 0) {
+            std::fprintf(stderr, "could not open %s: %s\n", options.output, std::strerror(errno));
+            return 1;
+        }
+    }
+
+    std::vector<std::unique_ptr<StationReader>> readers {};
+    for (int i = 0; i < nr_stations; i++) {
+        std::string argument { argv[optind + i] };
+        std::string name {};
+        const auto equals { argument.find('=') };
+        if (equals != std::string::npos) {
+            name = argument.substr(0, equals);
+            argument = argument.substr(equals + 1);
+        }
+        auto files { split(argument, ',') };
+        if (name.empty()) {
+            name = station_name(files.front());
+        }
+        readers.push_back(std::make_unique<StationReader>(static_cast<std::uint16_t>(i), name, std::move(files), options));
+    }
+    for (auto& reader : readers) {
+        reader->start();
+    }
+
+    // k-way merge over the heads of the station streams
+    CoincidenceMatcher matcher { readers.size(), options, output };
+    std::vector<std::vector<Event>> blocks(readers.size());
+    std::vector<std::size_t> positions(readers.size(), 0);
+    std::vector<StationStatistics> merged(readers.size());
+    std::priority_queue<Event, std::vector<Event>, std::greater<>> heads {};
+    const auto advance = [&](std::size_t station) {
+        if (positions[station] >= blocks[station].size()) {
+            positions[station] = 0;
+            if (!readers[station]->queue().pop(blocks[station])) {
+                blocks[station].clear();
+                return;
+            }
+        }
+        heads.push(blocks[station][positions[station]++]);
+    };
+    for (std::size_t station = 0; station < readers.size(); station++) {
+        advance(station);
+    }
+    while (!heads.empty()) {
+        const Event event { heads.top() };
+        heads.pop();
+        auto& statistics { merged[event.station] };
+        if (statistics.segments.empty() || event.time_ns - statistics.segments.back().second > options.max_gap_ns) {
+            statistics.segments.emplace_back(event.time_ns, event.time_ns);
+        }
+        statistics.segments.back().second = event.time_ns;
+        statistics.events++;
+        statistics.accuracy_sum += event.accuracy_ns;
+        matcher.process(event);
+        advance(event.station);
+    }
+    matcher.flush();
+    if (output != nullptr && output != stdout) {
+        std::fclose(output);
+    }
+
+    for (std::size_t station = 0; station < readers.size(); station++) {
+        readers[station]->join();
+        auto& statistics { readers[station]->statistics() };
+        statistics.events = merged[station].events;
+        statistics.accuracy_sum = merged[station].accuracy_sum;
+        statistics.segments = std::move(merged[station].segments);
+    }
+
+    std::fprintf(stderr, "# station events live_h rate_hz mean_accuracy_ns malformed invalid inaccurate out_of_order\n");
+    for (std::size_t station = 0; station < readers.size(); station++) {
+        const auto& statistics { readers[station]->statistics() };
+        const double live { live_time(statistics) };
+        std::fprintf(stderr, "%s %zu %.3f %.4f %.1f %zu %zu %zu %zu\n", readers[station]->name().c_str(), statistics.events,
+            live / 3600., (live > 0.) ? statistics.events / live : 0.,
+            (statistics.events > 0) ? statistics.accuracy_sum / statistics.events : 0.,
+            statistics.malformed, statistics.invalid, statistics.inaccurate, statistics.out_of_order);
+    }
+
+    // the accidental rate is estimated from the mean rates and the mean window of each pair
+    std::fprintf(stderr, "# station_a station_b coincidences overlap_h rate_per_h accidentals_per_h\n");
+    for (std::size_t a = 0; a < readers.size(); a++) {
+        for (std::size_t b = a + 1; b < readers.size(); b++) {
+            const auto& sa { readers[a]->statistics() };
+            const auto& sb { readers[b]->statistics() };
+            const double common { overlap(sa, sb) };
+            const double live_a { live_time(sa) };
+            const double live_b { live_time(sb) };
+            double accidentals { 0. };
+            if (live_a > 0. && live_b > 0. && sa.events > 0 && sb.events > 0) {
+                const double window { 1e-9 * (options.window_ns + options.sigma * std::hypot(sa.accuracy_sum / sa.events, sb.accuracy_sum / sb.events)) };
+                accidentals = 3600. * 2. * window * (sa.events / live_a) * (sb.events / live_b);
+            }
+            const std::size_t count { matcher.pair_count(a, b) };
+            std::fprintf(stderr, "%s %s %zu %.3f %.4f %.6f\n", readers[a]->name().c_str(), readers[b]->name().c_str(), count,
+                common / 3600., (common > 0.) ? 3600. * count / common : 0., accidentals);
+        }
+    }
+    std::fprintf(stderr, "# multiplicity clusters\n");
+    for (const auto& [multiplicity, count] : matcher.clusters()) {
+        std::fprintf(stderr, "%zu %zu\n", multiplicity, count);
+    }
+    return 0;
+}